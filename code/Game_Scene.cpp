@@ -15,6 +15,7 @@
 #include "Menu_Scene.hpp"
 
 #include <cstdlib>
+#include <basics/Asset_Manifest>
 #include <basics/Canvas>
 #include <basics/Director>
 
@@ -25,30 +26,12 @@ using namespace std;
 namespace example
 {
     // ---------------------------------------------------------------------------------------------
-    // ID y ruta de las texturas que se deben cargar para esta escena. La textura con el mensaje de
-    // carga está la primera para poder dibujarla cuanto antes:
+    // Las texturas que se deben cargar para esta escena se listan en su manifiesto (con su id y el
+    // tamaño con el que se dibujan), que también usa el Prefetcher para leerlas por adelantado. Los
+    // sprites se dibujan muy reducidos, por lo que las texturas con tamaño de visualización se
+    // cargan con mipmaps para evitar el parpadeo al reducirlas:
 
-    Game_Scene::Texture_Data Game_Scene::textures_data[] =
-    {
-        { ID(loading),    "game-scene/loading.png"        },
-        { ID(ball),       "game-scene/ball.png"           },
-        { ID(up),       "button/arriba.png"               },
-        { ID(down),       "button/abajo.png"              },
-        { ID(left),       "button/izquierda.png"          },
-        { ID(right),       "button/derecha.png"           },
-        { ID(pacman),       "Character/pacman.png"        },
-        { ID(phantom),       "Character/phantom1.png"     },
-        { ID(phantomeat),       "Character/phantomeat.png"      },
-        { ID(wall),                   "Character/wall.png"},
-        { ID(coin),                 "Character/pelota.png"},
-        { ID(special_coin),   "Character/special_coin.png"},
-
-    };
-
-    // Pâra determinar el número de items en el array textures_data, se divide el tamaño en bytes
-    // del array completo entre el tamaño en bytes de un item:
-
-    unsigned Game_Scene::textures_count = sizeof(textures_data) / sizeof(Texture_Data);
+    const char * const Game_Scene::manifest_path = "manifests/game.manifest";
 
     // ---------------------------------------------------------------------------------------------
     // Definiciones de los atributos estáticos de la clase:
@@ -87,6 +70,11 @@ namespace example
         suspended = true;
         gameplay  = UNINITIALIZED;
 
+        loading_requested = false;
+
+        loading_scheduler.clear      ();
+        loading_scheduler.set_budget (4.f);             // Milisegundos de cada fotograma
+
         return true;
     }
 
@@ -215,42 +203,87 @@ namespace example
     }
 
     // ---------------------------------------------------------------------------------------------
-    // En este método solo se carga una textura por fotograma para poder pausar la carga si el
-    // juego pasa a segundo plano inesperadamente. Otro aspecto interesante es que la carga no
-    // comienza hasta que la escena se inicia para así tener la posibilidad de mostrar al usuario
-    // que la carga está en curso en lugar de tener una pantalla en negro que no responde durante
-    // un tiempo.
+    // Las texturas se decodifican en los hilos del texture_loader y en cada fotograma solo se suben
+    // a la GPU las que caben en unos milisegundos para poder pausar la carga si el juego pasa a
+    // segundo plano inesperadamente. Otro aspecto interesante es que la carga no comienza hasta que
+    // la escena se inicia para así tener la posibilidad de mostrar al usuario que la carga está en
+    // curso en lugar de tener una pantalla en negro que no responde durante un tiempo.
 
     void Game_Scene::load_textures ()
     {
-        if (textures.size () < textures_count)          // Si quedan texturas por cargar...
+        if (!loading_requested)
         {
-            // Las texturas se cargan y se suben al contexto gráfico, por lo que es necesario disponer
-            // de uno:
+            loading_requested = true;
 
-            Graphics_Context::Accessor context = director.lock_graphics_context ();
+            Asset_Manifest manifest(manifest_path);
+
+            if (!manifest.good ())
+            {
+                state = ERROR;
+                return;
+            }
 
-            if (context)
+            for (auto & entry : manifest.get_entries ())
             {
-                // Se carga la siguiente textura (textures.size() indica cuántas llevamos cargadas):
+                if (entry.kind != Asset_Manifest::TEXTURE) continue;
 
-                Texture_Data   & texture_data = textures_data[textures.size ()];
-                Texture_Handle & texture      = textures[texture_data.id] = Texture_2D::create (texture_data.id, context, texture_data.path);
+                Texture_2D::Options options
+                {
+                    0, 0,
+                    entry.display_size,
+                    entry.display_size,
+                    entry.display_size > 0,
+                    Texture_2D::PREFER_16_BIT,          // Los gráficos opacos (como el laberinto) usan 16 bits
+                    Texture_2D::RELEASE_PIXELS          // Si se pierde el contexto se vuelven a cargar del asset
+                };
+
+                Texture_Loader::Handle task = texture_loader.load
+                (
+                    entry.id,
+                    entry.path,
+                    options,
+                    [this] (const Texture_Loader::Task & task)
+                    {
+                        // Se comprueba si la textura se ha podido cargar correctamente:
+
+                        if (task.is_ready ()) textures[task.get_id ()] = task.get_texture (); else state = ERROR;
+                    }
+                );
+
+                // Subir una textura cuesta en proporción a sus píxeles. Las que no se reducen son
+                // pequeñas, por lo que se estiman como las más pequeñas de las reducidas:
 
-                // Se comprueba si la textura se ha podido cargar correctamente:
+                unsigned display_size = entry.display_size > 0 ? entry.display_size : 64;
 
-                if (texture) context->add (texture); else state = ERROR;
+                loading_scheduler.add
+                (
+                    entry.id,
+                    float(display_size * display_size),
+                    [this, task] ()
+                    {
+                        // Las texturas se suben al contexto gráfico, por lo que es necesario disponer
+                        // de uno. Si la textura aún se está decodificando, se intenta más adelante:
 
-                // Cuando se han terminado de cargar todas las texturas se pueden crear los sprites que
-                // las usarán e iniciar el juego:
+                        Graphics_Context::Accessor context = director.lock_graphics_context ();
+
+                        return context && texture_loader.upload (context, task);
+                    }
+                );
             }
         }
+
+        if (!loading_scheduler.is_done ())              // Si quedan texturas por cargar...
+        {
+            loading_scheduler.run ();
+        }
         else
-        if (timer.get_elapsed_seconds () > 1.f)         // Si las texturas se han cargado muy rápido
-        {                                               // se espera un segundo desde el inicio de
-            create_sprites ();                          // la carga antes de pasar al juego para que
-            restart_game   ();                          // el mensaje de carga no aparezca y desaparezca
-                                                        // demasiado rápido.
+        {
+            // Cuando se han terminado de cargar todas las texturas se pueden crear los sprites que
+            // las usarán e iniciar el juego:
+
+            create_sprites ();
+            restart_game   ();
+
             state = RUNNING;
         }
     }
@@ -573,6 +606,15 @@ namespace example
                 { loading_texture->get_width (), loading_texture->get_height () },
                   loading_texture
             );
+
+            // Debajo del mensaje se dibuja una barra con la fracción de la carga completada:
+
+            Point2f bar_position{ canvas_width * .3f, canvas_height * .5f - loading_texture->get_height () * .5f - 40.f };
+            Size2f  bar_size    { canvas_width * .4f, 12.f };
+
+            canvas.set_color      (1.f, 1.f, 1.f);
+            canvas.draw_rectangle (bar_position, bar_size);
+            canvas.fill_rectangle (bar_position, { bar_size.width * loading_scheduler.get_progress (), bar_size.height });
         }
     }
 
@@ -17,8 +17,10 @@
 
     #include <basics/Canvas>
     #include <basics/Id>
+    #include <basics/Loading_Scheduler>
     #include <basics/Scene>
     #include <basics/Texture_2D>
+    #include <basics/Texture_Loader>
     #include <basics/Timer>
 
     #include "Sprite.hpp"
@@ -29,7 +31,9 @@
         using basics::Id;
         using basics::Timer;
         using basics::Canvas;
+        using basics::Loading_Scheduler;
         using basics::Texture_2D;
+        using basics::Texture_Loader;
 
         class Game_Scene : public basics::Scene
         {
@@ -87,14 +91,10 @@
 
 
             /**
-             * Array de estructuras con la información de las texturas (Id y ruta) que hay que cargar.
+             * Ruta del manifiesto con las texturas que hay que cargar (ruta, id y tamaño máximo en
+             * píxeles con el que se dibujan).
              */
-            static struct   Texture_Data { Id id; const char * path; } textures_data[];
-
-            /**
-             * Número de items que hay en el array textures_data.
-             */
-            static unsigned textures_count;
+            static const char * const manifest_path;
 
         private:
 
@@ -111,6 +111,9 @@
             unsigned       canvas_height;                       ///< Alto  de la resolución virtual usada para dibujar.
 
             Texture_Map    textures;                            ///< Mapa  en el que se guardan shared_ptr a las texturas cargadas.
+            Texture_Loader texture_loader;                      ///< Decodifica las texturas en otros hilos y las sube poco a poco.
+            Loading_Scheduler loading_scheduler;                ///< Reparte la subida de las texturas entre fotogramas según lo que tarda.
+            bool           loading_requested;                   ///< true cuando ya se han encargado todas las texturas al texture_loader.
             Sprite_List    sprites;                             ///< Lista en la que se guardan shared_ptr a los sprites creados.
 
 
@@ -222,8 +225,10 @@
         private:
 
             /**
-             * En este método se cargan las texturas (una cada fotograma para facilitar que la
-             * propia carga se pueda pausar cuando la aplicación pasa a segundo plano).
+             * En este método se cargan las texturas. Se decodifican en paralelo y en cada fotograma
+             * el loading_scheduler sube las que quepan en unos pocos milisegundos, por lo que la carga
+             * se puede pausar cuando la aplicación pasa a segundo plano. El juego empieza en cuanto se
+             * han subido todas.
              */
             void load_textures ();
 
@@ -250,8 +255,9 @@
             void run_simulation (float time);
 
             /**
-             * Dibuja la textura con el mensaje de carga mientras el estado de la escena es LOADING.
-             * La textura con el mensaje se carga la primera para mostrar el mensaje cuanto antes.
+             * Dibuja la textura con el mensaje de carga y una barra con el progreso de la carga mientras
+             * el estado de la escena es LOADING. La textura con el mensaje se carga la primera para
+             * mostrar el mensaje cuanto antes.
              * @param canvas Referencia al Canvas con el que dibujar la textura.
              */
             void render_loading (Canvas & canvas);
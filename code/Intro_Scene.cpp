@@ -10,8 +10,10 @@
 
 #include "Intro_Scene.hpp"
 #include "Menu_Scene.hpp"
+#include <basics/Asset_Manifest>
 #include <basics/Canvas>
 #include <basics/Director>
+#include <basics/Texture_Registry>
 
 using namespace basics;
 using namespace std;
@@ -95,15 +97,22 @@ namespace example
 
         if (context)
         {
-            // Se carga la textura del logo:
+            // Se carga la textura del logo que indica el manifiesto de la escena:
 
-            logo_texture = Texture_2D::create (0, context, "logo.png");
+            Asset_Manifest                manifest("manifests/intro.manifest");
+            const Asset_Manifest::Entry * entry = manifest.find (ID(logo));
+
+            if (entry) logo_texture = Texture_Registry::acquire (0, context, entry->path);
 
             // Se comprueba si la textura se ha podido cargar correctamente:
 
             if (logo_texture)
             {
-                context->add (logo_texture);
+                // Mientras se muestra el logo se leen por adelantado los assets del menú y del juego
+                // (los que comparten solo se piden una vez):
+
+                director.get_prefetcher ().prefetch ("manifests/menu.manifest");
+                director.get_prefetcher ().prefetch ("manifests/game.manifest");
 
                 timer.reset ();
 
@@ -10,6 +10,7 @@
 
 #include "Menu_Scene.hpp"
 #include "Game_Scene.hpp"
+#include <basics/Asset_Manifest>
 #include <basics/Canvas>
 #include <basics/Director>
 #include <basics/Transformation>
@@ -98,19 +99,27 @@ namespace example
 
             if (context)
             {
-                // Se carga el atlas:
+                // Se carga el atlas que indica el manifiesto de la escena:
 
-                atlas.reset (new Atlas("menu-scene/main-menu.sprites", context));
+                Asset_Manifest                manifest("manifests/menu.manifest");
+                const Asset_Manifest::Entry * entry = manifest.find (ID(main_menu));
+
+                if (entry) atlas.reset (new Atlas(entry->path, context));
 
                 // Si el atlas se ha podido cargar el estado es READY y, en otro caso, es ERROR:
 
-                state = atlas->good () ? READY : ERROR;
+                state = atlas && atlas->good () ? READY : ERROR;
 
                 // Si el atlas está disponible, se inicializan los datos de las opciones del menú:
 
                 if (state == READY)
                 {
                     configure_options ();
+
+                    // Si se ha llegado al menú sin pasar por la intro, se piden ahora los assets del
+                    // juego. Si ya se habían pedido, el Prefetcher no hace nada:
+
+                    director.get_prefetcher ().prefetch ("manifests/game.manifest");
                 }
             }
         }
@@ -8,10 +8,12 @@
  * angel.rodriguez@esne.edu
  */
 
+#include <basics/Asset_Archive>
 #include <basics/Director>
 #include <basics/enable>
 #include <basics/Graphics_Resource_Cache>
 #include <basics/opengles/Context>
+#include <basics/Texture_Cache>
 #include <basics/Window>
 #include "Intro_Scene.hpp"
 #include <basics/opengles/Canvas_ES2>
@@ -30,6 +32,16 @@ int main ()
 
     enable< basics::OpenGL_ES2 > ();
 
+    // Si los assets se han empaquetado con basics-packer se leen del archivo (una sola apertura).
+    // Si no, se siguen leyendo los archivos sueltos:
+
+    Asset_Archive::mount ("assets.pak");
+
+    // Los píxeles de las texturas decodificadas se guardan en el almacenamiento privado de la app
+    // para que los siguientes arranques no tengan que volver a decodificar los PNG:
+
+    Texture_Cache::enable ();
+
     // Se crea una Game_Scene y se inicia mediante el Director:
 
     director.run_scene (shared_ptr< Scene >(new Intro_Scene));
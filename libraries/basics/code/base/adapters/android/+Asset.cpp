@@ -16,6 +16,7 @@
 
     #include <android/asset_manager.h>
     #include <basics/Asset>
+    #include <basics/Asset_Archive>
     #include "Android_Asset.hpp"
     #include "Native_Activity.hpp"
 
@@ -24,6 +25,13 @@
 
         std::shared_ptr< Asset > Asset::open (const std::string & path)
         {
+            // Los assets de los archivos montados tienen prioridad sobre los sueltos:
+
+            if (std::shared_ptr< Asset > packed_asset = Asset_Archive::open_mounted (path))
+            {
+                return packed_asset;
+            }
+
             std::shared_ptr< Asset > asset(new internal::Android_Asset(path));
 
             if (!asset->good ())
@@ -36,14 +44,33 @@
 
         bool Asset::exists (const std::string & path)
         {
+            size_t packed_size;
+
+            if (Asset_Archive::find_mounted (path, packed_size))
+            {
+                return true;
+            }
+
             return internal::Android_Asset(path).good ();
         }
 
         size_t Asset::size (const std::string & path)
         {
+            size_t packed_size;
+
+            if (Asset_Archive::find_mounted (path, packed_size))
+            {
+                return packed_size;
+            }
+
             return internal::Android_Asset(path).size ();
         }
 
+        void Asset::set_root (const std::string & )
+        {
+            // Los assets de Android siempre se leen del APK.
+        }
+
     }
 
 #endif
@@ -0,0 +1,37 @@
+/*
+ * ASSET READER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803261000
+ */
+
+#include <basics/macros>
+
+#if defined(BASICS_ANDROID_OS)
+
+    #include <basics/Asset_Reader>
+
+    namespace basics { namespace internal
+    {
+
+        // Las aplicaciones no pueden usar io_uring en Android (el filtro seccomp de las apps lo
+        // bloquea) y los assets están dentro del APK, por lo que las lecturas se hacen siempre con el
+        // Thread_Pool de Asset_Reader y las sugerencias de lectura anticipada no hacen nada:
+
+        std::unique_ptr< Asset_Reader::Backend > create_native_reader_backend (Asset_Reader & )
+        {
+            return nullptr;
+        }
+
+        void prefetch_asset_file (const std::string & )
+        {
+        }
+
+    }}
+
+#endif
@@ -31,6 +31,8 @@
                 return state;
             }
 
+            std::string get_storage_path () const override;
+
             void set_state (State new_state)
             {
                 state = new_state;
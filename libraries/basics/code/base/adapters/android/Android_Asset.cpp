@@ -130,6 +130,31 @@
             return false;
         }
 
+        size_t Android_Asset::read_at (size_t offset, byte * buffer, size_t size)
+        {
+            // AAsset no permite leer de una posición sin mover su cursor, por lo que se restaura
+            // después de leer:
+
+            if (good () && AAsset_seek (handle, off_t(offset), SEEK_SET) >= 0)
+            {
+                int result = AAsset_read (handle, buffer, size);
+
+                AAsset_seek (handle, off_t(cursor), SEEK_SET);
+
+                return result > 0 ? size_t(result) : 0;
+            }
+
+            return 0;
+        }
+
+        const byte * Android_Asset::get_buffer ()
+        {
+            // Los assets que se guardan sin comprimir en el APK se proyectan en memoria directamente.
+            // Con los comprimidos, el AAsset los descomprime una sola vez en un buffer propio:
+
+            return good () ? static_cast< const byte * >(AAsset_getBuffer (handle)) : nullptr;
+        }
+
         bool Android_Asset::read (uint8_t * buffer, size_t size)
         {
             if (size > 0)
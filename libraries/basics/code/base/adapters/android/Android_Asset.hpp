@@ -45,6 +45,9 @@
             byte   read () override;
             bool   read_all (std::vector< byte > & buffer) override;
             bool   read_all (std::string & buffer) override;
+            size_t read_at  (size_t offset, byte * buffer, size_t size) override;
+
+            const byte * get_buffer () override;
 
         private:
 
@@ -0,0 +1,68 @@
+/*
+ * APPLICATION
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803241015
+ */
+
+#include <basics/macros>
+
+#if defined(BASICS_LINUX_OS)
+
+    #include <cstdlib>
+    #include <sys/stat.h>
+    #include "Linux_Application.hpp"
+
+    namespace basics
+    {
+
+        namespace internal
+        {
+
+            Linux_Application application;
+
+            std::string Linux_Application::get_storage_path () const
+            {
+                // Se usa el directorio de datos del usuario que indica la especificación XDG:
+
+                const char * data_home = std::getenv ("XDG_DATA_HOME");
+                const char * home      = std::getenv ("HOME");
+
+                std::string path = data_home && *data_home ? std::string(data_home) : home && *home ? std::string(home) + "/.local/share" : std::string();
+
+                if (path.empty ())
+                {
+                    return path;
+                }
+
+                path += "/basics";
+
+                // Se crean los directorios que falten, como ocurre con los de Android, que siempre existen:
+
+                for (size_t slash = path.find ('/', 1); ; slash = path.find ('/', slash + 1))
+                {
+                    mkdir (path.substr (0, slash).c_str (), 0700);
+
+                    if (slash == std::string::npos) break;
+                }
+
+                return path;
+            }
+
+        }
+
+        Application & Application::get_instance ()
+        {
+            return internal::application;
+        }
+
+        Application & application = Application::get_instance ();
+
+    }
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * ASSET
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803241005
+ */
+
+#include <basics/macros>
+
+#if defined(BASICS_LINUX_OS)
+
+    #include <sys/stat.h>
+    #include <basics/Asset>
+    #include <basics/Asset_Archive>
+    #include "Linux_Asset.hpp"
+
+    namespace basics
+    {
+
+        std::shared_ptr< Asset > Asset::open (const std::string & path)
+        {
+            // Los assets de los archivos montados tienen prioridad sobre los sueltos:
+
+            if (std::shared_ptr< Asset > packed_asset = Asset_Archive::open_mounted (path))
+            {
+                return packed_asset;
+            }
+
+            std::shared_ptr< Asset > asset(new internal::Linux_Asset(path));
+
+            if (!asset->good ())
+            {
+                 asset.reset ();
+            }
+
+            return asset;
+        }
+
+        bool Asset::exists (const std::string & path)
+        {
+            size_t packed_size;
+
+            if (Asset_Archive::find_mounted (path, packed_size))
+            {
+                return true;
+            }
+
+            struct stat status;
+
+            return stat (internal::Linux_Asset::resolve (path).c_str (), &status) == 0 && S_ISREG(status.st_mode);
+        }
+
+        size_t Asset::size (const std::string & path)
+        {
+            size_t packed_size;
+
+            if (Asset_Archive::find_mounted (path, packed_size))
+            {
+                return packed_size;
+            }
+
+            struct stat status;
+
+            return stat (internal::Linux_Asset::resolve (path).c_str (), &status) == 0 && S_ISREG(status.st_mode) ? size_t(status.st_size) : 0;
+        }
+
+        void Asset::set_root (const std::string & path)
+        {
+            internal::Linux_Asset::root () = path;
+        }
+
+    }
+
+#endif
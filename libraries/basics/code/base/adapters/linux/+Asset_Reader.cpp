@@ -0,0 +1,50 @@
+/*
+ * ASSET READER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803261000
+ */
+
+#include <basics/macros>
+
+#if defined(BASICS_LINUX_OS)
+
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <basics/Asset_Archive>
+    #include "Linux_Asset.hpp"
+    #include "Linux_Uring_Reader.hpp"
+
+    namespace basics { namespace internal
+    {
+
+        std::unique_ptr< Asset_Reader::Backend > create_native_reader_backend (Asset_Reader & reader)
+        {
+            return Linux_Uring_Reader::create (reader);
+        }
+
+        void prefetch_asset_file (const std::string & path)
+        {
+            size_t packed_size;
+
+            if (!Asset_Archive::find_mounted (path, packed_size))
+            {
+                int file = ::open (Linux_Asset::resolve (path).c_str (), O_RDONLY | O_CLOEXEC);
+
+                if (file >= 0)
+                {
+                    posix_fadvise (file, 0, 0, POSIX_FADV_WILLNEED);
+
+                    close (file);
+                }
+            }
+        }
+
+    }}
+
+#endif
@@ -0,0 +1,42 @@
+/*
+ * LOG
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803241010
+ */
+
+#include <basics/Log>
+#include <basics/macros>
+
+#if defined(BASICS_LINUX_OS)
+
+    #include <cstdio>
+
+    namespace basics
+    {
+
+        static const char * level_names[] =
+        {
+            "V",
+            "D",
+            "I",
+            "W",
+            "E",
+            "F",
+        };
+
+        void Log::dump (Level level, const char * tag, const char * cstring)
+        {
+            std::fprintf (stderr, "%s/%s: %s\n", level_names[level], tag ? tag : "*", cstring);
+        }
+
+        Log log;
+
+    }
+
+#endif
@@ -0,0 +1,55 @@
+/*
+ * LINUX APPLICATION
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803241015
+ */
+
+#ifndef BASICS_LINUX_APPLICATION_HEADER
+#define BASICS_LINUX_APPLICATION_HEADER
+
+    #include <atomic>
+    #include <basics/Application>
+
+    namespace basics { namespace internal
+    {
+
+        /**
+         * Aplicación de las herramientas y pruebas de escritorio, que no tienen ciclo de vida: está
+         * activa desde que se crea.
+         */
+        class Linux_Application : public Application
+        {
+
+            std::atomic< Application::State > state;
+
+        public:
+
+            Linux_Application() : state(ACTIVE)
+            {
+            }
+
+            State get_state () const override
+            {
+                return state;
+            }
+
+            std::string get_storage_path () const override;
+
+            void set_state (State new_state)
+            {
+                state = new_state;
+            }
+
+        };
+
+        extern Linux_Application application;
+
+    }}
+
+#endif
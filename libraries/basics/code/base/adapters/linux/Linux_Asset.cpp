@@ -0,0 +1,262 @@
+/*
+ * LINUX ASSET
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803241000
+ */
+
+#include <basics/macros>
+
+#if defined(BASICS_LINUX_OS)
+
+    #include <cerrno>
+    #include <cstdlib>
+    #include <cstring>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #include "Linux_Asset.hpp"
+
+    namespace basics { namespace internal
+    {
+
+        std::string & Linux_Asset::root ()
+        {
+            static std::string root = std::getenv ("BASICS_ASSET_ROOT") ? std::getenv ("BASICS_ASSET_ROOT") : "assets";
+
+            return root;
+        }
+
+        std::string Linux_Asset::resolve (const std::string & path)
+        {
+            const std::string & root = Linux_Asset::root ();
+
+            if (root.empty () || (!path.empty () && path[0] == '/'))
+            {
+                return path;
+            }
+
+            return root.back () == '/' ? root + path : root + '/' + path;
+        }
+
+        Linux_Asset::Linux_Asset(const std::string & path)
+        {
+            file          = ::open (resolve (path).c_str (), O_RDONLY | O_CLOEXEC);
+            file_size     = 0;
+            cursor        = 0;
+            failed        = file < 0;
+            at_end        = false;
+            buffer_offset = 0;
+            mapping       = nullptr;
+
+            struct stat status;
+
+            if (!failed)
+            {
+                if (fstat (file, &status) == 0 && S_ISREG(status.st_mode))
+                {
+                    file_size = size_t(status.st_size);
+                }
+                else
+                    failed = true;
+            }
+        }
+
+        Linux_Asset::~Linux_Asset()
+        {
+            if (mapping != nullptr)
+            {
+                munmap (mapping, file_size), mapping = nullptr;
+            }
+
+            if (file >= 0)
+            {
+                ::close (file), file = -1;
+            }
+        }
+
+        bool Linux_Asset::good () const
+        {
+            return not failed;
+        }
+
+        bool Linux_Asset::fail () const
+        {
+            return failed;
+        }
+
+        bool Linux_Asset::eof () const
+        {
+            return at_end;
+        }
+
+        size_t Linux_Asset::size () const
+        {
+            return good () ? file_size : 0;
+        }
+
+        bool Linux_Asset::seek (ptrdiff_t offset, Anchor anchor)
+        {
+            if (good ())
+            {
+                ptrdiff_t base       = anchor == BEGINNING ? 0 : anchor == END ? ptrdiff_t(file_size) : ptrdiff_t(cursor);
+                ptrdiff_t new_offset = base + offset;
+
+                if (new_offset >= 0 && size_t(new_offset) <= file_size)
+                {
+                    cursor = size_t(new_offset);
+                    at_end = false;
+
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        size_t Linux_Asset::tell () const
+        {
+            return cursor;
+        }
+
+        byte Linux_Asset::read ()
+        {
+            if (good ())
+            {
+                if (cursor >= file_size)
+                {
+                    at_end = true;
+
+                    return 0;
+                }
+
+                // Las lecturas byte a byte se sirven desde un buffer que se rellena de una vez:
+
+                if (cursor < buffer_offset || cursor >= buffer_offset + buffer.size ())
+                {
+                    buffer.resize (buffer_capacity);
+                    buffer.resize (read_at (cursor, buffer.data (), buffer_capacity));
+
+                    buffer_offset = cursor;
+
+                    if (buffer.empty ())
+                    {
+                        failed = true;
+
+                        return 0;
+                    }
+                }
+
+                return buffer[cursor++ - buffer_offset];
+            }
+
+            return 0;
+        }
+
+        bool Linux_Asset::read_all (std::vector< byte > & buffer)
+        {
+            if (good ())
+            {
+                buffer.resize (file_size);
+
+                if (read_at (0, buffer.data (), file_size) == file_size)
+                {
+                    cursor = file_size;
+
+                    return true;
+                }
+
+                failed = true;
+            }
+
+            return false;
+        }
+
+        bool Linux_Asset::read_all (std::string & buffer)
+        {
+            if (good ())
+            {
+                buffer.resize (file_size);
+
+                if (read_at (0, reinterpret_cast< byte * >(&buffer[0]), file_size) == file_size)
+                {
+                    cursor = file_size;
+
+                    return true;
+                }
+
+                failed = true;
+            }
+
+            return false;
+        }
+
+        size_t Linux_Asset::read_at (size_t offset, byte * buffer, size_t size)
+        {
+            if (!good () || offset >= file_size)
+            {
+                return 0;
+            }
+
+            if (size > file_size - offset)
+            {
+                size = file_size - offset;
+            }
+
+            if (mapping != nullptr)
+            {
+                std::memcpy (buffer, static_cast< const byte * >(mapping) + offset, size);
+
+                return size;
+            }
+
+            // pread() puede leer menos de lo pedido o ser interrumpido por una señal:
+
+            size_t total = 0;
+
+            while (total < size)
+            {
+                ssize_t result = pread (file, buffer + total, size - total, off_t(offset + total));
+
+                if (result > 0)
+                {
+                    total += size_t(result);
+                }
+                else
+                if (result == 0 || errno != EINTR)
+                {
+                    break;
+                }
+            }
+
+            return total;
+        }
+
+        const byte * Linux_Asset::get_buffer ()
+        {
+            if (mapping == nullptr && good () && file_size > 0)
+            {
+                void * address = mmap (nullptr, file_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+                if (address != MAP_FAILED)
+                {
+                    // Los decodificadores recorren los datos de principio a fin:
+
+                    madvise (address, file_size, MADV_WILLNEED);
+
+                    mapping = address;
+                }
+            }
+
+            return static_cast< const byte * >(mapping);
+        }
+
+    }}
+
+#endif
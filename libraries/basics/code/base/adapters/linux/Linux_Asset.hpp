@@ -0,0 +1,80 @@
+/*
+ * LINUX ASSET
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803241000
+ */
+
+#ifndef BASICS_LINUX_ASSET_HEADER
+#define BASICS_LINUX_ASSET_HEADER
+
+    #include <basics/Asset>
+
+    namespace basics { namespace internal
+    {
+
+        /**
+         * Asset leído de un archivo del sistema de archivos, cuya ruta se resuelve a partir de la
+         * raíz que se indica con Asset::set_root(). Las lecturas secuenciales pasan por un buffer,
+         * las lecturas de posiciones concretas usan pread() (que no mueve el cursor ni necesita
+         * sincronización) y get_buffer() proyecta el archivo en memoria con mmap().
+         */
+        class Linux_Asset final : public Asset
+        {
+
+            static const size_t buffer_capacity = 65536;
+
+            int                 file;
+            size_t              file_size;
+            size_t              cursor;
+            bool                failed;
+            bool                at_end;
+
+            std::vector< byte > buffer;                 ///< Datos leídos por adelantado a partir de buffer_offset.
+            size_t              buffer_offset;
+
+            void              * mapping;
+
+        public:
+
+            /**
+             * Directorio a partir del cual se resuelven las rutas de los assets.
+             */
+            static std::string & root ();
+
+            /**
+             * Devuelve la ruta del archivo correspondiente a la ruta de un asset.
+             */
+            static std::string resolve (const std::string & path);
+
+        public:
+
+            Linux_Asset(const std::string & path);
+           ~Linux_Asset();
+
+        public:
+
+            bool   good () const override;
+            bool   fail () const override;
+            bool   eof  () const override;
+
+            size_t size () const override;
+            bool   seek (ptrdiff_t offset, Anchor = CURRENT) override;
+            size_t tell () const override;
+            byte   read () override;
+            bool   read_all (std::vector< byte > & buffer) override;
+            bool   read_all (std::string & buffer) override;
+            size_t read_at  (size_t offset, byte * buffer, size_t size) override;
+
+            const byte * get_buffer () override;
+
+        };
+
+    }}
+
+#endif
@@ -0,0 +1,369 @@
+/*
+ * LINUX URING READER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803261000
+ */
+
+#include <basics/macros>
+
+#if defined(BASICS_LINUX_OS)
+
+    #include <algorithm>
+    #include <cerrno>
+    #include <cstring>
+    #include <fcntl.h>
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+    #include <basics/Asset_Archive>
+    #include "Linux_Asset.hpp"
+    #include "Linux_Uring_Reader.hpp"
+
+    namespace basics { namespace internal
+    {
+
+        std::unique_ptr< Linux_Uring_Reader > Linux_Uring_Reader::create (Asset_Reader & reader)
+        {
+            std::unique_ptr< Linux_Uring_Reader > backend(new Linux_Uring_Reader(reader));
+
+            if (!backend->initialize ())
+            {
+                backend.reset ();
+            }
+
+            return backend;
+        }
+
+        // -----------------------------------------------------------------------------------------
+
+        Linux_Uring_Reader::Linux_Uring_Reader(Asset_Reader & reader)
+        :
+            reader      (reader ),
+            ring        (-1     ),
+            sq_ring     (MAP_FAILED),
+            sq_ring_size(0      ),
+            cq_ring     (MAP_FAILED),
+            cq_ring_size(0      ),
+            sqes        (nullptr),
+            sqes_size   (0      ),
+            in_flight   (0      )
+        {
+        }
+
+        // -----------------------------------------------------------------------------------------
+
+        bool Linux_Uring_Reader::initialize ()
+        {
+            io_uring_params parameters;
+
+            std::memset (&parameters, 0, sizeof(parameters));
+
+            // Puede fallar porque el kernel es anterior a io_uring o porque está deshabilitado o
+            // bloqueado (por ejemplo, por seccomp dentro de un contenedor):
+
+            ring = int(syscall (__NR_io_uring_setup, queue_depth, &parameters));
+
+            if (ring < 0)
+            {
+                return false;
+            }
+
+            sq_ring_size = parameters.sq_off.array + parameters.sq_entries * sizeof(unsigned);
+            cq_ring_size = parameters.cq_off.cqes  + parameters.cq_entries * sizeof(io_uring_cqe);
+            sqes_size    = parameters.sq_entries   * sizeof(io_uring_sqe);
+
+            // Los kernels recientes permiten proyectar las dos colas con un solo mmap():
+
+            bool single_mmap = (parameters.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+            if (single_mmap)
+            {
+                sq_ring_size = cq_ring_size = std::max (sq_ring_size, cq_ring_size);
+            }
+
+            sq_ring = mmap (nullptr, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQ_RING);
+
+            if (sq_ring == MAP_FAILED) return false;
+
+            if (!single_mmap)
+            {
+                cq_ring = mmap (nullptr, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_CQ_RING);
+
+                if (cq_ring == MAP_FAILED) return false;
+            }
+
+            void * sqes_mapping = mmap (nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQES);
+
+            if (sqes_mapping == MAP_FAILED) return false;
+
+            sqes = static_cast< io_uring_sqe * >(sqes_mapping);
+
+            byte * sq = static_cast< byte * >(sq_ring);
+            byte * cq = static_cast< byte * >(single_mmap ? sq_ring : cq_ring);
+
+            sq_tail  = reinterpret_cast< unsigned * >(sq + parameters.sq_off.tail        );
+            sq_mask  = reinterpret_cast< unsigned * >(sq + parameters.sq_off.ring_mask   );
+            sq_array = reinterpret_cast< unsigned * >(sq + parameters.sq_off.array       );
+            cq_head  = reinterpret_cast< unsigned * >(cq + parameters.cq_off.head        );
+            cq_tail  = reinterpret_cast< unsigned * >(cq + parameters.cq_off.tail        );
+            cq_mask  = reinterpret_cast< unsigned * >(cq + parameters.cq_off.ring_mask   );
+            cqes     = reinterpret_cast< io_uring_cqe * >(cq + parameters.cq_off.cqes    );
+
+            completion_thread = std::thread(&Linux_Uring_Reader::run, this);
+
+            return true;
+        }
+
+        // -----------------------------------------------------------------------------------------
+
+        Linux_Uring_Reader::~Linux_Uring_Reader()
+        {
+            if (completion_thread.joinable ())
+            {
+                // Se espera a que terminen las lecturas y se envía una operación vacía que indica al
+                // hilo de las respuestas que debe terminar:
+
+                std::unique_lock< std::mutex > lock(mutex);
+
+                drained.wait (lock, [this] () { return in_flight == 0 && waiting.empty (); });
+
+                push  (nullptr);
+                flush (1);
+
+                lock.unlock ();
+
+                completion_thread.join ();
+            }
+
+            if (sqes                   ) munmap (sqes,    sqes_size   );
+            if (cq_ring != MAP_FAILED  ) munmap (cq_ring, cq_ring_size);
+            if (sq_ring != MAP_FAILED  ) munmap (sq_ring, sq_ring_size);
+            if (ring >= 0              ) close  (ring);
+        }
+
+        // -----------------------------------------------------------------------------------------
+
+        void Linux_Uring_Reader::submit (const std::vector< Asset_Reader::Handle > & reads)
+        {
+            std::vector< Operation * > operations;
+
+            operations.reserve (reads.size ());
+
+            for (auto & read : reads)
+            {
+                size_t packed_size;
+
+                // Los assets de los archivos montados ya están en memoria:
+
+                if (Asset_Archive::find_mounted (read->get_path (), packed_size))
+                {
+                    reader.read_now (read);
+                    continue;
+                }
+
+                int file = ::open (Linux_Asset::resolve (read->get_path ()).c_str (), O_RDONLY | O_CLOEXEC);
+
+                struct stat status;
+
+                if (file < 0 || fstat (file, &status) != 0 || !S_ISREG(status.st_mode))
+                {
+                    if (file >= 0) close (file);
+
+                    reader.complete (read, Asset::Mapping(), false);
+                    continue;
+                }
+
+                size_t size = size_t(status.st_size);
+
+                std::shared_ptr< byte > buffer(new byte[size > 0 ? size : 1], std::default_delete< byte[] >());
+
+                if (size == 0)
+                {
+                    close (file);
+
+                    reader.complete (read, Asset::Mapping(buffer.get (), 0, buffer), true);
+                    continue;
+                }
+
+                operations.push_back (new Operation{ read, file, buffer, size, 0, iovec() });
+            }
+
+            if (!operations.empty ())
+            {
+                std::lock_guard< std::mutex > lock(mutex);
+
+                unsigned count = 0;
+
+                for (auto operation : operations)
+                {
+                    if (in_flight < queue_depth)
+                    {
+                        push (operation);
+
+                        ++in_flight;
+                        ++count;
+                    }
+                    else
+                        waiting.push_back (operation);
+                }
+
+                flush (count);
+            }
+        }
+
+        // -----------------------------------------------------------------------------------------
+
+        void Linux_Uring_Reader::push (Operation * operation)
+        {
+            // Solo se escribe en la cola de envío con el mutex bloqueado, por lo que basta con que la
+            // actualización de la cola sea visible para el kernel cuando ya está escrita la entrada:
+
+            unsigned       tail  = *sq_tail;
+            unsigned       index = tail & *sq_mask;
+            io_uring_sqe & entry = sqes[index];
+
+            std::memset (&entry, 0, sizeof(entry));
+
+            if (operation)
+            {
+                operation->vector.iov_base = operation->buffer.get () + operation->offset;
+                operation->vector.iov_len  = operation->size - operation->offset;
+
+                entry.opcode    = IORING_OP_READV;
+                entry.fd        = operation->file;
+                entry.addr      = reinterpret_cast< uint64_t >(&operation->vector);
+                entry.len       = 1;
+                entry.off       = operation->offset;
+                entry.user_data = reinterpret_cast< uint64_t >(operation);
+            }
+            else
+            {
+                entry.opcode    = IORING_OP_NOP;
+                entry.user_data = 0;
+            }
+
+            sq_array[index] = index;
+
+            __atomic_store_n (sq_tail, tail + 1, __ATOMIC_RELEASE);
+        }
+
+        // -----------------------------------------------------------------------------------------
+
+        void Linux_Uring_Reader::flush (unsigned count)
+        {
+            while (count > 0)
+            {
+                int submitted = int(syscall (__NR_io_uring_enter, ring, count, 0, 0, nullptr, 0));
+
+                if (submitted < 0)
+                {
+                    if (errno == EINTR || errno == EAGAIN) continue;
+
+                    // Las entradas se quedan en la cola y se envían con la siguiente llamada:
+
+                    break;
+                }
+
+                count -= unsigned(submitted);
+            }
+        }
+
+        // -----------------------------------------------------------------------------------------
+
+        void Linux_Uring_Reader::run ()
+        {
+            for (;;)
+            {
+                unsigned head = *cq_head;
+
+                if (head == __atomic_load_n (cq_tail, __ATOMIC_ACQUIRE))
+                {
+                    syscall (__NR_io_uring_enter, ring, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+                    continue;
+                }
+
+                const io_uring_cqe & completion = cqes[head & *cq_mask];
+
+                uint64_t user_data = completion.user_data;
+                int      result    = completion.res;
+
+                __atomic_store_n (cq_head, head + 1, __ATOMIC_RELEASE);
+
+                if (user_data == 0)
+                {
+                    break;
+                }
+
+                Operation * operation = reinterpret_cast< Operation * >(user_data);
+
+                if (finish (operation, result))
+                {
+                    delete operation;
+
+                    std::lock_guard< std::mutex > lock(mutex);
+
+                    unsigned count = 0;
+
+                    for (--in_flight; in_flight < queue_depth && !waiting.empty (); ++in_flight, ++count)
+                    {
+                        push (waiting.front ());
+
+                        waiting.pop_front ();
+                    }
+
+                    flush (count);
+
+                    if (in_flight == 0 && waiting.empty ())
+                    {
+                        drained.notify_all ();
+                    }
+                }
+            }
+        }
+
+        // -----------------------------------------------------------------------------------------
+
+        bool Linux_Uring_Reader::finish (Operation * operation, int result)
+        {
+            if (result > 0)
+            {
+                operation->offset += size_t(result);
+            }
+
+            // Si la lectura ha sido parcial o se ha interrumpido, se pide el resto:
+
+            if ((result > 0 && operation->offset < operation->size) || result == -EINTR || result == -EAGAIN)
+            {
+                std::lock_guard< std::mutex > lock(mutex);
+
+                push  (operation);
+                flush (1);
+
+                return false;
+            }
+
+            close (operation->file);
+
+            if (operation->offset == operation->size)
+            {
+                reader.complete (operation->read, Asset::Mapping(operation->buffer.get (), operation->size, operation->buffer), true);
+            }
+            else
+            {
+                reader.complete (operation->read, Asset::Mapping(), false);
+            }
+
+            return true;
+        }
+
+    }}
+
+#endif
@@ -0,0 +1,115 @@
+/*
+ * LINUX URING READER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803261000
+ */
+
+#ifndef BASICS_LINUX_URING_READER_HEADER
+#define BASICS_LINUX_URING_READER_HEADER
+
+    #include <condition_variable>
+    #include <deque>
+    #include <memory>
+    #include <mutex>
+    #include <thread>
+    #include <sys/uio.h>
+    #include <basics/Asset_Reader>
+
+    struct io_uring_sqe;
+    struct io_uring_cqe;
+
+    namespace basics { namespace internal
+    {
+
+        /**
+         * Backend de Asset_Reader que lee los archivos con io_uring: las lecturas de un lote se
+         * encolan juntas y se envían al kernel con una sola llamada, y un hilo propio recoge las que
+         * terminan. Se usan las llamadas al sistema directamente para no depender de liburing.
+         */
+        class Linux_Uring_Reader final : public Asset_Reader::Backend
+        {
+
+            static const unsigned queue_depth = 64;
+
+            struct Operation
+            {
+                Asset_Reader::Handle    read;
+                int                     file;
+                std::shared_ptr< byte > buffer;
+                size_t                  size;
+                size_t                  offset;         ///< Bytes leídos hasta el momento.
+                iovec                   vector;
+            };
+
+        private:
+
+            Asset_Reader          & reader;
+
+            int                     ring;
+
+            void                  * sq_ring;
+            size_t                  sq_ring_size;
+            void                  * cq_ring;
+            size_t                  cq_ring_size;
+            io_uring_sqe          * sqes;
+            size_t                  sqes_size;
+
+            unsigned              * sq_tail;
+            unsigned              * sq_mask;
+            unsigned              * sq_array;
+            unsigned              * cq_head;
+            unsigned              * cq_tail;
+            unsigned              * cq_mask;
+            io_uring_cqe          * cqes;
+
+            std::mutex              mutex;
+            std::condition_variable drained;
+            std::deque< Operation * > waiting;          ///< Lecturas que no caben en la cola del kernel.
+            unsigned                in_flight;
+
+            std::thread             completion_thread;
+
+        public:
+
+            /**
+             * @return nullptr si el kernel no tiene io_uring o no se permite usarlo.
+             */
+            static std::unique_ptr< Linux_Uring_Reader > create (Asset_Reader & reader);
+
+        private:
+
+            Linux_Uring_Reader(Asset_Reader & reader);
+
+            bool initialize ();
+
+        public:
+
+           ~Linux_Uring_Reader();
+
+        public:
+
+            const char * get_name () const override
+            {
+                return "io_uring";
+            }
+
+            void submit (const std::vector< Asset_Reader::Handle > & reads) override;
+
+        private:
+
+            void push   (Operation * operation);    ///< Con nullptr encola una operación vacía.
+            void flush  (unsigned count);
+            void run    ();
+            bool finish (Operation * operation, int result);
+
+        };
+
+    }}
+
+#endif
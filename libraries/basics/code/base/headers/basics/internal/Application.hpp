@@ -14,6 +14,7 @@
 #define BASICS_APPLICATION_HEADER
 
     #include <memory>
+    #include <string>
     #include <basics/Event_Queue>
 
     namespace basics
@@ -60,6 +61,12 @@
 
             virtual State get_state () const = 0;
 
+            /**
+             * Retorna la ruta de un directorio privado de la aplicación en el que se puede escribir
+             * (por ejemplo, para guardar cachés). Puede estar vacía si la plataforma no lo ofrece.
+             */
+            virtual std::string get_storage_path () const = 0;
+
         public:
 
             void push (const Event & event)
@@ -32,12 +32,82 @@
                 END
             };
 
+            /**
+             * Vista de solo lectura del contenido completo de un asset. Mantiene vivo lo que respalda
+             * los datos (el asset abierto, la proyección en memoria o una copia), por lo que los
+             * punteros que devuelve son válidos mientras exista la instancia (o una copia de ella).
+             */
+            class Mapping
+            {
+
+                std::shared_ptr< const void > owner;
+                const byte                  * data;
+                size_t                        size;
+
+            public:
+
+                Mapping() : data(nullptr), size(0)
+                {
+                }
+
+                Mapping(const byte * data, size_t size, const std::shared_ptr< const void > & owner)
+                :
+                    owner(owner),
+                    data (data ),
+                    size (size )
+                {
+                }
+
+            public:
+
+                bool good () const
+                {
+                    return owner != nullptr;
+                }
+
+                const byte * get_data () const
+                {
+                    return data;
+                }
+
+                size_t get_size () const
+                {
+                    return size;
+                }
+
+                const byte * begin () const
+                {
+                    return data;
+                }
+
+                const byte * end () const
+                {
+                    return data + size;
+                }
+
+            };
+
         public:
 
             static std::shared_ptr< Asset > open (const std::string & path);
+
+            /**
+             * Da acceso al contenido de un asset sin copiarlo cuando la plataforma lo permite
+             * (AAsset_getBuffer() en Android o mmap() en Linux). Si no es posible, el contenido se
+             * lee a un buffer que pertenece al Mapping.
+             * @return Un Mapping que no es good() si el asset no existe o no se puede leer.
+             */
+            static Mapping map (const std::string & path);
             static bool exists (const std::string & path);
             static size_t size (const std::string & path);
 
+            /**
+             * Establece el directorio a partir del cual se resuelven las rutas de los assets en las
+             * plataformas que los leen del sistema de archivos (Linux). Por defecto es el indicado en
+             * la variable de entorno BASICS_ASSET_ROOT o "assets". En Android no tiene efecto.
+             */
+            static void set_root (const std::string & path);
+
         protected:
 
             Asset() = default;
@@ -58,6 +128,22 @@
             virtual bool   read_all (std::vector< byte > & buffer) = 0;
             virtual bool   read_all (std::string & buffer) = 0;
 
+            /**
+             * Lee datos de una posición concreta sin cambiar la posición de lectura (tell()).
+             * @return Número de bytes leídos (menos de size si se llega al final).
+             */
+            virtual size_t read_at  (size_t offset, byte * buffer, size_t size) = 0;
+
+            /**
+             * Devuelve el contenido completo del asset si está accesible en memoria sin copiarlo.
+             * El puntero es válido mientras el asset siga abierto.
+             * @return nullptr si la implementación no lo permite (Asset::map() hace entonces una copia).
+             */
+            virtual const byte * get_buffer ()
+            {
+                return nullptr;
+            }
+
         };
 
     }
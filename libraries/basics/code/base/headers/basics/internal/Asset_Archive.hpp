@@ -0,0 +1,150 @@
+/*
+ * ASSET ARCHIVE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803251010
+ */
+
+#ifndef BASICS_ASSET_ARCHIVE_HEADER
+#define BASICS_ASSET_ARCHIVE_HEADER
+
+    #include <memory>
+    #include <string>
+    #include <basics/Asset>
+    #include <basics/fnv>
+
+    namespace basics
+    {
+
+        /**
+         * Archivo que empaqueta muchos assets en uno solo. Se abre y se proyecta en memoria una vez
+         * (con Asset::map()) y a partir de entonces abrir uno de sus assets solo cuesta buscarlo en
+         * el índice. Los archivos montados con mount() se consultan en Asset::open(), exists() y
+         * size() antes que el sistema de archivos o el APK.
+         *
+         * Formato (little endian):
+         *
+         *   Header                                     32 bytes
+         *   contenido de los assets                    cada uno alineado a 16 bytes
+         *   índice: Entry x entry_count                ordenado por hash (FNV-1a de 32 bits, como ID())
+         *   nombres: rutas de los assets               sin separadores (cada Entry indica dónde está la suya)
+         *
+         * En Android el archivo se debe guardar sin comprimir en el APK (noCompress en Gradle) para
+         * que AAsset_getBuffer() lo proyecte directamente.
+         */
+        class Asset_Archive
+        {
+        public:
+
+            enum Compression : uint32_t
+            {
+                UNCOMPRESSED = 0,
+                LZ4          = 1,                       ///< Bloque LZ4 (ver basics/lz4).
+            };
+
+            struct Header
+            {
+                char     magic[8];                      ///< "BASICSPK".
+                uint32_t version;
+                uint32_t entry_count;
+                uint64_t index_offset;
+                uint64_t names_offset;
+            };
+
+            struct Entry
+            {
+                uint32_t hash;
+                uint32_t name_offset;                   ///< Posición del nombre respecto a names_offset.
+                uint32_t name_length;
+                uint32_t compression;
+                uint64_t offset;                        ///< Posición del contenido en el archivo.
+                uint64_t stored_size;                   ///< Tamaño del contenido tal y como está guardado.
+                uint64_t size;                          ///< Tamaño del asset una vez descomprimido.
+            };
+
+            static constexpr uint32_t version   = 1;
+            static constexpr size_t   alignment = 16;
+
+        public:
+
+            /**
+             * Calcula el hash con el que se ordenan las rutas en el índice.
+             */
+            static uint32_t hash (const std::string & path)
+            {
+                return fnv32 (path);
+            }
+
+            /**
+             * Abre un archivo de assets y comprueba su cabecera y su índice.
+             * @return nullptr si no existe o no es válido.
+             */
+            static std::shared_ptr< Asset_Archive > load (const std::string & path);
+
+            /**
+             * Abre un archivo de assets y hace que sus assets se encuentren con Asset::open().
+             * Si varios archivos contienen la misma ruta, prevalece el último que se ha montado.
+             */
+            static bool mount (const std::string & path);
+
+            static void unmount_all ();
+
+            /**
+             * Busca una ruta en los archivos montados.
+             * @return nullptr si no está en ninguno.
+             */
+            static std::shared_ptr< Asset > open_mounted (const std::string & path);
+
+            static bool find_mounted (const std::string & path, size_t & size);
+
+        private:
+
+            Asset::Mapping  mapping;
+            const Header  * header;
+            const Entry   * entries;
+            const char    * names;
+
+        public:
+
+            Asset_Archive(const Asset::Mapping & mapping);
+
+        public:
+
+            bool good () const
+            {
+                return header != nullptr;
+            }
+
+            size_t get_entry_count () const
+            {
+                return good () ? header->entry_count : 0;
+            }
+
+            /**
+             * Busca una ruta en el índice (búsqueda binaria sobre los hashes y comparación del nombre
+             * solo con las entradas que tienen el mismo hash).
+             */
+            const Entry * find (const std::string & path) const;
+
+            /**
+             * Abre un asset del archivo. Los que no están comprimidos se leen directamente de la
+             * proyección del archivo, por lo que su get_buffer() no copia nada. Los assets abiertos
+             * mantienen vivo el archivo y se pueden usar desde varios hilos a la vez (cada uno con
+             * su propio Asset).
+             */
+            std::shared_ptr< Asset > open (const std::string & path) const;
+
+        private:
+
+            bool validate ();
+
+        };
+
+    }
+
+#endif
@@ -0,0 +1,121 @@
+/*
+ * ASSET MANIFEST
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803301000
+ */
+
+#ifndef BASICS_ASSET_MANIFEST_HEADER
+#define BASICS_ASSET_MANIFEST_HEADER
+
+    #include <string>
+    #include <vector>
+    #include <basics/Id>
+    #include <basics/types>
+
+    namespace basics
+    {
+
+        /**
+         * Lista declarativa de los assets que usa una escena. Es un asset de texto con una entrada
+         * por línea:
+         *
+         *     <ruta> [tipo] [tamaño estimado] [id=<nombre>] [display=<píxeles>]
+         *
+         * El tipo puede ser texture, atlas, font o file y, si se omite, se deduce de la extensión.
+         * El tamaño estimado se da en bytes y admite los sufijos K y M (se usa para repartir o
+         * limitar el trabajo de carga, por lo que no tiene que ser exacto). El id es el que usa la
+         * escena para el asset (el mismo que daría ID(nombre)) y display es el tamaño máximo con el
+         * que se dibuja (ver Texture_2D::Options). Las líneas vacías y las que empiezan por '#' no
+         * se tienen en cuenta.
+         */
+        class Asset_Manifest
+        {
+        public:
+
+            enum Kind
+            {
+                FILE,
+                TEXTURE,
+                ATLAS,                                  ///< .sprites o .slices (depende de su textura).
+                FONT                                    ///< .fnt o .font (depende de su textura).
+            };
+
+            struct Entry
+            {
+                std::string path;
+                Kind        kind;
+                size_t      estimated_size;             ///< 0 si el manifiesto no lo indica.
+                Id          id;                         ///< 0 si el manifiesto no lo indica.
+                unsigned    display_size;               ///< 0 si el manifiesto no lo indica.
+            };
+
+            typedef std::vector< Entry > Entry_List;
+
+        private:
+
+            std::string path;
+            Entry_List  entries;
+            bool        loaded;
+
+        public:
+
+            Asset_Manifest() : loaded(false)
+            {
+            }
+
+            /**
+             * Lee y parsea el manifiesto. Se debe comprobar con good() si se ha podido leer.
+             */
+            Asset_Manifest(const std::string & path);
+
+        public:
+
+            bool good () const
+            {
+                return loaded;
+            }
+
+            const std::string & get_path () const
+            {
+                return path;
+            }
+
+            const Entry_List & get_entries () const
+            {
+                return entries;
+            }
+
+            /**
+             * Busca la entrada con el id indicado.
+             * @return nullptr si no hay ninguna.
+             */
+            const Entry * find (Id id) const;
+
+            /**
+             * Suma de los tamaños estimados de todas las entradas.
+             */
+            size_t get_estimated_size () const;
+
+        public:
+
+            /**
+             * Añade las entradas de un texto con el formato de los manifiestos.
+             */
+            void parse (const byte * begin, const byte * end);
+
+            /**
+             * Deduce el tipo de un asset a partir de la extensión de su ruta.
+             */
+            static Kind get_kind (const std::string & path);
+
+        };
+
+    }
+
+#endif
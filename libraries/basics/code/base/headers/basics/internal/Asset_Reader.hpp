@@ -0,0 +1,214 @@
+/*
+ * ASSET READER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803261000
+ */
+
+#ifndef BASICS_ASSET_READER_HEADER
+#define BASICS_ASSET_READER_HEADER
+
+    #include <atomic>
+    #include <condition_variable>
+    #include <functional>
+    #include <memory>
+    #include <mutex>
+    #include <string>
+    #include <vector>
+    #include <basics/Asset>
+    #include <basics/Thread_Pool>
+
+    namespace basics
+    {
+
+        /**
+         * Lee assets completos de forma asíncrona y por lotes, de modo que las lecturas de varios
+         * assets se solapan en lugar de esperar cada una a la anterior. En Linux se usa io_uring si
+         * el sistema lo permite y, si no (o en Android), un Thread_Pool. Los assets de los archivos
+         * montados (Asset_Archive) ya están en memoria y se entregan sin leer nada.
+         */
+        class Asset_Reader : Non_Copyable
+        {
+        public:
+
+            class Read;
+
+            typedef std::shared_ptr< Read >                Handle;
+            typedef std::function< void (const Read & ) >  Callback;
+
+            /**
+             * Estado de una lectura. Se puede esperar a que termine con wait() (como con un future)
+             * o recibir un callback.
+             */
+            class Read
+            {
+
+                friend class Asset_Reader;
+
+                enum State
+                {
+                    PENDING,
+                    DONE,
+                    FAILED
+                };
+
+                std::string                     path;
+                Asset::Mapping                  data;
+                Callback                        callback;
+                std::atomic< int >              state;
+                mutable std::mutex              mutex;
+                mutable std::condition_variable finished;
+
+            public:
+
+                Read(const std::string & path, const Callback & callback)
+                :
+                    path    (path    ),
+                    callback(callback),
+                    state   (PENDING )
+                {
+                }
+
+            public:
+
+                const std::string & get_path () const
+                {
+                    return path;
+                }
+
+                bool is_done () const
+                {
+                    return state != PENDING;
+                }
+
+                bool has_failed () const
+                {
+                    return state == FAILED;
+                }
+
+                /**
+                 * Contenido del asset una vez que is_done() es true (vacío si ha fallado).
+                 */
+                const Asset::Mapping & get_data () const
+                {
+                    return data;
+                }
+
+                /**
+                 * Bloquea el hilo que la llama hasta que la lectura termina.
+                 * @return true si se ha leído el asset.
+                 */
+                bool wait () const
+                {
+                    std::unique_lock< std::mutex > lock(mutex);
+
+                    finished.wait (lock, [this] () { return is_done (); });
+
+                    return state == DONE;
+                }
+
+            };
+
+            /**
+             * Implementación de las lecturas. Las de cada plataforma se crean en sus adaptadores.
+             */
+            class Backend
+            {
+            public:
+
+                virtual ~Backend() = default;
+
+                virtual const char * get_name () const = 0;
+
+                /**
+                 * Comienza las lecturas. Cada una se debe terminar con Asset_Reader::complete().
+                 */
+                virtual void submit (const std::vector< Handle > & reads) = 0;
+
+            };
+
+        private:
+
+            std::atomic< int >         pending_count;
+
+            std::unique_ptr< Backend > backend;         ///< Lecturas asíncronas de la plataforma (puede no haber).
+            Thread_Pool                thread_pool;     ///< Lecturas (si no hay backend) y sugerencias de lectura anticipada.
+
+        public:
+
+            /**
+             * @param thread_count Número de hilos que se usan si la plataforma no tiene lecturas
+             *     asíncronas (0 para elegirlo según los núcleos).
+             * @param native_reads Con false se usa el Thread_Pool aunque la plataforma tenga lecturas
+             *     asíncronas (sirve para comparar ambas formas).
+             */
+            Asset_Reader(unsigned thread_count = 0, bool native_reads = true);
+
+           ~Asset_Reader();
+
+        public:
+
+            const char * get_backend_name () const
+            {
+                return backend ? backend->get_name () : "thread-pool";
+            }
+
+            /**
+             * Encarga la lectura de un asset. Se puede llamar desde cualquier hilo.
+             * @param callback Se llama desde el hilo que termina la lectura (que no es el del contexto
+             *     gráfico), por lo que solo debe hacer trabajo breve o encargarlo a otro sitio.
+             */
+            Handle read (const std::string & path, const Callback & callback = nullptr);
+
+            /**
+             * Encarga varias lecturas de una vez (con io_uring, con una sola llamada al sistema).
+             */
+            std::vector< Handle > read (const std::vector< std::string > & paths, const Callback & callback = nullptr);
+
+            /**
+             * Sugiere al sistema que lea por adelantado unos assets que se van a necesitar pronto,
+             * sin esperar a que lo haga ni guardar su contenido.
+             */
+            void prefetch (const std::vector< std::string > & paths);
+
+            /**
+             * Hace lo mismo que prefetch() con las rutas de un manifiesto de escena (ver
+             * Asset_Manifest). Las dependencias de las entradas no se siguen (Prefetcher, del módulo gaming, sí lo hace).
+             * @return false si no se ha podido leer el manifiesto.
+             */
+            bool prefetch_manifest (const std::string & manifest_path);
+
+            unsigned get_pending_count () const
+            {
+                return unsigned(pending_count);
+            }
+
+            bool is_idle () const
+            {
+                return pending_count == 0;
+            }
+
+        public:
+
+            /**
+             * Termina una lectura, despierta a quien la espera y llama a su callback. Solo la deben
+             * usar los backends.
+             */
+            void complete (const Handle & read, const Asset::Mapping & data, bool success);
+
+            /**
+             * Lee un asset con Asset::map() en el hilo que la llama. La usan los backends con los
+             * assets que no pueden leer ellos (por ejemplo, los de los archivos montados).
+             */
+            void read_now (const Handle & read);
+
+        };
+
+    }
+
+#endif
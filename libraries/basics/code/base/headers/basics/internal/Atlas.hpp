@@ -13,11 +13,13 @@
 #ifndef BASICS_ATLAS_HEADER
 #define BASICS_ATLAS_HEADER
 
-    #include <map>
+    #include <algorithm>
+    #include <deque>
     #include <memory>
     #include <string>
     #include <vector>
     #include <rapidxml.hpp>
+    #include <basics/Asset>
     #include <basics/Id>
     #include <basics/Point>
     #include <basics/Size>
@@ -27,6 +29,11 @@
     namespace basics
     {
 
+        /**
+         * Textura con un conjunto de slices identificados por el hash de su nombre. Se carga de un
+         * .sprites (XML de darkFunction Editor) o de una tabla binaria .slices (ver Slice_Table),
+         * que se usa en lugar del .sprites si está a su lado.
+         */
         class Atlas
         {
         public:
@@ -44,14 +51,22 @@
 
         private:
 
-            typedef std::shared_ptr< Texture_2D > Texture_Handle;
-            typedef std::map< Id, Slice >         Slice_Map;
-            typedef std::vector< byte >           Buffer;
+            struct Slice_Reference
+            {
+                Id      id;
+                Slice * slice;
+            };
+
+            typedef std::shared_ptr< Texture_2D >  Texture_Handle;
+            typedef std::deque < Slice           > Slice_Storage;
+            typedef std::vector< Slice_Reference > Slice_Index;
+            typedef std::vector< byte            > Buffer;
 
         private:
 
             Texture_Handle texture;
-            Slice_Map      slices;
+            Slice_Storage  slices;                      ///< Los slices no cambian de dirección al añadir otros.
+            Slice_Index    index;                       ///< Ordenado por id para buscar con búsqueda binaria.
 
         public:
 
@@ -72,9 +87,9 @@
 
             const Slice * get_slice (Id id) const
             {
-                Slice_Map::const_iterator slice = slices.find (id);
+                Slice_Index::const_iterator reference = find (id);
 
-                return slice != slices.end () ? &slice->second : nullptr;
+                return reference != index.end () && reference->id == id ? reference->slice : nullptr;
             }
 
             /**
@@ -93,6 +108,20 @@
 
         private:
 
+            Slice_Index::const_iterator find (Id id) const
+            {
+                return std::lower_bound
+                (
+                    index.begin (),
+                    index.end   (),
+                    id,
+                    [] (const Slice_Reference & reference, Id id) { return reference.id < id; }
+                );
+            }
+
+            bool load_texture (const std::string & path, const std::string & texture_name, Graphics_Context::Accessor & context);
+            bool load_table   (const Asset::Mapping & table, const std::string & path, Graphics_Context::Accessor & context);
+
             void parse     (Buffer           & slices_data, const std::string & path, Graphics_Context::Accessor & context);
             void parse_img (rapidxml::xml_node<> * img_tag, const std::string & path, Graphics_Context::Accessor & context);
             void parse_dir (rapidxml::xml_node<> * dir_tag, const std::string & prefix = std::string());
@@ -0,0 +1,108 @@
+/*
+ * ATLAS BUILDER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803141030
+ */
+
+#ifndef BASICS_ATLAS_BUILDER_HEADER
+#define BASICS_ATLAS_BUILDER_HEADER
+
+    #include <memory>
+    #include <string>
+    #include <vector>
+    #include <basics/Atlas>
+    #include <basics/Color_Buffer>
+    #include <basics/Graphics_Context>
+    #include <basics/Id>
+
+    namespace basics
+    {
+
+        /**
+         * Construye en tiempo de ejecución uno o varios atlas a partir de imágenes sueltas, de modo
+         * que los sprites que antes usaban texturas distintas se puedan dibujar con una sola textura
+         * mediante Canvas::fill_rectangle (..., const Atlas::Slice *, ...).
+         */
+        class Atlas_Builder
+        {
+        public:
+
+            struct Options
+            {
+                unsigned page_width;                    ///< Tamaño máximo de cada página.
+                unsigned page_height;
+                unsigned padding;                       ///< Separación en píxeles entre imágenes.
+                unsigned extrusion;                     ///< Píxeles del borde que se replican para evitar sangrado con GL_LINEAR.
+            };
+
+            /**
+             * Estadísticas de la última llamada a build().
+             */
+            struct Statistics
+            {
+                unsigned page_count;
+                unsigned image_count;
+                unsigned rejected_count;                ///< Imágenes que no caben en una página o no se pudieron cargar.
+                float    efficiency;                    ///< Área de las imágenes / área de las páginas.
+                float    build_time;                    ///< Segundos empleados por build().
+            };
+
+            typedef std::shared_ptr< Atlas > Atlas_Handle;
+            typedef std::vector< Atlas_Handle > Atlas_List;
+
+        private:
+
+            struct Image
+            {
+                Id                       id;
+                Color_Buffer< Rgba8888 > color_buffer;
+            };
+
+        private:
+
+            Options             options;
+            std::vector< Image > images;
+            Statistics          statistics;
+            unsigned            load_failures;          ///< Imágenes que add() no pudo cargar desde el último build().
+
+        public:
+
+            Atlas_Builder(const Options & options = { 1024, 1024, 2, 1 });
+
+        public:
+
+            /**
+             * Añade una imagen. El id será el de su slice en el atlas resultante.
+             */
+            void add (Id id, const Color_Buffer< Rgba8888 > & color_buffer);
+
+            /**
+             * Añade una imagen PNG leída de los assets.
+             * @return false si no se pudo leer o decodificar.
+             */
+            bool add (Id id, const std::string & asset_path);
+
+            /**
+             * Reparte las imágenes añadidas en páginas y crea un atlas (con su textura) por página.
+             * Las imágenes se descartan después.
+             */
+            Atlas_List build (Graphics_Context::Accessor & context);
+
+        public:
+
+            const Statistics & get_statistics () const
+            {
+                return statistics;
+            }
+
+        };
+
+    }
+
+#endif
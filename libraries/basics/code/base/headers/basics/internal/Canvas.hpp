@@ -19,6 +19,7 @@
     #include <basics/Renderer>
     #include <basics/Size>
     #include <basics/Text_Layout>
+    #include <basics/Text_Prefab>
     #include <basics/Texture_2D>
     #include <basics/Transformation>
 
@@ -57,6 +58,15 @@
                 Size2u size;
             };
 
+            /**
+             * Contadores de primitivas desde la última llamada a clear() (o a reset_statistics()).
+             */
+            struct Statistics
+            {
+                unsigned submitted;                 ///< Primitivas que se han llegado a dibujar.
+                unsigned culled;                    ///< Primitivas descartadas por quedar fuera del viewport.
+            };
+
         public:
 
             typedef Canvas * (* Factory) (Id id, Graphics_Context::Accessor & context, const Options & options);
@@ -82,8 +92,30 @@
 
         protected:
 
+            Statistics statistics;
+
+        protected:
+
+            Canvas()
+            {
+                reset_statistics ();
+            }
+
             virtual ~Canvas() = default;
 
+        public:
+
+            const Statistics & get_statistics () const
+            {
+                return statistics;
+            }
+
+            void reset_statistics ()
+            {
+                statistics.submitted = 0;
+                statistics.culled    = 0;
+            }
+
         public:
 
             virtual void reset_state     () { }
@@ -113,6 +145,39 @@
             virtual void fill_rectangle  (const Point2f & where, const Size2f & size, const Texture_2D   * texture, int handling = CENTER) { }
             virtual void fill_rectangle  (const Point2f & where, const Size2f & size, const Atlas::Slice * slice,   int handling = CENTER) { }
             virtual void draw_text       (const Point2f & where, const Text_Layout & text_layout, int handling = TOP | LEFT);
+            virtual void draw_text       (const Point2f & where, const Text_Prefab & text_prefab, int handling = TOP | LEFT);
+
+        protected:
+
+            /**
+             * Calcula la esquina superior izquierda de un bloque de texto según el anclaje indicado.
+             */
+            static Point2f get_text_top_left (const Point2f & where, float width, float height, int handling);
+
+            void draw_glyphs (const Point2f & top_left, const Text_Layout::Glyph_List & glyphs);
+
+            /**
+             * Comprueba si una primitiva queda completamente fuera del volumen de visión y actualiza
+             * las estadísticas. Se debe llamar antes de generar los vértices.
+             * @param clip_transform Transformación que lleva al espacio de recorte (proyección * transformación).
+             * @param points Vértices de la primitiva (o de su caja envolvente) antes de transformar.
+             * @param count Número de vértices.
+             * @return true si la primitiva se puede descartar.
+             */
+            bool cull (const Transformation2f & clip_transform, const Point2f * points, unsigned count);
+
+            bool cull (const Transformation2f & clip_transform, const Point2f & bottom_left, const Size2f & size)
+            {
+                const Point2f corners[] =
+                {
+                      bottom_left,
+                    { bottom_left[0] + size.width, bottom_left[1]               },
+                    { bottom_left[0] + size.width, bottom_left[1] + size.height },
+                    { bottom_left[0],              bottom_left[1] + size.height },
+                };
+
+                return cull (clip_transform, corners, 4);
+            }
 
         };
 
@@ -0,0 +1,80 @@
+/*
+ * FONT TABLE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803281000
+ */
+
+#ifndef BASICS_FONT_TABLE_HEADER
+#define BASICS_FONT_TABLE_HEADER
+
+    #include <cstdint>
+
+    namespace basics
+    {
+
+        /**
+         * Formato binario de las fuentes de Raster_Font (archivos .font), equivalente a los .fnt en
+         * XML de BMFont pero sin necesidad de parseo. Todos los campos son little-endian:
+         *
+         *     Header
+         *     char    face[face_length]                (sin terminador, rellenado con ceros hasta múltiplo de 4)
+         *     char    texture_name[texture_name_length] (igual que face)
+         *     Glyph   glyphs[glyph_count]              (ordenados por código de menor a mayor)
+         *     Kerning kernings[kerning_count]          (ordenados por first y después por second)
+         */
+        struct Font_Table
+        {
+            enum : uint32_t
+            {
+                MAGIC   = 0x544E4642u,                  ///< "BFNT"
+                VERSION = 1
+            };
+
+            struct Header
+            {
+                uint32_t magic;
+                uint32_t version;
+                uint32_t line_height;
+                uint32_t base;                          ///< Distancia desde la parte superior de la línea hasta la base.
+                uint32_t glyph_count;
+                uint32_t kerning_count;
+                uint32_t face_length;
+                uint32_t texture_name_length;
+            };
+
+            struct Glyph
+            {
+                uint32_t code;
+                uint16_t x;                             ///< Columna del primer píxel.
+                uint16_t y;                             ///< Fila del primer píxel (desde arriba).
+                uint16_t width;
+                uint16_t height;
+                int16_t  x_offset;
+                int16_t  y_offset;
+                int16_t  advance;
+                uint16_t reserved;
+            };
+
+            struct Kerning
+            {
+                uint32_t first;
+                uint32_t second;
+                int16_t  amount;
+                uint16_t reserved;
+            };
+
+            static_assert (sizeof(Header ) == 32, "Font_Table::Header must not have padding." );
+            static_assert (sizeof(Glyph  ) == 20, "Font_Table::Glyph must not have padding."  );
+            static_assert (sizeof(Kerning) == 12, "Font_Table::Kerning must not have padding.");
+
+        };
+
+    }
+
+#endif
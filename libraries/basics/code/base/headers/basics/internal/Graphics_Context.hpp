@@ -162,29 +162,72 @@
                 return renderers.find (id) == renderers.end () ? renderers[id] = renderer, true : false;
             }
 
-            // CUIDADO CON AÑADIR DUPLICADOS. PODRÍA ESTAR BIEN QUE CADA RECURSO TUVIESE UN Id ÚNICO Y
-            // AÑADIRLOS A UN MAPA PARA EVITAR DUPLICIDADES.
+            /**
+             * Inicializa un recurso y lo mantiene vivo mientras lo use alguien más. Si el contexto
+             * tiene caché, se registra en ella para que se pueda restaurar o expulsar.
+             */
             bool add (const std::shared_ptr< Graphics_Resource > & resource)
             {
                 if (resource)
                 {
-                    resources.push_back (resource);
+                    // Se descartan los recursos que solo retiene el contexto y se evitan duplicados:
 
-                    return resource->initialize ();
+                    bool found = false;
+
+                    for (auto iterator = resources.begin (); iterator != resources.end (); )
+                    {
+                        if (*iterator == resource)
+                        {
+                            found = true; ++iterator;
+                        }
+                        else
+                        if (iterator->use_count () == 1)
+                        {
+                            iterator = resources.erase (iterator);
+                        }
+                        else
+                            ++iterator;
+                    }
+
+                    if (!found) resources.push_back (resource);
+
+                    return register_resource (resource, true);
                 }
 
                 return false;
             }
 
+            /**
+             * Hace lo mismo que add() sin mantener vivo el recurso, que se destruye (liberando su
+             * memoria de vídeo) en cuanto se suelta la última referencia externa.
+             */
+            bool attach (const std::shared_ptr< Graphics_Resource > & resource)
+            {
+                return resource ? register_resource (resource, false) : false;
+            }
+
         public:
 
             virtual void initialize ()
             {
                 if (graphics_resource_cache)
                 {
+                    // Se copian las referencias antes porque add() puede reordenar la caché. Solo se
+                    // retienen los recursos que retenía el contexto anterior para que los que se
+                    // añadieron con attach() se sigan liberando con su última referencia externa:
+
+                    std::vector< std::pair< std::shared_ptr< Graphics_Resource >, bool > > cached_resources;
+
                     for (auto iterator = graphics_resource_cache->begin (); iterator != graphics_resource_cache->end (); ++iterator)
                     {
-                        add (iterator->lock ());
+                        auto resource = iterator->lock ();
+
+                        if  (resource)  cached_resources.emplace_back (resource, iterator->is_retained ());
+                    }
+
+                    for (auto & cached_resource : cached_resources)
+                    {
+                        if (cached_resource.second) add (cached_resource.first); else attach (cached_resource.first);
                     }
                 }
             }
@@ -220,6 +263,20 @@
             virtual bool make_current () = 0;
             virtual bool flush_and_display () = 0;
 
+        private:
+
+            bool register_resource (const std::shared_ptr< Graphics_Resource > & resource, bool retained)
+            {
+                bool success = resource->is_initialized () || resource->initialize ();
+
+                if (graphics_resource_cache)
+                {
+                    graphics_resource_cache->add (resource, retained);
+                }
+
+                return success;
+            }
+
         };
 
     }
@@ -13,22 +13,33 @@
 #ifndef BASICS_GRAPHICS_RESOURCE_HEADER
 #define BASICS_GRAPHICS_RESOURCE_HEADER
 
+    #include <cstddef>
     #include <memory>
 
     namespace basics
     {
 
+        class Graphics_Resource_Cache;
+
         class Graphics_Resource
         {
+
+            friend class Graphics_Resource_Cache;
+
         protected:
 
             bool initialized;
 
+        private:
+
+            Graphics_Resource_Cache * cache;            ///< Caché en la que está registrado el recurso (si lo está).
+
         protected:
 
             Graphics_Resource()
             {
                 initialized = false;
+                cache       = nullptr;
             }
 
             virtual ~Graphics_Resource() = default;
@@ -38,6 +49,41 @@
             virtual bool initialize (/*Graphics_Context & context*/) = 0;
             virtual void finalize   () = 0;
 
+        public:
+
+            bool is_initialized () const
+            {
+                return initialized;
+            }
+
+            /**
+             * Retorna el número de bytes de memoria de vídeo que ocupa el recurso mientras está
+             * inicializado.
+             */
+            virtual size_t get_byte_size () const
+            {
+                return 0;
+            }
+
+            /**
+             * Indica si el recurso se puede finalizar para liberar memoria de vídeo y volver a
+             * inicializar más tarde sin perder su contenido.
+             */
+            virtual bool is_evictable () const
+            {
+                return false;
+            }
+
+        protected:
+
+            /**
+             * Se debe llamar antes de usar el recurso para dibujar. Si fue expulsado de la memoria de
+             * vídeo lo vuelve a inicializar y, si está registrado en una caché, lo marca como el
+             * usado más recientemente.
+             * @return true si el recurso está inicializado.
+             */
+            bool make_resident () const;
+
         };
 
     }
@@ -14,6 +14,7 @@
 #define BASICS_GRAPHICS_RESOURCE_CACHE_HEADER
 
     #include <list>
+    #include <unordered_map>
     #include <basics/Graphics_Resource>
 
     namespace basics
@@ -22,19 +23,72 @@
         /**
          * Mantiene punteros weak a recursos que están en uso en situaciones en las que el contexto
          * gráfico se puede destruir y volver a crear.
+         *
+         * Además lleva la cuenta de la memoria de vídeo que ocupan y del orden en el que se usan.
+         * Si se establece un presupuesto, cuando se supera se finalizan los recursos expulsables
+         * usados menos recientemente, que se vuelven a inicializar cuando se usan de nuevo.
          */
         class Graphics_Resource_Cache
         {
+        public:
+
+            struct Statistics
+            {
+                unsigned hits;                          ///< Usos de recursos que estaban inicializados.
+                unsigned misses;                        ///< Usos que han requerido volver a inicializar el recurso.
+                unsigned evictions;                     ///< Recursos finalizados para respetar el presupuesto.
+                size_t   resident_bytes;                ///< Memoria de vídeo ocupada por los recursos inicializados.
+                size_t   peak_bytes;                    ///< Máximo de resident_bytes.
+            };
+
+        private:
+
+            struct Entry
+            {
+                std::weak_ptr< Graphics_Resource > resource;
+                const Graphics_Resource          * pointer;
+                size_t                             size;        ///< Bytes contabilizados en resident_bytes.
+                bool                               retained;    ///< true si el contexto lo mantiene vivo (ver Graphics_Context::add()).
 
-            typedef std::list< std::weak_ptr< Graphics_Resource > > Graphics_Resource_List;
+                std::shared_ptr< Graphics_Resource > lock () const
+                {
+                    return resource.lock ();
+                }
+
+                bool is_retained () const
+                {
+                    return retained;
+                }
+            };
+
+            typedef std::list< Entry > Graphics_Resource_List;  ///< Del más recientemente usado al menos.
 
         public:
 
             typedef Graphics_Resource_List::iterator Iterator;
 
-        public:
+        private:
+
+            typedef std::unordered_map< const Graphics_Resource *, Iterator > Index;
+
+        private:
 
             Graphics_Resource_List resources;
+            Index                  index;
+            size_t                 budget;
+            Statistics             statistics;
+
+        public:
+
+            Graphics_Resource_Cache()
+            {
+                budget     = 0;
+                statistics = Statistics();
+            }
+
+           ~Graphics_Resource_Cache();
+
+            Graphics_Resource_Cache(const Graphics_Resource_Cache & ) = delete;
 
         public:
 
@@ -48,6 +102,69 @@
                 return resources.end ();
             }
 
+            size_t size () const
+            {
+                return resources.size ();
+            }
+
+        public:
+
+            /**
+             * Registra un recurso (si no lo estaba ya) y contabiliza su memoria.
+             * @param retained true si el contexto mantiene vivo el recurso. Se recuerda para que, al
+             *     volver a crear el contexto, este retenga los mismos recursos que el anterior y no
+             *     los demás.
+             */
+            void add (const std::shared_ptr< Graphics_Resource > & resource, bool retained = false);
+
+            /**
+             * Marca un recurso como el usado más recientemente, inicializándolo si fue expulsado.
+             * @return true si el recurso está inicializado.
+             */
+            bool use (Graphics_Resource & resource);
+
+            /**
+             * Establece la memoria de vídeo máxima (en bytes) que pueden ocupar los recursos
+             * expulsables. Con 0 no hay límite.
+             */
+            void set_budget (size_t new_budget)
+            {
+                budget = new_budget;
+                enforce_budget ();
+            }
+
+            size_t get_budget () const
+            {
+                return budget;
+            }
+
+            /**
+             * Elimina las entradas de los recursos que ya no existen.
+             */
+            void prune ();
+
+        public:
+
+            const Statistics & get_statistics () const
+            {
+                return statistics;
+            }
+
+            void reset_statistics ()
+            {
+                size_t resident_bytes = statistics.resident_bytes;
+
+                statistics = Statistics();
+                statistics.resident_bytes = resident_bytes;
+                statistics.peak_bytes     = resident_bytes;
+            }
+
+        private:
+
+            void update_size    (Entry & entry, const Graphics_Resource & resource);
+            void enforce_budget (const Graphics_Resource * keep = nullptr);
+            void remove         (Iterator entry);
+
         };
 
     }
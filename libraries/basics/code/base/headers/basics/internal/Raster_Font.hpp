@@ -13,8 +13,8 @@
 #ifndef BASICS_RASTER_FONT_HEADER
 #define BASICS_RASTER_FONT_HEADER
 
+    #include <algorithm>
     #include <memory>
-    #include <unordered_map>
     #include <vector>
     #include <basics/Atlas>
     #include <basics/Font>
@@ -23,6 +23,12 @@
     namespace basics
     {
 
+        /**
+         * Fuente de mapa de bits cargada de un .fnt en XML de BMFont o de su versión binaria .font
+         * (ver Font_Table), que se usa en lugar del .fnt si está a su lado. Los caracteres de los
+         * rangos Basic Latin y Latin-1 se buscan indexando una tabla y el resto con una búsqueda
+         * binaria.
+         */
         class Raster_Font : public Font
         {
         public:
@@ -35,22 +41,36 @@
 
             struct Character : public Font::Character
             {
+                uint32_t       code;
                 Atlas::Slice * slice;
                 Vector2f       offset;
                 float          advance;
             };
 
+            static const uint32_t direct_range = 256;   ///< Los códigos menores se buscan indexando.
+
         private:
 
-            typedef std::unordered_map< uint32_t, Character > Character_Map;
-            typedef std::vector< byte >                       Buffer;
-            typedef std::unique_ptr< Atlas >                  Atlas_Handle;
+            struct Kerning
+            {
+                uint64_t pair;                          ///< Código del primer carácter en la parte alta y del segundo en la baja.
+                float    amount;
+            };
+
+            typedef std::vector< Character > Character_List;
+            typedef std::vector< uint32_t  > Code_List;
+            typedef std::vector< Kerning   > Kerning_List;
+            typedef std::vector< byte      > Buffer;
+            typedef std::unique_ptr< Atlas > Atlas_Handle;
 
         private:
 
-            Character_Map character_map;
-            Atlas_Handle  atlas;
-            Metrics       metrics;
+            Character_List    characters;               ///< Ordenados por código.
+            Code_List         codes;                    ///< Códigos de characters para buscarlos sin recorrer los caracteres.
+            const Character * direct[direct_range];     ///< Caracteres de código menor que direct_range (nullptr si no están).
+            Kerning_List      kernings;                 ///< Ordenados por par.
+            Atlas_Handle      atlas;
+            Metrics           metrics;
 
         public:
 
@@ -65,20 +85,55 @@
 
             const Character * get_character (uint32_t code) const
             {
-                Character_Map::const_iterator item = character_map.find (code);
+                if (code < direct_range)
+                {
+                    return direct[code];
+                }
+
+                Code_List::const_iterator item = std::lower_bound (codes.begin (), codes.end (), code);
+
+                return item != codes.end () && *item == code ? &characters[item - codes.begin ()] : nullptr;
+            }
+
+            bool has_kerning () const
+            {
+                return !kernings.empty ();
+            }
+
+            /**
+             * Retorna el ajuste horizontal que se suma al avance del primer carácter cuando le sigue
+             * el segundo (0 si la fuente no lo indica).
+             */
+            float get_kerning (uint32_t first, uint32_t second) const
+            {
+                uint64_t pair = uint64_t(first) << 32 | second;
+
+                Kerning_List::const_iterator item = std::lower_bound
+                (
+                    kernings.begin (),
+                    kernings.end   (),
+                    pair,
+                    [] (const Kerning & kerning, uint64_t pair) { return kerning.pair < pair; }
+                );
 
-                return item != character_map.end () ? &item->second : nullptr;
+                return item != kernings.end () && item->pair == pair ? item->amount : 0.f;
             }
 
         private:
 
-            bool parse        (Buffer & font_data, const std::string & path, Graphics_Context::Accessor & context);
-            bool parse_font   (rapidxml::xml_node<> *   font_tag, const std::string & path, Graphics_Context::Accessor & context);
-            bool parse_pages  (rapidxml::xml_node<> *  pages_tag, const std::string & path, Graphics_Context::Accessor & context);
-            bool parse_info   (rapidxml::xml_node<> *   info_tag);
-            bool parse_common (rapidxml::xml_node<> * common_tag);
-            bool parse_chars  (rapidxml::xml_node<> *  chars_tag);
-            bool parse_char   (rapidxml::xml_node<> *   char_tag);
+            bool load_table     (const Asset::Mapping & table, const std::string & path, Graphics_Context::Accessor & context);
+            bool load_texture   (const std::string & path, const std::string & texture_name, Graphics_Context::Accessor & context);
+            bool add_character  (uint32_t code, int x, int y, int width, int height, int x_offset, int y_offset, int advance);
+            bool index          ();
+
+            bool parse          (Buffer & font_data, const std::string & path, Graphics_Context::Accessor & context);
+            bool parse_font     (rapidxml::xml_node<> *     font_tag, const std::string & path, Graphics_Context::Accessor & context);
+            bool parse_pages    (rapidxml::xml_node<> *    pages_tag, const std::string & path, Graphics_Context::Accessor & context);
+            bool parse_info     (rapidxml::xml_node<> *     info_tag);
+            bool parse_common   (rapidxml::xml_node<> *   common_tag);
+            bool parse_chars    (rapidxml::xml_node<> *    chars_tag);
+            bool parse_char     (rapidxml::xml_node<> *     char_tag);
+            void parse_kernings (rapidxml::xml_node<> * kernings_tag);
 
         };
 
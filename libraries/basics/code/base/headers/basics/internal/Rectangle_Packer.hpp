@@ -0,0 +1,119 @@
+/*
+ * RECTANGLE PACKER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803141000
+ */
+
+#ifndef BASICS_RECTANGLE_PACKER_HEADER
+#define BASICS_RECTANGLE_PACKER_HEADER
+
+    #include <cstdint>
+    #include <vector>
+    #include <basics/Point>
+    #include <basics/Size>
+
+    namespace basics
+    {
+
+        /**
+         * Reparte rectángulos dentro de un área fija usando el algoritmo skyline (bottom-left): se
+         * mantiene el perfil superior de lo ya ocupado y cada rectángulo se coloca donde su borde
+         * queda más arriba (más cerca del origen). Las coordenadas crecen hacia abajo, igual que
+         * las filas de una imagen.
+         */
+        class Rectangle_Packer
+        {
+
+            struct Segment
+            {
+                unsigned x;
+                unsigned y;
+                unsigned width;
+            };
+
+            typedef std::vector< Segment > Skyline;
+
+        private:
+
+            unsigned width;
+            unsigned height;
+            unsigned used_height;
+            uint64_t used_area;
+            Skyline  skyline;
+
+        public:
+
+            Rectangle_Packer(unsigned width, unsigned height)
+            :
+                width (width ),
+                height(height)
+            {
+                reset ();
+            }
+
+        public:
+
+            /**
+             * Busca un hueco para un rectángulo y lo marca como ocupado.
+             * @param size Tamaño del rectángulo.
+             * @param position Recibe la esquina superior izquierda asignada.
+             * @return false si el rectángulo no cabe.
+             */
+            bool insert (const Size2u & size, Point2u & position);
+
+            void reset ()
+            {
+                used_height = 0;
+                used_area   = 0;
+
+                skyline.assign (1, Segment{ 0, 0, width });
+            }
+
+        public:
+
+            unsigned get_width () const
+            {
+                return width;
+            }
+
+            unsigned get_height () const
+            {
+                return height;
+            }
+
+            /**
+             * Retorna la altura máxima alcanzada por los rectángulos insertados.
+             */
+            unsigned get_used_height () const
+            {
+                return used_height;
+            }
+
+            uint64_t get_used_area () const
+            {
+                return used_area;
+            }
+
+            /**
+             * Retorna la fracción del área total cubierta por los rectángulos insertados.
+             */
+            float get_occupancy () const
+            {
+                return width && height ? float(double(used_area) / (double(width) * double(height))) : 0.f;
+            }
+
+        private:
+
+            bool fits (size_t index, const Size2u & size, unsigned & y) const;
+
+        };
+
+    }
+
+#endif
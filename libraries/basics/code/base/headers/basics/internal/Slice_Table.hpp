@@ -0,0 +1,63 @@
+/*
+ * SLICE TABLE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803151100
+ */
+
+#ifndef BASICS_SLICE_TABLE_HEADER
+#define BASICS_SLICE_TABLE_HEADER
+
+    #include <cstdint>
+
+    namespace basics
+    {
+
+        /**
+         * Formato binario de las tablas de slices (archivos .slices), equivalente a los .sprites en
+         * XML pero sin necesidad de parseo. Todos los campos son little-endian:
+         *
+         *     Header
+         *     char  texture_name[name_length]      (sin terminador, rellenado con ceros hasta múltiplo de 4)
+         *     Entry entries[slice_count]           (ordenadas por id de menor a mayor)
+         */
+        struct Slice_Table
+        {
+            enum : uint32_t
+            {
+                MAGIC   = 0x544C5342u,                  ///< "BSLT"
+                VERSION = 1
+            };
+
+            struct Header
+            {
+                uint32_t magic;
+                uint32_t version;
+                uint32_t texture_width;
+                uint32_t texture_height;
+                uint32_t slice_count;
+                uint32_t name_length;
+            };
+
+            struct Entry
+            {
+                uint32_t id;                            ///< fnv32 del nombre completo del slice (igual que en los .sprites).
+                uint16_t x;                             ///< Columna del primer píxel.
+                uint16_t y;                             ///< Fila del primer píxel (desde arriba).
+                uint16_t width;
+                uint16_t height;
+            };
+
+            static_assert (sizeof(Header) == 24, "Slice_Table::Header must not have padding.");
+            static_assert (sizeof(Entry ) == 12, "Slice_Table::Entry must not have padding." );
+
+        };
+
+    }
+
+#endif
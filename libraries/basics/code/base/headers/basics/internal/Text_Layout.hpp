@@ -43,14 +43,56 @@
 
         private:
 
-            Glyph_List glyphs;
-            float      width;
-            float      height;
+            /**
+             * Estado de la maquetación justo antes de procesar un carácter. Permite retomarla a partir
+             * del primer carácter que cambia sin recorrer de nuevo el resto del texto.
+             */
+            struct Pen
+            {
+                float    x;
+                float    y;
+                float    width;
+                float    height;
+                unsigned glyph_count;
+            };
+
+            typedef std::vector< Pen > Pen_List;
+
+        private:
+
+            const Raster_Font * font;
+            std::wstring        text;
+            Glyph_List          glyphs;
+            Pen_List            pens;                       ///< Un elemento por carácter más el estado final.
+            float               width;
+            float               height;
 
         public:
 
+            Text_Layout();
             Text_Layout(const Raster_Font & font, const std::wstring & text);
 
+        public:
+
+            /**
+             * Actualiza la maquetación para un nuevo texto. Si la fuente no cambia, solo se recalculan
+             * los glifos a partir del primer carácter distinto y se reutiliza la memoria ya reservada.
+             * @return Índice del primer carácter que se ha vuelto a maquetar.
+             */
+            size_t update (const Raster_Font & font, const std::wstring & text);
+
+        public:
+
+            const Raster_Font * get_font () const
+            {
+                return font;
+            }
+
+            const std::wstring & get_text () const
+            {
+                return text;
+            }
+
         public:
 
             const Glyph_List & get_glyphs () const
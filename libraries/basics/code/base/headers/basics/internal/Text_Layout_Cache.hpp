@@ -0,0 +1,114 @@
+/*
+ * TEXT LAYOUT CACHE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803121000
+ */
+
+#ifndef BASICS_TEXT_LAYOUT_CACHE_HEADER
+#define BASICS_TEXT_LAYOUT_CACHE_HEADER
+
+    #include <list>
+    #include <memory>
+    #include <string>
+    #include <unordered_map>
+    #include <basics/Text_Layout>
+
+    namespace basics
+    {
+
+        /**
+         * Caché de maquetaciones de texto indexada por fuente y por el hash del texto. Cuando se llena
+         * se descarta la entrada usada hace más tiempo (LRU) y, si nadie más la está usando, su
+         * Text_Layout se reaprovecha para el nuevo texto con Text_Layout::update().
+         */
+        class Text_Layout_Cache
+        {
+        public:
+
+            struct Statistics
+            {
+                unsigned hits;
+                unsigned misses;
+                unsigned evictions;
+            };
+
+        private:
+
+            struct Entry
+            {
+                uint32_t                       hash;
+                std::shared_ptr< Text_Layout > layout;
+            };
+
+            typedef std::list< Entry >                                         Entry_List;
+            typedef std::unordered_multimap< uint32_t, Entry_List::iterator > Entry_Index;
+
+        private:
+
+            Entry_List  entries;                        ///< Ordenadas de la más recientemente usada a la menos.
+            Entry_Index index;
+            size_t      capacity;
+            Statistics  statistics;
+
+        public:
+
+            Text_Layout_Cache(size_t capacity = 64)
+            :
+                capacity(capacity > 0 ? capacity : 1)
+            {
+                reset_statistics ();
+            }
+
+        public:
+
+            /**
+             * Devuelve la maquetación del texto con la fuente indicada, creándola si no estaba en la caché.
+             * El puntero devuelto sigue siendo válido aunque la entrada se descarte más tarde.
+             */
+            std::shared_ptr< const Text_Layout > get (const Raster_Font & font, const std::wstring & text);
+
+            void clear ()
+            {
+                index  .clear ();
+                entries.clear ();
+            }
+
+        public:
+
+            size_t size () const
+            {
+                return entries.size ();
+            }
+
+            size_t get_capacity () const
+            {
+                return capacity;
+            }
+
+            const Statistics & get_statistics () const
+            {
+                return statistics;
+            }
+
+            void reset_statistics ()
+            {
+                statistics.hits      = 0;
+                statistics.misses    = 0;
+                statistics.evictions = 0;
+            }
+
+        private:
+
+            void remove_from_index (Entry_List::iterator entry);
+
+        };
+
+    }
+
+#endif
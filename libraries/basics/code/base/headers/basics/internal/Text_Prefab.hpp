@@ -13,18 +13,106 @@
 #ifndef BASICS_TEXT_PREFAB_HEADER
 #define BASICS_TEXT_PREFAB_HEADER
 
+    #include <memory>
+    #include <basics/Atlas>
+    #include <basics/Graphics_Context>
+    #include <basics/Graphics_Resource>
     #include <basics/Text_Layout>
+    #include <basics/Texture_2D>
 
     namespace basics
     {
 
-        class Text_Prefab
+        /**
+         * Texto preparado para dibujarse repetidamente sin recalcular su maquetación. Se construye
+         * una sola vez a partir de un Text_Layout y las especializaciones de cada contexto gráfico
+         * pueden guardar todos los quads de los glifos en memoria de vídeo para dibujarlos con una
+         * única llamada. Todos los glifos deben pertenecer a la misma página de atlas (la fuente).
+         * El prefab guarda una copia de los slices de sus glifos, por lo que puede sobrevivir a la
+         * fuente.
+         */
+        class Text_Prefab : public Graphics_Resource
         {
         public:
 
-            Text_Prefab() = default;
+            typedef std::shared_ptr< Text_Prefab > (* Factory) (Id id, const Text_Layout & text_layout);
+
+        private:
+
+            static Id      text_prefab_specialization_ids      [10];
+            static Factory text_prefab_specialization_factories[10];
+            static size_t  text_prefab_specialization_count;
+
+        protected:
+
+            static void register_factory (Id id, Factory factory)
+            {
+                text_prefab_specialization_ids      [text_prefab_specialization_count] = id;
+                text_prefab_specialization_factories[text_prefab_specialization_count] = factory;
+                text_prefab_specialization_count++;
+            }
+
+        public:
+
+            /**
+             * Crea un prefab usando la especialización registrada para el contexto y lo añade a sus
+             * recursos. Si el contexto no tiene una especialización, se crea un prefab genérico que
+             * los canvas dibujan glifo a glifo.
+             */
+            static std::shared_ptr< Text_Prefab > create (Id id, Graphics_Context::Accessor & context, const Text_Layout & text_layout);
+
+        protected:
+
+            Text_Layout::Glyph_List        glyphs;              ///< Apuntan a los slices de atlas, no a los de la fuente.
+            std::shared_ptr< Texture_2D >  texture;             ///< Se retiene para que no se libere antes que el prefab.
+            std::unique_ptr< Atlas      >  atlas;               ///< Copia de los slices de los glifos sobre la textura.
+            float                          width;
+            float                          height;
+
+        public:
+
+            Text_Prefab(const Text_Layout & text_layout);
+
             virtual ~Text_Prefab() = default;
 
+        public:
+
+            bool initialize () override
+            {
+                return initialized = true;
+            }
+
+            void finalize () override
+            {
+            }
+
+        public:
+
+            const Text_Layout::Glyph_List & get_glyphs () const
+            {
+                return glyphs;
+            }
+
+            const std::shared_ptr< Texture_2D > & get_texture () const
+            {
+                return texture;
+            }
+
+            float get_width () const
+            {
+                return width;
+            }
+
+            float get_height () const
+            {
+                return height;
+            }
+
+            bool empty () const
+            {
+                return glyphs.empty ();
+            }
+
         };
 
     }
@@ -19,29 +19,69 @@
     #include <basics/Color_Buffer>
     #include <basics/Graphics_Context>
     #include <basics/Graphics_Resource>
+    #include <basics/Texture_Data>
 
     namespace basics
     {
 
+        class Texture_Loader;
+
         struct Texture_2D : public Graphics_Resource
         {
+
+            friend class Texture_Loader;
+
         public:
 
+            /**
+             * Criterio para elegir el formato de los píxeles en memoria de vídeo.
+             */
+            enum Format_Policy
+            {
+                KEEP_32_BIT,                            ///< Siempre Rgba8888.
+                PREFER_16_BIT,                          ///< Rgb565 si es opaca, Rgba5551 si el alfa es binario, si no Rgba8888.
+                FORCE_16_BIT                            ///< Como PREFER_16_BIT, pero usando Rgba4444 con alfas intermedios.
+            };
+
+            /**
+             * Indica si se conserva en memoria principal una copia de los píxeles tras subirlos a la GPU.
+             */
+            enum Pixel_Retention
+            {
+                KEEP_PIXELS,                            ///< La copia permite restaurar la textura al instante.
+                RELEASE_PIXELS                          ///< Se libera la copia y, si hace falta, se vuelve a decodificar el asset
+                                                        ///< o un PNG con los píxeles que se genera para las texturas sin asset.
+            };
+
+            /**
+             * Opciones de creación. Con {} se usan los valores por defecto: tamaño de la imagen,
+             * sin reducción y sin mipmaps.
+             */
             struct Options
             {
-                unsigned width;
+                unsigned width;                         ///< Tamaño lógico (el que se usa para dibujar).
                 unsigned height;
+                unsigned display_width;                 ///< Tamaño máximo en píxeles con el que se dibujará (0 = desconocido).
+                unsigned display_height;                ///< Si es menor que la imagen, esta se reduce antes de subirla.
+                bool     mipmaps;                       ///< Generar mipmaps y usar filtrado trilineal.
+                Format_Policy format_policy;            ///< Los formatos de 16 bits se generan con tramado ordenado.
+                Pixel_Retention pixel_retention;
             };
 
         public:
 
-            typedef std::shared_ptr< Texture_2D > (* Factory) (Id id, Color_Buffer< Rgba8888 > & color_buffer, const Options & options);
+            typedef std::shared_ptr< Texture_2D > (* Factory     ) (Id id, Color_Buffer< Rgba8888 > & color_buffer, const Options & options);
+            typedef std::shared_ptr< Texture_2D > (* Data_Factory) (Id id, Texture_Data & texture_data, const Options & options);
 
         private:
 
-            static Id      texture_2d_specialization_ids      [10];
-            static Factory texture_2d_specialization_factories[10];
-            static size_t  texture_2d_specialization_count;
+            static Id           texture_2d_specialization_ids      [10];
+            static Factory      texture_2d_specialization_factories[10];
+            static size_t       texture_2d_specialization_count;
+
+            static Id           texture_data_specialization_ids      [10];
+            static Data_Factory texture_data_specialization_factories[10];
+            static size_t       texture_data_specialization_count;
 
         public:
 
@@ -52,16 +92,82 @@
                 texture_2d_specialization_count++;
             }
 
+            /**
+             * Registra la factoría que crea texturas a partir de datos listos para la GPU (por ejemplo,
+             * comprimidos). La factoría debe retornar nullptr si el contexto no admite el formato.
+             */
+            static void register_factory (Id id, Data_Factory factory)
+            {
+                texture_data_specialization_ids      [texture_data_specialization_count] = id;
+                texture_data_specialization_factories[texture_data_specialization_count] = factory;
+                texture_data_specialization_count++;
+            }
+
         public:
 
             static std::shared_ptr< Texture_2D > create (Id id, Graphics_Context::Accessor & context, Color_Buffer< Rgba8888 > & color_buffer, const Options & options = {});
             static std::shared_ptr< Texture_2D > create (Id id, Graphics_Context::Accessor & context, const std::string & asset_path, const Options & options = {});
 
+            /**
+             * Crea una textura a partir de datos que pueden estar comprimidos. Si el contexto no
+             * admite su formato, el primer nivel se descomprime por CPU y se crea una textura RGBA.
+             */
+            static std::shared_ptr< Texture_2D > create (Id id, Graphics_Context::Accessor & context, Texture_Data & texture_data, const Options & options = {});
+
+            /**
+             * Reduce la imagen si es mayor de lo necesario para el tamaño de visualización indicado
+             * en las opciones. El tamaño lógico de la textura no cambia, por lo que las coordenadas
+             * de los slices y los tamaños de los sprites siguen siendo válidos.
+             */
+            static void fit_to_display (Color_Buffer< Rgba8888 > & color_buffer, const Options & options);
+
+            /**
+             * Convierte la imagen a un formato de 16 bits si la política lo permite.
+             * @return false si se debe mantener en Rgba8888.
+             */
+            static bool reduce_format (const Color_Buffer< Rgba8888 > & color_buffer, Format_Policy policy, Texture_Data & texture_data);
+
+            /**
+             * Lee y decodifica un asset aplicando las opciones (tamaño de visualización y formato).
+             * Los píxeles quedan en texture_data si el archivo es KTX o se han reducido a 16 bits y,
+             * si no, en color_buffer.
+             * @param options Recibe el tamaño lógico de la imagen si no se indicó.
+             */
+            static bool load (const std::string & asset_path, Options & options, Color_Buffer< Rgba8888 > & color_buffer, Texture_Data & texture_data);
+
+            /**
+             * Igual que load() pero a partir del contenido del asset ya leído. Usa la Texture_Cache
+             * si está habilitada.
+             */
+            static bool decode (const byte * data, size_t size, Options & options, Color_Buffer< Rgba8888 > & color_buffer, Texture_Data & texture_data);
+
+        private:
+
+            /**
+             * Crea la textura con los píxeles obtenidos con load() y recuerda su origen.
+             * @param options Opciones con las que se pidió la textura.
+             * @param image_options Opciones que ha completado load().
+             */
+            static std::shared_ptr< Texture_2D > create_loaded
+            (
+                Id id,
+                Graphics_Context::Accessor & context,
+                const std::string          & asset_path,
+                const Options              & options,
+                Options                      image_options,
+                Color_Buffer< Rgba8888 >   & color_buffer,
+                Texture_Data               & texture_data
+            );
+
         protected:
 
             float width;
             float height;
 
+            std::string         source_path;            ///< Asset del que se cargó la textura (si se cargó de uno).
+            Options             source_options;
+            std::vector< byte > source_blob;            ///< PNG con los píxeles de las texturas que no vienen de un asset.
+
         protected:
 
             Texture_2D(unsigned width, unsigned height)
@@ -87,6 +193,27 @@
                 return height;
             }
 
+            /**
+             * Indica si los píxeles se pueden volver a obtener después de liberar la copia en memoria.
+             */
+            bool can_reload () const
+            {
+                return !source_path.empty () || !source_blob.empty ();
+            }
+
+        protected:
+
+            /**
+             * Guarda una copia compacta (PNG) de los píxeles para poder liberarlos, salvo que la
+             * textura se pueda volver a cargar desde su asset.
+             */
+            bool prepare_release (const Color_Buffer< Rgba8888 > & color_buffer);
+
+            /**
+             * Vuelve a obtener los píxeles desde el asset o la copia compacta.
+             */
+            bool reload (Color_Buffer< Rgba8888 > & color_buffer, Texture_Data & texture_data) const;
+
         };
 
     }
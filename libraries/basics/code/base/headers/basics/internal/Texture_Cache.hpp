@@ -0,0 +1,112 @@
+/*
+ * TEXTURE CACHE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803271000
+ */
+
+#ifndef BASICS_TEXTURE_CACHE_HEADER
+#define BASICS_TEXTURE_CACHE_HEADER
+
+    #include <string>
+    #include <basics/Texture_2D>
+
+    namespace basics
+    {
+
+        /**
+         * Caché persistente de los píxeles de las texturas ya decodificados (reducidos y convertidos
+         * según las opciones) en un directorio privado de la aplicación. Mientras está habilitada,
+         * Texture_2D::decode() busca en ella antes de decodificar un PNG y, si no lo encuentra, guarda
+         * el resultado en segundo plano. Las entradas se identifican con el hash del contenido del
+         * asset y de las opciones que influyen en los píxeles, por lo que un asset modificado no
+         * puede recibir píxeles antiguos.
+         */
+        class Texture_Cache : Non_Instantiable
+        {
+        public:
+
+            /**
+             * Cabecera de cada archivo de la caché. Los píxeles se guardan a continuación.
+             */
+            struct Header
+            {
+                char     magic[8];                      ///< "BASICSTC"
+                uint32_t version;
+                uint32_t format;                        ///< Texture_Data::Format (RGBA8888 si van en un Color_Buffer).
+                uint64_t key;
+                uint32_t width;                         ///< Tamaño lógico de la textura.
+                uint32_t height;
+                uint32_t pixel_width;                   ///< Tamaño de la imagen guardada.
+                uint32_t pixel_height;
+                uint64_t data_size;
+            };
+
+            static const uint32_t version = 1;
+
+            struct Statistics
+            {
+                unsigned hits;
+                unsigned misses;
+                unsigned writes;
+            };
+
+        public:
+
+            /**
+             * Habilita la caché en el directorio indicado (que se crea si no existe).
+             * @param directory Con una ruta vacía se usa el subdirectorio "textures" de la ruta
+             *     que indica application.get_storage_path().
+             * @return false si no hay un directorio en el que se pueda escribir.
+             */
+            static bool enable (const std::string & directory = std::string());
+
+            /**
+             * Deshabilita la caché después de terminar de escribir las entradas pendientes.
+             */
+            static void disable ();
+
+            static bool is_enabled ();
+
+            /**
+             * Borra todos los archivos de la caché.
+             */
+            static void clear ();
+
+            /**
+             * Bloquea el hilo que la llama hasta que se han escrito las entradas pendientes.
+             */
+            static void flush ();
+
+            static Statistics get_statistics ();
+
+        public:
+
+            /**
+             * Calcula la clave de la entrada que corresponde a un asset decodificado con unas opciones.
+             */
+            static uint64_t make_key (const byte * data, size_t size, const Texture_2D::Options & options);
+
+            /**
+             * Busca una entrada y, si existe y es válida, copia sus píxeles desde el archivo proyectado
+             * en memoria del mismo modo que lo haría Texture_2D::decode().
+             * @param options Recibe el tamaño lógico de la textura guardado con los píxeles.
+             */
+            static bool find (uint64_t key, Texture_2D::Options & options, Color_Buffer< Rgba8888 > & color_buffer, Texture_Data & texture_data);
+
+            /**
+             * Encarga la escritura de una entrada con el resultado de Texture_2D::decode(). La copia de
+             * los píxeles se hace antes de retornar, por lo que se pueden liberar enseguida.
+             */
+            static void store (uint64_t key, const Texture_2D::Options & options, const Color_Buffer< Rgba8888 > & color_buffer, const Texture_Data & texture_data);
+
+        };
+
+    }
+
+#endif
@@ -0,0 +1,116 @@
+/*
+ * TEXTURE DATA
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803161000
+ */
+
+#ifndef BASICS_TEXTURE_DATA_HEADER
+#define BASICS_TEXTURE_DATA_HEADER
+
+    #include <vector>
+    #include <basics/types>
+
+    namespace basics
+    {
+
+        /**
+         * Imagen lista para subir a la GPU tal cual, posiblemente comprimida por bloques y con su
+         * cadena de mipmaps precalculada (por ejemplo, la que se obtiene de un archivo KTX).
+         */
+        struct Texture_Data
+        {
+
+            enum Format
+            {
+                RGBA8888,                               ///< Sin comprimir, 4 bytes por píxel.
+                RGB565,                                 ///< Sin comprimir, 2 bytes por píxel (GL_UNSIGNED_SHORT_5_6_5).
+                RGBA4444,                               ///< Sin comprimir, 2 bytes por píxel (GL_UNSIGNED_SHORT_4_4_4_4).
+                RGBA5551,                               ///< Sin comprimir, 2 bytes por píxel (GL_UNSIGNED_SHORT_5_5_5_1).
+                ETC1_RGB8,                              ///< GL_ETC1_RGB8_OES, 4 bits por píxel, sin alfa.
+                ETC2_RGB8,                              ///< GL_COMPRESSED_RGB8_ETC2, 4 bits por píxel, sin alfa.
+                ETC2_RGB8A1,                            ///< GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2, 4 bits por píxel, alfa de 1 bit.
+                ETC2_RGBA8                              ///< GL_COMPRESSED_RGBA8_ETC2_EAC, 8 bits por píxel.
+            };
+
+            struct Level
+            {
+                unsigned            width;
+                unsigned            height;
+                std::vector< byte > data;
+            };
+
+            Format                format;
+            std::vector< Level >  levels;               ///< El nivel 0 es la imagen completa.
+
+        public:
+
+            Texture_Data() : format(RGBA8888)
+            {
+            }
+
+        public:
+
+            unsigned get_width () const
+            {
+                return levels.empty () ? 0 : levels.front ().width;
+            }
+
+            unsigned get_height () const
+            {
+                return levels.empty () ? 0 : levels.front ().height;
+            }
+
+            /**
+             * Indica si los datos están comprimidos por bloques (los formatos ETC).
+             */
+            bool is_compressed () const
+            {
+                return format >= ETC1_RGB8;
+            }
+
+            bool is_16_bit () const
+            {
+                return format == RGB565 || format == RGBA4444 || format == RGBA5551;
+            }
+
+            /**
+             * Retorna el número de bytes que ocupa un nivel con el formato indicado.
+             */
+            static size_t get_level_size (Format format, unsigned width, unsigned height)
+            {
+                size_t blocks = size_t((width + 3) / 4) * ((height + 3) / 4);
+
+                switch (format)
+                {
+                    case RGBA8888:   return size_t(width) * height * 4;
+                    case RGB565:
+                    case RGBA4444:
+                    case RGBA5551:   return size_t(width) * height * 2;
+                    case ETC2_RGBA8: return blocks * 16;
+                    default:         return blocks *  8;
+                }
+            }
+
+            /**
+             * Retorna el número total de bytes de todos los niveles.
+             */
+            size_t get_size () const
+            {
+                size_t size = 0;
+
+                for (auto & level : levels) size += level.data.size ();
+
+                return size;
+            }
+
+        };
+
+    }
+
+#endif
@@ -0,0 +1,200 @@
+/*
+ * TEXTURE LOADER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803201030
+ */
+
+#ifndef BASICS_TEXTURE_LOADER_HEADER
+#define BASICS_TEXTURE_LOADER_HEADER
+
+    #include <atomic>
+    #include <deque>
+    #include <functional>
+    #include <memory>
+    #include <mutex>
+    #include <string>
+    #include <basics/Asset_Reader>
+    #include <basics/Graphics_Context>
+    #include <basics/Texture_2D>
+    #include <basics/Thread_Pool>
+
+    namespace basics
+    {
+
+        /**
+         * Carga texturas de forma asíncrona: los assets se leen por lotes con un Asset_Reader, su
+         * decodificación se reparte entre los hilos de un Thread_Pool y la subida a la GPU se hace en
+         * el hilo del contexto gráfico llamando a upload() en cada fotograma con un presupuesto de
+         * tiempo. Las texturas se comparten a través de Texture_Registry, por lo que las que ya están
+         * cargadas con las mismas opciones se entregan sin leerlas ni decodificarlas.
+         */
+        class Texture_Loader : Non_Copyable
+        {
+        public:
+
+            class Task;
+
+            typedef std::shared_ptr< Task >                Handle;
+            typedef std::function< void (const Task & ) >  Callback;
+
+            /**
+             * Estado de una textura solicitada. Se conserva mediante un Handle.
+             */
+            class Task
+            {
+
+                friend class Texture_Loader;
+
+                enum State
+                {
+                    DECODING,
+                    DECODED,
+                    READY,
+                    FAILED
+                };
+
+                Id                            id;
+                std::string                   asset_path;
+                Texture_2D::Options           options;
+                Texture_2D::Options           image_options;
+                Color_Buffer< Rgba8888 >      color_buffer;
+                Texture_Data                  texture_data;
+                std::shared_ptr< Texture_2D > texture;
+                Callback                      callback;
+                std::atomic< int >            state;
+                bool                          finished;     ///< true cuando upload() ya la ha entregado.
+
+            public:
+
+                Task(Id id, const std::string & asset_path, const Texture_2D::Options & options, const Callback & callback)
+                :
+                    id           (id        ),
+                    asset_path   (asset_path),
+                    options      (options   ),
+                    image_options(options   ),
+                    callback     (callback  ),
+                    state        (DECODING  ),
+                    finished     (false     )
+                {
+                }
+
+            public:
+
+                Id get_id () const
+                {
+                    return id;
+                }
+
+                const std::string & get_asset_path () const
+                {
+                    return asset_path;
+                }
+
+                bool is_done () const
+                {
+                    return state >= READY;
+                }
+
+                bool is_ready () const
+                {
+                    return state == READY;
+                }
+
+                bool has_failed () const
+                {
+                    return state == FAILED;
+                }
+
+                /**
+                 * Retorna la textura una vez que is_ready() es true (nullptr mientras tanto).
+                 */
+                const std::shared_ptr< Texture_2D > & get_texture () const
+                {
+                    return texture;
+                }
+
+            };
+
+        private:
+
+            std::deque< Handle > decoded;               ///< Tareas que esperan a que upload() las suba.
+            std::mutex           mutex;
+            std::atomic< int >   pending_count;         ///< Tareas solicitadas que todavía no han terminado.
+
+            Thread_Pool          thread_pool;           ///< Se destruye después del lector para que este no le encargue tareas.
+            Asset_Reader         asset_reader;          ///< Se destruye el primero porque sus lecturas encargan decodificaciones.
+
+        public:
+
+            /**
+             * @param thread_count Número de hilos de decodificación (0 para elegirlo según los núcleos).
+             */
+            Texture_Loader(unsigned thread_count = 0)
+            :
+                pending_count(0),
+                thread_pool  (thread_count),
+                asset_reader (thread_count)
+            {
+            }
+
+        public:
+
+            /**
+             * Encarga la carga de una textura. Se puede llamar desde cualquier hilo.
+             * @param callback Se llama desde upload() cuando la textura está lista o ha fallado.
+             */
+            Handle load (Id id, const std::string & asset_path, const Texture_2D::Options & options = {}, const Callback & callback = nullptr);
+
+            /**
+             * Lector con el que se leen los assets. Se puede usar para sugerir lecturas anticipadas
+             * de los assets que se van a cargar más adelante.
+             */
+            Asset_Reader & get_asset_reader ()
+            {
+                return asset_reader;
+            }
+
+            /**
+             * Sube a la GPU las texturas decodificadas hasta agotar el presupuesto de tiempo (al menos
+             * sube una si hay alguna esperando), las añade al contexto sin que este las retenga y las
+             * registra en Texture_Registry. Se debe llamar desde el hilo del contexto gráfico.
+             * @return Número de tareas terminadas en la llamada.
+             */
+            unsigned upload (Graphics_Context::Accessor & context, float budget_in_milliseconds = 4.f);
+
+            /**
+             * Sube a la GPU una textura concreta si ya está decodificada, sin esperar su turno. Permite
+             * que quien reparte el trabajo de carga entre fotogramas (como Loading_Scheduler) decida
+             * cuándo se sube cada textura.
+             * @return true si la tarea se ha entregado (ahora o antes) y false si todavía no se puede.
+             */
+            bool upload (Graphics_Context::Accessor & context, const Handle & task);
+
+            /**
+             * Retorna el número de texturas solicitadas que todavía no están listas.
+             */
+            unsigned get_pending_count () const
+            {
+                return unsigned(pending_count);
+            }
+
+            bool is_idle () const
+            {
+                return pending_count == 0;
+            }
+
+        private:
+
+            void finish (Graphics_Context::Accessor & context, const Handle & task);
+
+        };
+
+    }
+
+#endif
@@ -0,0 +1,77 @@
+/*
+ * TEXTURE REGISTRY
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803311000
+ */
+
+#ifndef BASICS_TEXTURE_REGISTRY_HEADER
+#define BASICS_TEXTURE_REGISTRY_HEADER
+
+    #include <memory>
+    #include <string>
+    #include <basics/Graphics_Context>
+    #include <basics/Texture_2D>
+
+    namespace basics
+    {
+
+        /**
+         * Comparte las texturas cargadas de un mismo asset con las mismas opciones. Solo guarda
+         * referencias weak, por lo que una textura sigue viva (también de una escena a la siguiente)
+         * mientras alguien conserve un handle y se destruye, liberando su memoria de vídeo, al soltar
+         * el último. Para ello las texturas se añaden al contexto con Graphics_Context::attach(), que
+         * no las retiene. Las texturas pertenecen al contexto con el que se crearon.
+         */
+        class Texture_Registry : Non_Instantiable
+        {
+        public:
+
+            typedef std::shared_ptr< Texture_2D > Handle;
+
+            struct Statistics
+            {
+                unsigned loads;                         ///< Texturas creadas al no haber una registrada.
+                unsigned duplicates;                    ///< Peticiones atendidas con una textura registrada.
+                size_t   bytes_saved;                   ///< Memoria de vídeo que habrían ocupado las duplicadas.
+            };
+
+        public:
+
+            /**
+             * Retorna la textura registrada con esa ruta y esas opciones o, si no la hay, la carga,
+             * la añade al contexto y la registra.
+             * @param id Id que recibe la textura si se crea (las compartidas conservan el suyo).
+             */
+            static Handle acquire (Id id, Graphics_Context::Accessor & context, const std::string & asset_path, const Texture_2D::Options & options = {});
+
+            /**
+             * Retorna la textura registrada con esa ruta y esas opciones (nullptr si no la hay).
+             */
+            static Handle find (const std::string & asset_path, const Texture_2D::Options & options = {});
+
+            /**
+             * Registra una textura creada fuera del registro (por ejemplo, por Texture_Loader). Si
+             * mientras tanto se ha registrado otra con la misma ruta y opciones, se retorna esa.
+             */
+            static Handle add (const std::string & asset_path, const Texture_2D::Options & options, const Handle & texture);
+
+            /**
+             * Retorna el número de texturas registradas que siguen vivas.
+             */
+            static unsigned get_count ();
+
+            static Statistics get_statistics ();
+
+            static void reset_statistics ();
+
+        };
+
+    }
+
+#endif
@@ -0,0 +1,83 @@
+/*
+ * THREAD POOL
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803201000
+ */
+
+#ifndef BASICS_THREAD_POOL_HEADER
+#define BASICS_THREAD_POOL_HEADER
+
+    #include <condition_variable>
+    #include <deque>
+    #include <functional>
+    #include <mutex>
+    #include <thread>
+    #include <vector>
+    #include <basics/Non_Copyable>
+
+    namespace basics
+    {
+
+        /**
+         * Conjunto de hilos que ejecutan en orden de llegada las tareas que se les encargan. Está
+         * pensado para trabajos que no deben bloquear el hilo del contexto gráfico (como decodificar
+         * imágenes), por lo que las tareas no pueden usar el contexto.
+         */
+        class Thread_Pool : Non_Copyable
+        {
+        public:
+
+            typedef std::function< void () > Task;
+
+        private:
+
+            std::vector< std::thread > threads;
+            std::deque < Task        > tasks;
+            std::mutex                 mutex;
+            std::condition_variable    task_available;
+            std::condition_variable    idle;
+            unsigned                   busy_count;
+            bool                       stopping;
+
+        public:
+
+            /**
+             * @param thread_count Número de hilos. Con 0 se usa uno menos que el número de núcleos
+             *     (dejando uno para el hilo principal), con un mínimo de 1.
+             */
+            Thread_Pool(unsigned thread_count = 0);
+
+            /**
+             * Descarta las tareas que no han empezado y espera a que terminen las que están en curso.
+             */
+           ~Thread_Pool();
+
+        public:
+
+            void submit (const Task & task);
+
+            /**
+             * Bloquea el hilo que la llama hasta que no quedan tareas pendientes ni en curso.
+             */
+            void wait_idle ();
+
+            unsigned get_thread_count () const
+            {
+                return unsigned(threads.size ());
+            }
+
+        private:
+
+            void run ();
+
+        };
+
+    }
+
+#endif
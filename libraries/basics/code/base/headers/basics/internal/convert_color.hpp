@@ -0,0 +1,82 @@
+/*
+ * CONVERT COLOR
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803171000
+ */
+
+#ifndef BASICS_CONVERT_COLOR_HEADER
+#define BASICS_CONVERT_COLOR_HEADER
+
+    #include <basics/Color_Buffer>
+
+    namespace basics
+    {
+
+        /**
+         * Describe un formato de color empaquetado en 16 bits con los componentes en el orden
+         * R, G, B, A desde los bits más significativos (el orden de GL_UNSIGNED_SHORT_5_6_5,
+         * GL_UNSIGNED_SHORT_4_4_4_4 y GL_UNSIGNED_SHORT_5_5_5_1).
+         */
+        template< unsigned RED_BITS, unsigned GREEN_BITS, unsigned BLUE_BITS, unsigned ALPHA_BITS >
+        struct Packed_Format
+        {
+            typedef uint16_t Color;
+
+            static constexpr unsigned red_bits    = RED_BITS;
+            static constexpr unsigned green_bits  = GREEN_BITS;
+            static constexpr unsigned blue_bits   = BLUE_BITS;
+            static constexpr unsigned alpha_bits  = ALPHA_BITS;
+
+            static constexpr unsigned alpha_shift = 0;
+            static constexpr unsigned blue_shift  = ALPHA_BITS;
+            static constexpr unsigned green_shift = ALPHA_BITS + BLUE_BITS;
+            static constexpr unsigned red_shift   = ALPHA_BITS + BLUE_BITS + GREEN_BITS;
+
+            static_assert (RED_BITS + GREEN_BITS + BLUE_BITS + ALPHA_BITS == 16, "Packed_Format must use 16 bits.");
+        };
+
+        typedef Packed_Format< 5, 6, 5, 0 > Rgb565_Format;
+        typedef Packed_Format< 4, 4, 4, 4 > Rgba4444_Format;
+        typedef Packed_Format< 5, 5, 5, 1 > Rgba5551_Format;
+
+        enum class Dithering
+        {
+            NONE,                                       ///< Redondeo al valor más cercano.
+            ORDERED,                                    ///< Matriz de Bayer de 4x4 (vectorizado con SSE2 o NEON).
+            ERROR_DIFFUSION                             ///< Floyd-Steinberg (más calidad, pero secuencial).
+        };
+
+        /**
+         * Reduce una imagen Rgba8888 a un formato de 16 bits aplicando el tramado indicado para
+         * disimular las bandas de color.
+         */
+        template< class FORMAT >
+        void convert (const Color_Buffer< Rgba8888 > & source, Color_Buffer< typename FORMAT::Color > & target, Dithering dithering);
+
+        /**
+         * Expande una imagen de 16 bits a Rgba8888 (replicando los bits altos en los bajos).
+         */
+        template< class FORMAT >
+        void convert (const Color_Buffer< typename FORMAT::Color > & source, Color_Buffer< Rgba8888 > & target);
+
+        /**
+         * Resultado del análisis del canal alfa de una imagen.
+         */
+        enum class Alpha_Usage
+        {
+            OPAQUE,                                     ///< Todos los píxeles tienen alfa 255.
+            BINARY,                                     ///< Solo hay píxeles opacos y totalmente transparentes.
+            TRANSLUCENT                                 ///< Hay valores de alfa intermedios.
+        };
+
+        Alpha_Usage analyze_alpha (const Color_Buffer< Rgba8888 > & color_buffer);
+
+    }
+
+#endif
@@ -0,0 +1,34 @@
+/*
+ * ETC DECODE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803161000
+ */
+
+#ifndef BASICS_ETC_DECODE_HEADER
+#define BASICS_ETC_DECODE_HEADER
+
+    #include <basics/Color_Buffer>
+    #include <basics/Texture_Data>
+
+    namespace basics
+    {
+
+        /**
+         * Descomprime por CPU un nivel de una textura ETC1/ETC2/EAC (o lo convierte a Rgba8888 si no
+         * está comprimido). Se usa cuando la GPU no admite el formato y en los contextos por software.
+         * @param texture_data Datos de la textura.
+         * @param level Índice del nivel que se quiere descomprimir.
+         * @param color_buffer Recibe los píxeles descomprimidos.
+         * @return false si el nivel no existe o sus datos están incompletos.
+         */
+        bool etc_decode (const Texture_Data & texture_data, unsigned level, Color_Buffer< Rgba8888 > & color_buffer);
+
+    }
+
+#endif
@@ -125,6 +125,46 @@
             return hash;
         }
 
+        inline uint64_t fnv64 (const std::string & s)
+        {
+            uint64_t hash = internal::fnv_basis_64;
+
+            for (auto c : s)
+            {
+                hash ^= uint8_t(c);
+                hash *= internal::fnv_prime_64;
+            }
+
+            return hash;
+        }
+
+        inline uint64_t fnv64 (const void * data, size_t size)
+        {
+            const uint8_t * bytes = reinterpret_cast< const uint8_t * >(data);
+            uint64_t        hash  = internal::fnv_basis_64;
+
+            for (size_t index = 0; index < size; ++index)
+            {
+                hash ^= bytes[index];
+                hash *= internal::fnv_prime_64;
+            }
+
+            return hash;
+        }
+
+        inline uint32_t fnv32 (const std::wstring & s)
+        {
+            uint32_t hash = internal::fnv_basis_32;
+
+            for (auto c : s)
+            {
+                hash ^= uint32_t(c);
+                hash *= internal::fnv_prime_32;
+            }
+
+            return hash;
+        }
+
     }
 
     constexpr unsigned operator "" _fnv (const char * c)
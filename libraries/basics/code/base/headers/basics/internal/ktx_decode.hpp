@@ -0,0 +1,46 @@
+/*
+ * KTX DECODE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803161000
+ */
+
+#ifndef BASICS_KTX_DECODE_HEADER
+#define BASICS_KTX_DECODE_HEADER
+
+    #include <vector>
+    #include <basics/Texture_Data>
+
+    namespace basics
+    {
+
+        /**
+         * Comprueba si los datos empiezan con el identificador de un archivo KTX 1.1.
+         */
+        bool is_ktx (const byte * encoded_data, size_t size);
+
+        inline bool is_ktx (const std::vector< byte > & encoded_data)
+        {
+            return is_ktx (encoded_data.data (), encoded_data.size ());
+        }
+
+        /**
+         * Extrae los niveles de una textura 2D de un archivo KTX 1.1. Se admiten los formatos de
+         * Texture_Data::Format (ETC1, ETC2, EAC y RGBA sin comprimir de 16 o 32 bits).
+         * @return false si el archivo no es válido o su formato no está soportado.
+         */
+        bool ktx_decode (const byte * encoded_data, size_t size, Texture_Data & texture_data);
+
+        inline bool ktx_decode (const std::vector< byte > & encoded_data, Texture_Data & texture_data)
+        {
+            return ktx_decode (encoded_data.data (), encoded_data.size (), texture_data);
+        }
+
+    }
+
+#endif
@@ -0,0 +1,39 @@
+/*
+ * LZ4
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803251000
+ */
+
+#ifndef BASICS_LZ4_HEADER
+#define BASICS_LZ4_HEADER
+
+    #include <vector>
+    #include <basics/types>
+
+    namespace basics
+    {
+
+        /**
+         * Comprime datos con el formato de bloque de LZ4 (sin la cabecera del formato de frame). Es
+         * una compresión rápida y sencilla (búsqueda voraz con una tabla hash) pensada para las
+         * herramientas que preparan los assets, donde lo importante es que descomprimir sea barato.
+         * @param compressed_data Recibe los datos comprimidos.
+         */
+        void lz4_compress (const byte * data, size_t size, std::vector< byte > & compressed_data);
+
+        /**
+         * Descomprime un bloque LZ4 comprobando que ninguna referencia sale de los datos.
+         * @param decompressed_size Tamaño exacto que deben tener los datos descomprimidos.
+         * @return false si los datos no son válidos o no tienen el tamaño indicado.
+         */
+        bool lz4_decompress (const byte * compressed_data, size_t size, byte * decompressed_data, size_t decompressed_size);
+
+    }
+
+#endif
@@ -244,6 +244,28 @@
 
     #endif
 
+   /* --------------------------------------------------------------------------------------------- +
+                        Detect the SIMD instruction sets enabled for the target
+    + --------------------------------------------------------------------------------------------- */
+
+    #if defined(__SSE2__) || defined(BASICS_AMD64_ARCHITECTURE) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+
+        #define BASICS_SSE2_ENABLED
+
+    #endif
+
+    #if defined(__AVX2__)
+
+        #define BASICS_AVX2_ENABLED
+
+    #endif
+
+    #if defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+        #define BASICS_NEON_ENABLED
+
+    #endif
+
    /* --------------------------------------------------------------------------------------------- +
                  Detect if the build must be optimized and define NDEBUG if appropriate
     + --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,56 @@
+/*
+ * RESAMPLE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803151000
+ */
+
+#ifndef BASICS_RESAMPLE_HEADER
+#define BASICS_RESAMPLE_HEADER
+
+    #include <basics/Color_Buffer>
+
+    namespace basics
+    {
+
+        /**
+         * Reduce una imagen promediando el área de la imagen original que cubre cada píxel (filtro
+         * de caja). Los colores se ponderan con su alfa para que los bordes transparentes no se
+         * oscurezcan.
+         * @param source Imagen original.
+         * @param target Recibe la imagen reducida.
+         * @param width Ancho de destino (no mayor que el de origen).
+         * @param height Alto de destino (no mayor que el de origen).
+         * @return false si el tamaño de destino no es válido.
+         */
+        bool downscale (const Color_Buffer< Rgba8888 > & source, Color_Buffer< Rgba8888 > & target, unsigned width, unsigned height);
+
+        /**
+         * Reduce una imagen a la mitad en cada dimensión promediando bloques de 2x2 píxeles (igual
+         * que glGenerateMipmap, sin ponderar por alfa). Usa SSE2 o NEON cuando están disponibles,
+         * por lo que es mucho más rápida que downscale() para reducciones grandes.
+         */
+        void halve (const Color_Buffer< Rgba8888 > & source, Color_Buffer< Rgba8888 > & target);
+
+        /**
+         * Multiplica los componentes de color de cada píxel por su alfa (para mezclar con GL_ONE,
+         * GL_ONE_MINUS_SRC_ALPHA).
+         */
+        void premultiply_alpha (Color_Buffer< Rgba8888 > & color_buffer);
+
+        /**
+         * Copia una imagen dentro de otra mayor replicando sus píxeles de borde alrededor, lo que
+         * evita que el filtrado bilineal mezcle imágenes vecinas dentro de un atlas.
+         * @param left Columna de destino del primer píxel de la imagen (debe haber extrusion columnas libres a su izquierda).
+         * @param top Fila de destino del primer píxel de la imagen (debe haber extrusion filas libres encima).
+         */
+        void copy_extruded (const Color_Buffer< Rgba8888 > & source, Color_Buffer< Rgba8888 > & target, unsigned left, unsigned top, unsigned extrusion);
+
+    }
+
+#endif
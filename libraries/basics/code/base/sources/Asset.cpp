@@ -0,0 +1,42 @@
+/*
+ * ASSET
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803231000
+ */
+
+#include <basics/Asset>
+
+namespace basics
+{
+
+    Asset::Mapping Asset::map (const std::string & path)
+    {
+        std::shared_ptr< Asset > asset = open (path);
+
+        if (asset)
+        {
+            // Si el asset ya está en memoria, el Mapping lo mantiene abierto mientras se usa:
+
+            if (const byte * buffer = asset->get_buffer ())
+            {
+                return Mapping(buffer, asset->size (), asset);
+            }
+
+            std::shared_ptr< std::vector< byte > > copy = std::make_shared< std::vector< byte > > ();
+
+            if (asset->read_all (*copy))
+            {
+                return Mapping(copy->data (), copy->size (), copy);
+            }
+        }
+
+        return Mapping();
+    }
+
+}
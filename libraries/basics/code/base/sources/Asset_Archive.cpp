@@ -0,0 +1,383 @@
+/*
+ * ASSET ARCHIVE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803251010
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <vector>
+#include <basics/Asset_Archive>
+#include <basics/lz4>
+
+namespace basics
+{
+
+    namespace
+    {
+
+        /**
+         * Asset de solo lectura cuyos datos ya están en memoria (en la proyección del archivo o en
+         * el buffer en el que se ha descomprimido). El Mapping los mantiene vivos.
+         */
+        class Memory_Asset final : public Asset
+        {
+
+            Asset::Mapping mapping;
+            const byte   * data;
+            size_t         data_size;
+            size_t         cursor;
+            bool           at_end;
+
+        public:
+
+            Memory_Asset(const Asset::Mapping & mapping, const byte * data, size_t size)
+            :
+                mapping  (mapping),
+                data     (data),
+                data_size(size),
+                cursor   (0),
+                at_end   (false)
+            {
+            }
+
+        public:
+
+            bool   good () const override { return true;      }
+            bool   fail () const override { return false;     }
+            bool   eof  () const override { return at_end;    }
+            size_t size () const override { return data_size; }
+            size_t tell () const override { return cursor;    }
+
+            bool seek (ptrdiff_t offset, Anchor anchor) override
+            {
+                ptrdiff_t base       = anchor == BEGINNING ? 0 : anchor == END ? ptrdiff_t(data_size) : ptrdiff_t(cursor);
+                ptrdiff_t new_offset = base + offset;
+
+                if (new_offset >= 0 && size_t(new_offset) <= data_size)
+                {
+                    cursor = size_t(new_offset);
+                    at_end = false;
+
+                    return true;
+                }
+
+                return false;
+            }
+
+            byte read () override
+            {
+                if (cursor < data_size)
+                {
+                    return data[cursor++];
+                }
+
+                at_end = true;
+
+                return 0;
+            }
+
+            bool read_all (std::vector< byte > & buffer) override
+            {
+                buffer.assign (data, data + data_size);
+                cursor = data_size;
+
+                return true;
+            }
+
+            bool read_all (std::string & buffer) override
+            {
+                buffer.assign (reinterpret_cast< const char * >(data), data_size);
+                cursor = data_size;
+
+                return true;
+            }
+
+            size_t read_at (size_t offset, byte * buffer, size_t size) override
+            {
+                if (offset >= data_size) return 0;
+
+                size = std::min (size, data_size - offset);
+
+                std::memcpy (buffer, data + offset, size);
+
+                return size;
+            }
+
+            const byte * get_buffer () override
+            {
+                return data;
+            }
+
+        };
+
+        typedef std::vector< std::shared_ptr< Asset_Archive > > Archive_List;
+
+        /**
+         * La lista de archivos montados no se modifica: montar crea una lista nueva. Así, para buscar
+         * un asset solo hay que bloquear el mutex mientras se copia el puntero a la lista actual.
+         */
+        struct Mounted_Archives
+        {
+            std::mutex                            mutex;
+            std::shared_ptr< const Archive_List > archives;
+        };
+
+        Mounted_Archives & mounted_archives ()
+        {
+            static Mounted_Archives mounted_archives;
+
+            return mounted_archives;
+        }
+
+        std::shared_ptr< const Archive_List > get_mounted_archives ()
+        {
+            Mounted_Archives & mounted = mounted_archives ();
+
+            std::lock_guard< std::mutex > lock(mounted.mutex);
+
+            return mounted.archives;
+        }
+
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    std::shared_ptr< Asset_Archive > Asset_Archive::load (const std::string & path)
+    {
+        Asset::Mapping mapping = Asset::map (path);
+
+        if (mapping.good ())
+        {
+            std::shared_ptr< Asset_Archive > archive = std::make_shared< Asset_Archive > (mapping);
+
+            if (archive->good ())
+            {
+                return archive;
+            }
+        }
+
+        return nullptr;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Asset_Archive::mount (const std::string & path)
+    {
+        std::shared_ptr< Asset_Archive > archive = load (path);
+
+        if (archive)
+        {
+            Mounted_Archives & mounted = mounted_archives ();
+
+            std::lock_guard< std::mutex > lock(mounted.mutex);
+
+            std::shared_ptr< Archive_List > archives = mounted.archives
+                ? std::make_shared< Archive_List > (*mounted.archives)
+                : std::make_shared< Archive_List > ();
+
+            archives->push_back (archive);
+
+            mounted.archives = archives;
+
+            return true;
+        }
+
+        return false;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Asset_Archive::unmount_all ()
+    {
+        Mounted_Archives & mounted = mounted_archives ();
+
+        std::lock_guard< std::mutex > lock(mounted.mutex);
+
+        mounted.archives.reset ();
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    std::shared_ptr< Asset > Asset_Archive::open_mounted (const std::string & path)
+    {
+        std::shared_ptr< const Archive_List > archives = get_mounted_archives ();
+
+        if (archives)
+        {
+            for (auto archive = archives->rbegin (); archive != archives->rend (); ++archive)
+            {
+                if ((*archive)->find (path))
+                {
+                    return (*archive)->open (path);
+                }
+            }
+        }
+
+        return nullptr;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Asset_Archive::find_mounted (const std::string & path, size_t & size)
+    {
+        std::shared_ptr< const Archive_List > archives = get_mounted_archives ();
+
+        if (archives)
+        {
+            for (auto archive = archives->rbegin (); archive != archives->rend (); ++archive)
+            {
+                if (const Entry * entry = (*archive)->find (path))
+                {
+                    size = size_t(entry->size);
+
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Asset_Archive::Asset_Archive(const Asset::Mapping & mapping)
+    :
+        mapping(mapping),
+        header (nullptr),
+        entries(nullptr),
+        names  (nullptr)
+    {
+        if (!validate ())
+        {
+            header  = nullptr;
+            entries = nullptr;
+            names   = nullptr;
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Asset_Archive::validate ()
+    {
+        const byte * data = mapping.get_data ();
+        size_t       size = mapping.get_size ();
+
+        if (size < sizeof(Header))
+        {
+            return false;
+        }
+
+        header = reinterpret_cast< const Header * >(data);
+
+        if (std::memcmp (header->magic, "BASICSPK", 8) != 0 || header->version != version)
+        {
+            return false;
+        }
+
+        if
+        (
+            header->index_offset > size || header->entry_count > (size - header->index_offset) / sizeof(Entry) ||
+            header->names_offset > size || header->index_offset % alignof(Entry) != 0
+        )
+        {
+            return false;
+        }
+
+        entries = reinterpret_cast< const Entry * >(data + header->index_offset);
+        names   = reinterpret_cast< const char  * >(data + header->names_offset);
+
+        // Se comprueban todas las entradas al abrir el archivo para no tener que hacerlo al buscar:
+
+        size_t names_size = size - header->names_offset;
+
+        for (uint32_t index = 0; index < header->entry_count; ++index)
+        {
+            const Entry & entry = entries[index];
+
+            if
+            (
+                (index > 0 && entries[index - 1].hash > entry.hash) ||
+                entry.name_offset > names_size || entry.name_length > names_size - entry.name_offset ||
+                entry.offset > size || entry.stored_size > size - entry.offset ||
+                (entry.compression == UNCOMPRESSED && entry.stored_size != entry.size) ||
+                (entry.compression != UNCOMPRESSED && entry.compression != LZ4)
+            )
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    const Asset_Archive::Entry * Asset_Archive::find (const std::string & path) const
+    {
+        if (!good ())
+        {
+            return nullptr;
+        }
+
+        uint32_t      hash  = Asset_Archive::hash (path);
+        const Entry * end   = entries + header->entry_count;
+        const Entry * entry = std::lower_bound
+        (
+            entries, end, hash, [] (const Entry & entry, uint32_t hash) { return entry.hash < hash; }
+        );
+
+        for ( ; entry != end && entry->hash == hash; ++entry)
+        {
+            if (entry->name_length == path.size () && std::memcmp (names + entry->name_offset, path.data (), path.size ()) == 0)
+            {
+                return entry;
+            }
+        }
+
+        return nullptr;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    std::shared_ptr< Asset > Asset_Archive::open (const std::string & path) const
+    {
+        const Entry * entry = find (path);
+
+        if (!entry)
+        {
+            return nullptr;
+        }
+
+        const byte * stored_data = mapping.get_data () + entry->offset;
+
+        if (entry->compression == UNCOMPRESSED)
+        {
+            return std::make_shared< Memory_Asset > (mapping, stored_data, size_t(entry->size));
+        }
+
+        // Los assets comprimidos se descomprimen al abrirlos en un buffer que pertenece al Asset:
+
+        std::shared_ptr< std::vector< byte > > decompressed = std::make_shared< std::vector< byte > > (size_t(entry->size));
+
+        if (lz4_decompress (stored_data, size_t(entry->stored_size), decompressed->data (), decompressed->size ()))
+        {
+            return std::make_shared< Memory_Asset >
+            (
+                Asset::Mapping(decompressed->data (), decompressed->size (), decompressed),
+                decompressed->data (),
+                decompressed->size ()
+            );
+        }
+
+        return nullptr;
+    }
+
+}
@@ -0,0 +1,169 @@
+/*
+ * ASSET MANIFEST
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803301000
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <basics/Asset>
+#include <basics/Asset_Manifest>
+#include <basics/fnv>
+
+using namespace std;
+
+namespace basics
+{
+
+    namespace
+    {
+
+        bool ends_with (const string & text, const char * suffix)
+        {
+            size_t length = std::strlen (suffix);
+
+            return text.size () > length && text.compare (text.size () - length, length, suffix) == 0;
+        }
+
+        /**
+         * Convierte un tamaño como "1500", "64K" o "2M" a bytes.
+         * @return false si el texto no es un tamaño.
+         */
+        bool parse_size (const string & text, size_t & size)
+        {
+            char * end;
+
+            unsigned long value = std::strtoul (text.c_str (), &end, 10);
+
+            if (end == text.c_str ())
+            {
+                return false;
+            }
+
+            switch (*end)
+            {
+                case 'k': case 'K': value *= 1024;        ++end; break;
+                case 'm': case 'M': value *= 1024 * 1024; ++end; break;
+            }
+
+            size = size_t(value);
+
+            return *end == 0;
+        }
+
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Asset_Manifest::Asset_Manifest(const string & path)
+    :
+        path  (path ),
+        loaded(false)
+    {
+        Asset::Mapping manifest = Asset::map (path);
+
+        if (manifest.good ())
+        {
+            parse (manifest.begin (), manifest.end ());
+
+            loaded = true;
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    const Asset_Manifest::Entry * Asset_Manifest::find (Id id) const
+    {
+        for (auto & entry : entries)
+        {
+            if (entry.id == id) return &entry;
+        }
+
+        return nullptr;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    size_t Asset_Manifest::get_estimated_size () const
+    {
+        size_t size = 0;
+
+        for (auto & entry : entries) size += entry.estimated_size;
+
+        return size;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Asset_Manifest::parse (const byte * begin, const byte * end)
+    {
+        for (const byte * line = begin; line < end; )
+        {
+            const byte * line_end = line;
+
+            while (line_end < end && *line_end != '\n') ++line_end;
+
+            // Se separan los elementos de la línea:
+
+            vector< string > tokens;
+
+            for (const byte * token = line; token < line_end; )
+            {
+                while (token < line_end && (*token == ' ' || *token == '\t' || *token == '\r')) ++token;
+
+                const byte * token_end = token;
+
+                while (token_end < line_end && *token_end != ' ' && *token_end != '\t' && *token_end != '\r') ++token_end;
+
+                if (token_end > token) tokens.emplace_back (reinterpret_cast< const char * >(token), token_end - token);
+
+                token = token_end;
+            }
+
+            if (!tokens.empty () && tokens[0][0] != '#')
+            {
+                Entry entry{ tokens[0], get_kind (tokens[0]), 0, 0, 0 };
+
+                for (size_t index = 1; index < tokens.size (); ++index)
+                {
+                    const string & token = tokens[index];
+                    size_t         size;
+
+                    if (token == "texture") entry.kind = TEXTURE; else
+                    if (token == "atlas"  ) entry.kind = ATLAS;   else
+                    if (token == "font"   ) entry.kind = FONT;    else
+                    if (token == "file"   ) entry.kind = FILE;    else
+                    if (token.compare (0, 3, "id="     ) == 0) entry.id = fnv32 (token.substr (3)); else
+                    if (token.compare (0, 8, "display=") == 0)
+                    {
+                        if (parse_size (token.substr (8), size)) entry.display_size = unsigned(size);
+                    }
+                    else
+                        parse_size (token, entry.estimated_size);
+                }
+
+                entries.push_back (entry);
+            }
+
+            line = line_end + 1;
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Asset_Manifest::Kind Asset_Manifest::get_kind (const string & path)
+    {
+        if (ends_with (path, ".png"    ) || ends_with (path, ".ktx"   )) return TEXTURE;
+        if (ends_with (path, ".sprites") || ends_with (path, ".slices")) return ATLAS;
+        if (ends_with (path, ".fnt"    ) || ends_with (path, ".font"  )) return FONT;
+
+        return FILE;
+    }
+
+}
@@ -0,0 +1,157 @@
+/*
+ * ASSET READER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803261000
+ */
+
+#include <basics/Asset_Manifest>
+#include <basics/Asset_Reader>
+
+namespace basics
+{
+
+    namespace internal
+    {
+
+        // Se implementan en los adaptadores de cada plataforma:
+
+        std::unique_ptr< Asset_Reader::Backend > create_native_reader_backend (Asset_Reader & reader);
+
+        void prefetch_asset_file (const std::string & path);
+
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Asset_Reader::Asset_Reader(unsigned thread_count, bool native_reads)
+    :
+        pending_count(0),
+        backend      (native_reads ? internal::create_native_reader_backend (*this) : nullptr),
+        thread_pool  (backend ? 1 : thread_count)
+    {
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Asset_Reader::~Asset_Reader()
+    {
+        // Se terminan las lecturas encargadas al Thread_Pool para que nadie espere a una que ya no
+        // se va a hacer. El backend termina las suyas al destruirse:
+
+        thread_pool.wait_idle ();
+
+        backend.reset ();
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Asset_Reader::Handle Asset_Reader::read (const std::string & path, const Callback & callback)
+    {
+        return read (std::vector< std::string >(1, path), callback).front ();
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    std::vector< Asset_Reader::Handle > Asset_Reader::read (const std::vector< std::string > & paths, const Callback & callback)
+    {
+        std::vector< Handle > reads;
+
+        reads.reserve (paths.size ());
+
+        for (auto & path : paths)
+        {
+            reads.push_back (std::make_shared< Read > (path, callback));
+        }
+
+        pending_count += int(reads.size ());
+
+        if (backend)
+        {
+            backend->submit (reads);
+        }
+        else for (auto & read : reads)
+        {
+            thread_pool.submit ([this, read] () { read_now (read); });
+        }
+
+        return reads;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Asset_Reader::prefetch (const std::vector< std::string > & paths)
+    {
+        if (!paths.empty ())
+        {
+            thread_pool.submit
+            (
+                [paths] ()
+                {
+                    for (auto & path : paths) internal::prefetch_asset_file (path);
+                }
+            );
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Asset_Reader::prefetch_manifest (const std::string & manifest_path)
+    {
+        Asset_Manifest manifest(manifest_path);
+
+        if (!manifest.good ())
+        {
+            return false;
+        }
+
+        std::vector< std::string > paths;
+
+        for (auto & entry : manifest.get_entries ())
+        {
+            paths.push_back (entry.path);
+        }
+
+        prefetch (paths);
+
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Asset_Reader::complete (const Handle & read, const Asset::Mapping & data, bool success)
+    {
+        {
+            std::lock_guard< std::mutex > lock(read->mutex);
+
+            read->data  = data;
+            read->state = success ? Read::DONE : Read::FAILED;
+        }
+
+        read->finished.notify_all ();
+
+        if (read->callback)
+        {
+            read->callback (*read);
+        }
+
+        // Se descuenta después del callback para que is_idle() indique también que han terminado:
+
+        --pending_count;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Asset_Reader::read_now (const Handle & read)
+    {
+        Asset::Mapping data = Asset::map (read->path);
+
+        complete (read, data, data.good ());
+    }
+
+}
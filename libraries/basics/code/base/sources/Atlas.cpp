@@ -13,6 +13,8 @@
 #include <basics/assert>
 #include <basics/Asset>
 #include <basics/Atlas>
+#include <basics/Slice_Table>
+#include <basics/Texture_Registry>
 #include <cstring>
 
 #include <basics/Log>
@@ -25,17 +27,33 @@ namespace basics
 
     Atlas::Atlas(const string & path, Graphics_Context::Accessor & context)
     {
-        shared_ptr< Asset > slices_file = Asset::open (path);
+        // Si junto al .sprites hay una tabla binaria (basics-cooker --binary), se usa esta, que no
+        // necesita parseo:
 
-        if (slices_file->good ())
+        static const string sprites_suffix = ".sprites";
+
+        if (path.size () > sprites_suffix.size () && path.compare (path.size () - sprites_suffix.size (), sprites_suffix.size (), sprites_suffix) == 0)
         {
-            Buffer slices_data;
+            string         table_path = path.substr (0, path.size () - sprites_suffix.size ()) + ".slices";
+            Asset::Mapping table      = Asset::map (table_path);
 
-            if (slices_file->read_all (slices_data))
+            if (table.good () && load_table (table, table_path, context))
             {
-                parse (slices_data, path, context);
+                return;
             }
         }
+
+        Asset::Mapping slices_file = Asset::map (path);
+
+        if (slices_file.good () && !load_table (slices_file, path, context))
+        {
+            Buffer slices_data;
+
+            slices_data.reserve (slices_file.get_size () + 1);
+            slices_data.assign  (slices_file.begin (), slices_file.end ());
+
+            parse (slices_data, path, context);
+        }
     }
 
     // ---------------------------------------------------------------------------------------------
@@ -50,25 +68,120 @@ namespace basics
 
     Atlas::Slice * Atlas::add_slice (Id id, const Point2f & position, const Size2f & size)
     {
-        if (slices.count (id) == 0)
+        Slice_Index::const_iterator reference = find (id);
+
+        if (reference == index.end () || reference->id != id)
         {
-            return &
-            (
-                slices[id] =
-                {
-                    this,
-                    position.coordinates.x (), position.coordinates.x () + size.width,
-                    position.coordinates.y (), position.coordinates.y () + size.height,
-                    size.width,                size.height
-                }
-            );
-        };
+            slices.push_back
+            ({
+                this,
+                position.coordinates.x (), position.coordinates.x () + size.width,
+                position.coordinates.y (), position.coordinates.y () + size.height,
+                size.width,                size.height
+            });
+
+            index.insert (index.begin () + (reference - index.begin ()), Slice_Reference{ id, &slices.back () });
+
+            return &slices.back ();
+        }
 
         return nullptr;
     }
 
     // ---------------------------------------------------------------------------------------------
 
+    bool Atlas::load_texture (const std::string & path, const std::string & texture_name, Graphics_Context::Accessor & context)
+    {
+        // La ruta de la textura es relativa al directorio del archivo de slices:
+
+        size_t slash     = path.find_last_of ('/' );
+        size_t backslash = path.find_last_of ('\\');
+        string texture_path;
+
+        if (slash != string::npos && backslash != string::npos)
+        {
+            texture_path = path.substr (0, std::max (slash, backslash + 1));
+        }
+        else
+        if (slash != string::npos)
+        {
+            texture_path = path.substr (0, slash + 1);
+        }
+        else
+        if (backslash != string::npos)
+        {
+            texture_path = path.substr (0, backslash + 1);
+        }
+
+        // Si otro atlas, fuente o escena ya usa la misma textura, se comparte:
+
+        texture = Texture_Registry::acquire (0, context, texture_path + texture_name);
+
+        assert(texture);
+
+        return texture != nullptr;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Atlas::load_table (const Asset::Mapping & table, const std::string & path, Graphics_Context::Accessor & context)
+    {
+        const byte * data = table.get_data ();
+        size_t       size = table.get_size ();
+
+        Slice_Table::Header header;
+
+        if (size < sizeof(header))
+        {
+            return false;
+        }
+
+        std::memcpy (&header, data, sizeof(header));
+
+        size_t entries_offset = sizeof(header) + ((header.name_length + 3) & ~size_t(3));
+
+        if (header.magic != Slice_Table::MAGIC || header.version != Slice_Table::VERSION || entries_offset + size_t(header.slice_count) * sizeof(Slice_Table::Entry) > size)
+        {
+            return false;
+        }
+
+        string texture_name(reinterpret_cast< const char * >(data + sizeof(header)), header.name_length);
+
+        // Sin la textura se deja el atlas vacío para que se pueda intentar cargar el .sprites:
+
+        if (!load_texture (path, texture_name, context))
+        {
+            return false;
+        }
+
+        // Las entradas ya vienen ordenadas por id, por lo que basta con copiarlas:
+
+        const Slice_Table::Entry * entries = reinterpret_cast< const Slice_Table::Entry * >(data + entries_offset);
+
+        index.reserve (header.slice_count);
+
+        for (uint32_t position = 0; position < header.slice_count; ++position)
+        {
+            Slice_Table::Entry entry;
+
+            std::memcpy (&entry, entries + position, sizeof(entry));
+
+            float x = entry.x, y = entry.y, width = entry.width, height = entry.height;
+
+            if (index.empty () || index.back ().id < entry.id)
+            {
+                slices.push_back ({ this, x, x + width, y, y + height, width, height });
+                index.push_back  ({ Id(entry.id), &slices.back () });
+            }
+            else
+                add_slice (entry.id, { x, y }, { width, height });
+        }
+
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
     void Atlas::parse (Buffer & slices_data, const std::string & path, Graphics_Context::Accessor & context)
     {
         // Se pone un caracter nulo al final para que el parseador de rapidxml sepa dónde está el
@@ -102,37 +215,10 @@ namespace basics
 
         if (name_attribute)
         {
-            // Se determina la ruta de la textura:
-
-            size_t slash     = path.find_last_of ('/' );
-            size_t backslash = path.find_last_of ('\\');
-            string texture_path;
-
-            if (slash != string::npos && backslash != string::npos)
-            {
-                texture_path = path.substr (0, std::max (slash, backslash + 1));
-            }
-            else
-            if (slash != string::npos)
-            {
-                texture_path = path.substr (0, slash + 1);
-            }
-            else
-            if (backslash != string::npos)
-            {
-                texture_path = path.substr (0, backslash + 1);
-            }
-
             // Se intenta cargar la textura:
 
-            texture = Texture_2D::create (0, context, texture_path + name_attribute->value ());
-
-            assert(texture);
-
-            if (texture)
+            if (load_texture (path, name_attribute->value (), context))
             {
-                context->add (texture);
-
                 // Se comprueba que las dimensiones de la textura coinciden con lo que indica el XML:
 
                 //xml_attribute<> * w_attribute = img_tag->first_attribute ("w");
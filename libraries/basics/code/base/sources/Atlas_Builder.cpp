@@ -0,0 +1,232 @@
+/*
+ * ATLAS BUILDER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803141030
+ */
+
+#include <algorithm>
+#include <numeric>
+#include <basics/Asset>
+#include <basics/Atlas_Builder>
+#include <basics/Log>
+#include <basics/png_decode>
+#include <basics/Rectangle_Packer>
+#include <basics/resample>
+#include <basics/Texture_2D>
+#include <basics/Timer>
+
+namespace basics
+{
+
+    Atlas_Builder::Atlas_Builder(const Options & options)
+    :
+        options      (options),
+        load_failures(0)
+    {
+        statistics.page_count     = 0;
+        statistics.image_count    = 0;
+        statistics.rejected_count = 0;
+        statistics.efficiency     = 0.f;
+        statistics.build_time     = 0.f;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Atlas_Builder::add (Id id, const Color_Buffer< Rgba8888 > & color_buffer)
+    {
+        if (color_buffer.size () > 0)
+        {
+            images.push_back ({ id, color_buffer });
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Atlas_Builder::add (Id id, const std::string & asset_path)
+    {
+        Asset::Mapping data = Asset::map (asset_path);
+
+        if (data.good ())
+        {
+            Image    image{ id, Color_Buffer< Rgba8888 >() };
+            unsigned width, height;
+
+            if (png_decode (data.get_data (), data.get_size (), image.color_buffer, width, height))
+            {
+                images.push_back (std::move (image));
+
+                return true;
+            }
+        }
+
+        load_failures++;
+
+        return false;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Atlas_Builder::Atlas_List Atlas_Builder::build (Graphics_Context::Accessor & context)
+    {
+        Timer timer;
+
+        // Las estadísticas son las de esta llamada, incluidas las imágenes que no se pudieron cargar
+        // al añadirlas:
+
+        statistics.page_count     = 0;
+        statistics.image_count    = 0;
+        statistics.rejected_count = load_failures;
+        statistics.efficiency     = 0.f;
+        statistics.build_time     = 0.f;
+
+        load_failures = 0;
+
+        struct Placement
+        {
+            size_t  image;
+            Point2u position;
+        };
+
+        struct Page
+        {
+            Rectangle_Packer         packer;
+            std::vector< Placement > placements;
+        };
+
+        const unsigned extrusion = options.extrusion;
+        const unsigned margin    = options.extrusion * 2 + options.padding;
+
+        // Se colocan primero las imágenes más altas, lo que reduce los huecos del skyline:
+
+        std::vector< size_t > order(images.size ());
+
+        std::iota (order.begin (), order.end (), size_t(0));
+        std::stable_sort
+        (
+            order.begin (),
+            order.end   (),
+            [this] (size_t a, size_t b)
+            {
+                const Color_Buffer< Rgba8888 > & image_a = images[a].color_buffer;
+                const Color_Buffer< Rgba8888 > & image_b = images[b].color_buffer;
+
+                return image_a.height != image_b.height ? image_a.height > image_b.height : image_a.width > image_b.width;
+            }
+        );
+
+        std::vector< Page > pages;
+
+        for (size_t index : order)
+        {
+            const Color_Buffer< Rgba8888 > & image = images[index].color_buffer;
+
+            Size2u  cell{ image.width + margin, image.height + margin };
+            Point2u position;
+            bool    placed = false;
+
+            for (auto & page : pages)
+            {
+                if (page.packer.insert (cell, position))
+                {
+                    page.placements.push_back ({ index, position });
+                    placed = true;
+                    break;
+                }
+            }
+
+            if (!placed)
+            {
+                pages.push_back ({ Rectangle_Packer(options.page_width, options.page_height), std::vector< Placement >() });
+
+                if (pages.back ().packer.insert (cell, position))
+                {
+                    pages.back ().placements.push_back ({ index, position });
+                }
+                else
+                {
+                    pages.pop_back ();
+
+                    statistics.rejected_count++;
+
+                    basics::log.w ("Atlas_Builder: an image does not fit in a page and has been discarded.");
+                }
+            }
+        }
+
+        // Se copian las imágenes (con sus bordes replicados) en cada página y se crean los atlas:
+
+        Atlas_List atlases;
+        uint64_t   image_area = 0;
+        uint64_t   page_area  = 0;
+
+        for (auto & page : pages)
+        {
+            unsigned page_width  = options.page_width;
+            unsigned page_height = 1;
+
+            // La altura de la página se ajusta a la potencia de 2 que abarca lo ocupado:
+
+            while (page_height < page.packer.get_used_height ()) page_height <<= 1;
+
+            page_height = std::min (page_height, options.page_height);
+
+            Color_Buffer< Rgba8888 > pixels(page_width, page_height);
+
+            for (auto & placement : page.placements)
+            {
+                const Color_Buffer< Rgba8888 > & image = images[placement.image].color_buffer;
+
+                copy_extruded (image, pixels, placement.position[0] + extrusion, placement.position[1] + extrusion, extrusion);
+
+                image_area += uint64_t(image.width) * image.height;
+            }
+
+            page_area += uint64_t(page_width) * page_height;
+
+            Texture_2D::Options texture_options{};
+
+            texture_options.width  = page_width;
+            texture_options.height = page_height;
+
+            std::shared_ptr< Texture_2D > texture = Texture_2D::create (0, context, pixels, texture_options);
+
+            if (texture)
+            {
+                context->add (texture);
+
+                Atlas_Handle atlas = std::make_shared< Atlas > (texture);
+
+                for (auto & placement : page.placements)
+                {
+                    const Color_Buffer< Rgba8888 > & image = images[placement.image].color_buffer;
+
+                    atlas->add_slice
+                    (
+                        images[placement.image].id,
+                        { float(placement.position[0] + extrusion), float(placement.position[1] + extrusion) },
+                        { float(image.width), float(image.height) }
+                    );
+
+                    statistics.image_count++;
+                }
+
+                atlases.push_back (atlas);
+            }
+        }
+
+        images.clear ();
+
+        statistics.page_count = unsigned(atlases.size ());
+        statistics.efficiency = page_area > 0 ? float(double(image_area) / double(page_area)) : 0.f;
+        statistics.build_time = timer.get_elapsed_seconds ();
+
+        return atlases;
+    }
+
+}
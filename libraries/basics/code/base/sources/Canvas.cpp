@@ -34,14 +34,10 @@ namespace basics
         return nullptr;
     }
 
-    void Canvas::draw_text (const Point2f & where, const Text_Layout & text_layout, int handling)
+    Point2f Canvas::get_text_top_left (const Point2f & where, float width, float height, int handling)
     {
-        const Text_Layout::Glyph_List & glyphs = text_layout.get_glyphs ();
-
-        float width  = text_layout.get_width  ();
-        float height = text_layout.get_height ();
-        float left   = where[0];
-        float top    = where[1];
+        float left = where[0];
+        float top  = where[1];
 
         switch (handling & 0x03)
         {
@@ -57,11 +53,26 @@ namespace basics
             default:     break;
         }
 
+        return { left, top };
+    }
+
+    void Canvas::draw_text (const Point2f & where, const Text_Layout & text_layout, int handling)
+    {
+        draw_glyphs (get_text_top_left (where, text_layout.get_width (), text_layout.get_height (), handling), text_layout.get_glyphs ());
+    }
+
+    void Canvas::draw_text (const Point2f & where, const Text_Prefab & text_prefab, int handling)
+    {
+        draw_glyphs (get_text_top_left (where, text_prefab.get_width (), text_prefab.get_height (), handling), text_prefab.get_glyphs ());
+    }
+
+    void Canvas::draw_glyphs (const Point2f & top_left, const Text_Layout::Glyph_List & glyphs)
+    {
         for (auto & glyph : glyphs)
         {
             fill_rectangle
             (
-                { left + glyph.position[0], top + glyph.position[1] },
+                { top_left[0] + glyph.position[0], top_left[1] + glyph.position[1] },
                 glyph.size,
                 glyph.slice,
                 TOP | LEFT
@@ -69,4 +80,34 @@ namespace basics
         }
     }
 
+    bool Canvas::cull (const Transformation2f & clip_transform, const Point2f * points, unsigned count)
+    {
+        const Transformation2f::Matrix & m = clip_transform.matrix;
+
+        // Se cuentan los vértices que quedan a cada lado de los planos de recorte. Si todos quedan
+        // fuera del mismo plano, la primitiva no puede ser visible:
+
+        unsigned outside_left = 0, outside_right = 0, outside_bottom = 0, outside_top = 0;
+
+        for (unsigned index = 0; index < count; ++index)
+        {
+            float x = m[0][0] * points[index][0] + m[0][1] * points[index][1] + m[0][2];
+            float y = m[1][0] * points[index][0] + m[1][1] * points[index][1] + m[1][2];
+
+            if (x < -1.f) ++outside_left;   else if (x > 1.f) ++outside_right;
+            if (y < -1.f) ++outside_bottom; else if (y > 1.f) ++outside_top;
+        }
+
+        if (outside_left == count || outside_right == count || outside_bottom == count || outside_top == count)
+        {
+            statistics.culled++;
+
+            return true;
+        }
+
+        statistics.submitted++;
+
+        return false;
+    }
+
 }
@@ -0,0 +1,183 @@
+/*
+ * GRAPHICS RESOURCE CACHE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803181000
+ */
+
+#include <algorithm>
+#include <basics/Graphics_Resource_Cache>
+
+namespace basics
+{
+
+    bool Graphics_Resource::make_resident () const
+    {
+        // Que el recurso esté o no en la memoria de vídeo no forma parte de su estado observable,
+        // por lo que se puede volver a inicializar aunque se use a través de una referencia const:
+
+        Graphics_Resource & resource = const_cast< Graphics_Resource & >(*this);
+
+        if (cache)
+        {
+            return cache->use (resource);
+        }
+
+        return initialized || resource.initialize ();
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Graphics_Resource_Cache::~Graphics_Resource_Cache()
+    {
+        // Los recursos pueden sobrevivir a la caché, por lo que no deben seguir apuntando a ella:
+
+        for (auto & entry : resources)
+        {
+            auto resource = entry.lock ();
+
+            if (resource) resource->cache = nullptr;
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Graphics_Resource_Cache::add (const std::shared_ptr< Graphics_Resource > & resource, bool retained)
+    {
+        if (!resource) return;
+
+        auto found = index.find (resource.get ());
+
+        if (found != index.end ())
+        {
+            // La entrada puede pertenecer a un recurso destruido cuya dirección se ha reutilizado:
+
+            if (found->second->resource.expired ())
+            {
+                remove (found->second);
+            }
+            else
+            {
+                found->second->retained |= retained;
+
+                update_size (*found->second, *resource);
+                enforce_budget (resource.get ());
+                return;
+            }
+        }
+
+        resources.push_front (Entry{ resource, resource.get (), 0, retained });
+
+        index[resource.get ()] = resources.begin ();
+        resource->cache        = this;
+
+        update_size    (resources.front (), *resource);
+        enforce_budget (resource.get ());
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Graphics_Resource_Cache::use (Graphics_Resource & resource)
+    {
+        if (resource.initialized)
+        {
+            statistics.hits++;
+        }
+        else
+        {
+            statistics.misses++;
+
+            if (!resource.initialize ()) return false;
+        }
+
+        auto found = index.find (&resource);
+
+        if (found != index.end ())
+        {
+            // Se mueve la entrada al principio de la lista sin invalidar el iterador:
+
+            resources.splice (resources.begin (), resources, found->second);
+
+            update_size (*found->second, resource);
+
+            if (statistics.resident_bytes > budget && budget > 0)
+            {
+                enforce_budget (&resource);
+            }
+        }
+
+        return resource.initialized;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Graphics_Resource_Cache::prune ()
+    {
+        for (auto entry = resources.begin (); entry != resources.end (); )
+        {
+            auto next = std::next (entry);
+
+            if (entry->resource.expired ()) remove (entry);
+
+            entry = next;
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Graphics_Resource_Cache::update_size (Entry & entry, const Graphics_Resource & resource)
+    {
+        size_t size = resource.initialized ? resource.get_byte_size () : 0;
+
+        statistics.resident_bytes = statistics.resident_bytes - entry.size + size;
+        statistics.peak_bytes     = std::max (statistics.peak_bytes, statistics.resident_bytes);
+
+        entry.size = size;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Graphics_Resource_Cache::enforce_budget (const Graphics_Resource * keep)
+    {
+        if (budget == 0 || statistics.resident_bytes <= budget)
+        {
+            return;
+        }
+
+        prune ();
+
+        // Se recorre la lista desde el recurso usado hace más tiempo:
+
+        for (auto entry = resources.rbegin (); entry != resources.rend () && statistics.resident_bytes > budget; ++entry)
+        {
+            if (entry->pointer == keep || entry->size == 0) continue;
+
+            auto resource = entry->lock ();
+
+            if (resource && resource->initialized && resource->is_evictable ())
+            {
+                resource->finalize ();
+
+                update_size (*entry, *resource);
+
+                statistics.evictions++;
+            }
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Graphics_Resource_Cache::remove (Iterator entry)
+    {
+        statistics.resident_bytes -= entry->size;
+
+        index.erase     (entry->pointer);
+        resources.erase (entry);
+    }
+
+}
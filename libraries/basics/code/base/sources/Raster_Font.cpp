@@ -12,7 +12,9 @@
 
 #include <cstring>
 #include <rapidxml.hpp>
+#include <basics/Font_Table>
 #include <basics/Raster_Font>
+#include <basics/Texture_Registry>
 
 using namespace std;
 using namespace rapidxml;
@@ -22,17 +24,221 @@ namespace basics
 
     Raster_Font::Raster_Font(const string & path, Graphics_Context::Accessor & context)
     {
-        shared_ptr< Asset > font_file = Asset::open (path);
+        std::fill (direct, direct + direct_range, nullptr);
 
-        if (font_file->good ())
+        // Si junto al .fnt hay una fuente binaria (basics-cooker --binary), se usa esta, que no
+        // necesita parseo:
+
+        static const string fnt_suffix = ".fnt";
+
+        if (path.size () > fnt_suffix.size () && path.compare (path.size () - fnt_suffix.size (), fnt_suffix.size (), fnt_suffix) == 0)
+        {
+            string         table_path = path.substr (0, path.size () - fnt_suffix.size ()) + ".font";
+            Asset::Mapping table      = Asset::map (table_path);
+
+            if (table.good () && load_table (table, table_path, context))
+            {
+                ready = true;
+                return;
+            }
+        }
+
+        Asset::Mapping font_file = Asset::map (path);
+
+        if (font_file.good ())
         {
+            if (load_table (font_file, path, context))
+            {
+                ready = true;
+                return;
+            }
+
             Buffer font_data;
 
-            if (font_file->read_all (font_data))
+            font_data.reserve (font_file.get_size () + 1);
+            font_data.assign  (font_file.begin (), font_file.end ());
+
+            ready = parse (font_data, path, context) && index ();
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Raster_Font::load_table (const Asset::Mapping & table, const std::string & path, Graphics_Context::Accessor & context)
+    {
+        const byte * data = table.get_data ();
+        size_t       size = table.get_size ();
+
+        Font_Table::Header header;
+
+        if (size < sizeof(header))
+        {
+            return false;
+        }
+
+        std::memcpy (&header, data, sizeof(header));
+
+        size_t texture_name_offset = sizeof(header)      + ((header.face_length         + 3) & ~size_t(3));
+        size_t glyphs_offset       = texture_name_offset + ((header.texture_name_length + 3) & ~size_t(3));
+        size_t kernings_offset     = glyphs_offset       + size_t(header.glyph_count) * sizeof(Font_Table::Glyph);
+
+        if
+        (
+            header.magic   != Font_Table::MAGIC   ||
+            header.version != Font_Table::VERSION ||
+            header.glyph_count == 0               ||
+            kernings_offset + size_t(header.kerning_count) * sizeof(Font_Table::Kerning) > size
+        )
+        {
+            return false;
+        }
+
+        name = string(reinterpret_cast< const char * >(data + sizeof(header)), header.face_length);
+
+        metrics.line_height = float(header.line_height);
+        metrics.base_height = float(header.line_height) - float(header.base);
+
+        if (!(metrics.line_height > 0 && metrics.base_height < metrics.line_height))
+        {
+            return false;
+        }
+
+        string texture_name(reinterpret_cast< const char * >(data + texture_name_offset), header.texture_name_length);
+
+        if (!load_texture (path, texture_name, context))
+        {
+            return false;
+        }
+
+        characters.reserve (header.glyph_count);
+
+        for (uint32_t position = 0; position < header.glyph_count; ++position)
+        {
+            Font_Table::Glyph glyph;
+
+            std::memcpy (&glyph, data + glyphs_offset + position * sizeof(glyph), sizeof(glyph));
+
+            if (!add_character (glyph.code, glyph.x, glyph.y, glyph.width, glyph.height, glyph.x_offset, glyph.y_offset, glyph.advance))
+            {
+                // Se deja la fuente vacía para que se pueda intentar cargar el .fnt:
+
+                characters.clear ();
+                atlas.reset ();
+
+                return false;
+            }
+        }
+
+        kernings.reserve (header.kerning_count);
+
+        for (uint32_t position = 0; position < header.kerning_count; ++position)
+        {
+            Font_Table::Kerning kerning;
+
+            std::memcpy (&kerning, data + kernings_offset + position * sizeof(kerning), sizeof(kerning));
+
+            kernings.push_back ({ uint64_t(kerning.first) << 32 | kerning.second, float(kerning.amount) });
+        }
+
+        return index ();
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Raster_Font::load_texture (const std::string & path, const std::string & texture_name, Graphics_Context::Accessor & context)
+    {
+        // La ruta de la textura es relativa al directorio del archivo de la fuente:
+
+        size_t slash     = path.find_last_of ('/' );
+        size_t backslash = path.find_last_of ('\\');
+        string texture_path;
+
+        if (slash != string::npos && backslash != string::npos)
+        {
+            texture_path = path.substr (0, std::max (slash, backslash + 1));
+        }
+        else
+        if (slash != string::npos)
+        {
+            texture_path = path.substr (0, slash + 1);
+        }
+        else
+        if (backslash != string::npos)
+        {
+            texture_path = path.substr (0, backslash + 1);
+        }
+
+        auto texture = Texture_Registry::acquire (0, context, texture_path + texture_name);
+
+        assert(texture);
+
+        if (texture)
+        {
+            atlas.reset (new Atlas(texture));
+
+            return true;
+        }
+
+        return false;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Raster_Font::add_character (uint32_t code, int x, int y, int width, int height, int x_offset, int y_offset, int advance)
+    {
+        if (width > 0 && height > 0)
+        {
+            // El atlas rechaza los ids repetidos, por lo que también sirve para detectar caracteres
+            // duplicados:
+
+            Atlas::Slice * slice = atlas->add_slice (Id(code), { float(x), float(y) }, { float(width), float(height) });
+
+            if (slice)
             {
-                ready = parse (font_data, path, context);
+                Character character;
+
+                character.code    = code;
+                character.slice   = slice;
+                character.offset  = Vector2f{ float(x_offset), float(y_offset) };
+                character.advance = float(advance);
+
+                characters.push_back (character);
+
+                return true;
             }
         }
+
+        return false;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Raster_Font::index ()
+    {
+        // Los .fnt no garantizan ningún orden, mientras que las tablas binarias ya vienen ordenadas:
+
+        auto by_code = [] (const Character & a, const Character & b) { return a.code < b.code; };
+        auto by_pair = [] (const Kerning   & a, const Kerning   & b) { return a.pair < b.pair; };
+
+        if (!std::is_sorted (characters.begin (), characters.end (), by_code)) std::sort (characters.begin (), characters.end (), by_code);
+        if (!std::is_sorted (kernings.begin   (), kernings.end   (), by_pair)) std::sort (kernings.begin   (), kernings.end   (), by_pair);
+
+        // Una vez que el vector de caracteres no va a cambiar se pueden guardar punteros a ellos:
+
+        codes.clear   ();
+        codes.reserve (characters.size ());
+
+        for (auto & character : characters)
+        {
+            codes.push_back (character.code);
+
+            if (character.code < direct_range)
+            {
+                direct[character.code] = &character;
+            }
+        }
+
+        return !characters.empty ();
     }
 
     // ---------------------------------------------------------------------------------------------
@@ -81,6 +287,13 @@ namespace basics
         xml_node<> *  chars_tag = font_tag->first_node ("chars" );
         xml_node<> *  pages_tag = font_tag->first_node ("pages" );
 
+        xml_node<> * kernings_tag = font_tag->first_node ("kernings");
+
+        if (kernings_tag)
+        {
+            parse_kernings (kernings_tag);
+        }
+
         return
               info_tag &&
             common_tag &&
@@ -109,41 +322,7 @@ namespace basics
 
             if (file_attritube)
             {
-                // Se determina la ruta de la textura:
-
-                size_t slash     = path.find_last_of ('/' );
-                size_t backslash = path.find_last_of ('\\');
-                string texture_path;
-
-                if (slash != string::npos && backslash != string::npos)
-                {
-                    texture_path = path.substr (0, std::max (slash, backslash + 1));
-                }
-                else
-                if (slash != string::npos)
-                {
-                    texture_path = path.substr (0, slash + 1);
-                }
-                else
-                if (backslash != string::npos)
-                {
-                    texture_path = path.substr (0, backslash + 1);
-                }
-
-                // Se intenta cargar la textura:
-
-                auto texture = Texture_2D::create (0, context, texture_path + file_attritube->value ());
-
-                assert(texture);
-
-                if (texture)
-                {
-                    context->add (texture);
-
-                    atlas.reset (new Atlas(texture));
-
-                    return true;
-                }
+                return load_texture (path, file_attritube->value (), context);
             }
         }
 
@@ -252,19 +431,41 @@ namespace basics
             int y_offset = std::atoi (y_offset_attribute->value ());
             int advance  = std::atoi ( advance_attribute->value ());
 
-            if (width > 0 && height > 0 && character_map.count (uint32_t(id)) == 0)
-            {
-                Character & character = character_map[uint32_t(id)];
-
-                character.slice   = atlas->add_slice (Id(id), { float(x), float(y) }, { float(width), float(height) });
-                character.offset  = Vector2f{ float(x_offset), float(y_offset) };
-                character.advance = float(advance);
-
-                return true;
-            };
+            return add_character (uint32_t(id), x, y, width, height, x_offset, y_offset, advance);
         }
 
         return false;
     }
 
+    // ---------------------------------------------------------------------------------------------
+
+    void Raster_Font::parse_kernings (rapidxml::xml_node<> * kernings_tag)
+    {
+        // Los pares incompletos se ignoran porque el kerning solo afina la colocación de los caracteres:
+
+        for
+        (
+            xml_node<> * kerning_tag = kernings_tag->first_node ("kerning");
+            kerning_tag;
+            kerning_tag = kerning_tag->next_sibling ("kerning")
+        )
+        {
+            xml_attribute<> *  first_attribute = kerning_tag->first_attribute ("first" );
+            xml_attribute<> * second_attribute = kerning_tag->first_attribute ("second");
+            xml_attribute<> * amount_attribute = kerning_tag->first_attribute ("amount");
+
+            if (first_attribute && second_attribute && amount_attribute)
+            {
+                uint32_t first  = uint32_t(std::atoi ( first_attribute->value ()));
+                uint32_t second = uint32_t(std::atoi (second_attribute->value ()));
+                int      amount = std::atoi (amount_attribute->value ());
+
+                if (amount != 0)
+                {
+                    kernings.push_back ({ uint64_t(first) << 32 | second, float(amount) });
+                }
+            }
+        }
+    }
+
 }
@@ -0,0 +1,143 @@
+/*
+ * RECTANGLE PACKER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803141000
+ */
+
+#include <algorithm>
+#include <limits>
+#include <basics/Rectangle_Packer>
+
+namespace basics
+{
+
+    bool Rectangle_Packer::insert (const Size2u & size, Point2u & position)
+    {
+        if (size.width == 0 || size.height == 0 || size.width > width || size.height > height)
+        {
+            return false;
+        }
+
+        // Se elige el segmento en el que el rectángulo queda más arriba y, en caso de empate, el
+        // más estrecho para desperdiciar menos espacio:
+
+        size_t   best_index  = skyline.size ();
+        unsigned best_bottom = std::numeric_limits< unsigned >::max ();
+        unsigned best_width  = std::numeric_limits< unsigned >::max ();
+        unsigned best_y      = 0;
+
+        for (size_t index = 0; index < skyline.size (); ++index)
+        {
+            unsigned y;
+
+            if (fits (index, size, y))
+            {
+                unsigned bottom = y + size.height;
+
+                if (bottom < best_bottom || (bottom == best_bottom && skyline[index].width < best_width))
+                {
+                    best_index  = index;
+                    best_bottom = bottom;
+                    best_width  = skyline[index].width;
+                    best_y      = y;
+                }
+            }
+        }
+
+        if (best_index == skyline.size ())
+        {
+            return false;
+        }
+
+        position = { skyline[best_index].x, best_y };
+
+        // Se inserta el nuevo segmento y se recortan (o eliminan) los que quedan debajo de él:
+
+        Segment segment{ position[0], best_bottom, size.width };
+
+        skyline.insert (skyline.begin () + best_index, segment);
+
+        for (size_t index = best_index + 1; index < skyline.size (); )
+        {
+            Segment & current = skyline[index];
+            unsigned  right   = segment.x + segment.width;
+
+            if (current.x >= right)
+            {
+                break;
+            }
+
+            unsigned shrink = right - current.x;
+
+            if (shrink >= current.width)
+            {
+                skyline.erase (skyline.begin () + index);
+            }
+            else
+            {
+                current.x     += shrink;
+                current.width -= shrink;
+                break;
+            }
+        }
+
+        // Se fusionan los segmentos contiguos que tienen la misma altura:
+
+        for (size_t index = 0; index + 1 < skyline.size (); )
+        {
+            if (skyline[index].y == skyline[index + 1].y)
+            {
+                skyline[index].width += skyline[index + 1].width;
+                skyline.erase (skyline.begin () + index + 1);
+            }
+            else
+            {
+                ++index;
+            }
+        }
+
+        used_height  = std::max (used_height, best_bottom);
+        used_area   += uint64_t(size.width) * size.height;
+
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Rectangle_Packer::fits (size_t index, const Size2u & size, unsigned & y) const
+    {
+        unsigned x = skyline[index].x;
+
+        if (x + size.width > width)
+        {
+            return false;
+        }
+
+        // El rectángulo descansa sobre el segmento más alto de los que quedan debajo de él:
+
+        unsigned remaining = size.width;
+
+        y = 0;
+
+        for ( ; remaining > 0 && index < skyline.size (); ++index)
+        {
+            y = std::max (y, skyline[index].y);
+
+            if (y + size.height > height)
+            {
+                return false;
+            }
+
+            remaining -= std::min (remaining, skyline[index].width);
+        }
+
+        return remaining == 0;
+    }
+
+}
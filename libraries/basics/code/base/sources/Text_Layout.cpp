@@ -10,39 +10,96 @@
  * C1802030140
  */
 
+#include <algorithm>
 #include <basics/Text_Layout>
 
 namespace basics
 {
 
+    Text_Layout::Text_Layout()
+    :
+        font  (nullptr),
+        width (0.f),
+        height(0.f)
+    {
+    }
+
     Text_Layout::Text_Layout(const Raster_Font & font, const std::wstring & text)
     :
+        font  (nullptr),
         width (0.f),
         height(0.f)
     {
-        Raster_Font::Metrics metrics = font.get_metrics ();
+        update (font, text);
+    }
+
+    size_t Text_Layout::update (const Raster_Font & new_font, const std::wstring & new_text)
+    {
+        Raster_Font::Metrics metrics = new_font.get_metrics ();
+
+        // Se busca el primer carácter que cambia. Si cambia la fuente hay que empezar desde el
+        // principio:
+
+        size_t first = 0;
+
+        if (font == &new_font && !pens.empty ())
+        {
+            size_t length = std::min (text.length (), new_text.length ());
+
+            while (first < length && text[first] == new_text[first]) ++first;
+        }
+
+        font = &new_font;
+
+        if (first == 0)
+        {
+            pens.clear ();
+            pens.push_back ({ 0.f, -metrics.line_height, 0.f, 0.f, 0 });
+        }
+
+        // Se recupera el estado que había antes de ese carácter. La memoria de los vectores se
+        // conserva, por lo que no hay reservas cuando el texto cambia poco:
+
+        Pen pen = pens[first];
+
+        pens  .erase  (pens  .begin () + first + 1,       pens  .end ());
+        glyphs.erase  (glyphs.begin () + pen.glyph_count, glyphs.end ());
+        text  .assign (new_text);
 
         glyphs.reserve (text.length ());
+        pens  .reserve (text.length () + 1);
+
+        float current_x = pen.x;
+        float current_y = pen.y;
 
-        float current_x  = 0;
-        float current_y  = -metrics.line_height;
-        float line_width = 0;
+        width  = pen.width;
+        height = pen.height;
 
-        for (auto & c : text)
+        // El kerning depende del carácter anterior de la misma línea:
+
+        bool     kerning  = font->has_kerning ();
+        uint32_t previous = first > 0 && text[first - 1] != L'\n' ? uint32_t(text[first - 1]) : 0;
+
+        for (size_t index = first, length = text.length (); index < length; ++index)
         {
+            wchar_t c = text[index];
+
             if (c == L'\n')
             {
                 if (current_x > width) width = current_x;
 
                 current_x  = 0.f;
                 current_y -= metrics.line_height;
+                previous   = 0;
             }
             else
             {
-                const Raster_Font::Character * character = font.get_character (uint32_t(c));
+                const Raster_Font::Character * character = font->get_character (uint32_t(c));
 
                 if (character)
                 {
+                    if (kerning && previous) current_x += font->get_kerning (previous, uint32_t(c));
+
                     glyphs.emplace_back
                     (
                          character->slice,
@@ -54,10 +111,16 @@ namespace basics
 
                     current_x += character->advance;
                 }
+
+                previous = uint32_t(c);
             }
+
+            pens.push_back ({ current_x, current_y, width, height, unsigned(glyphs.size ()) });
         }
 
         if (current_x > width) width = current_x;
+
+        return first;
     }
 
 }
@@ -0,0 +1,95 @@
+/*
+ * TEXT LAYOUT CACHE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803121000
+ */
+
+#include <iterator>
+#include <basics/fnv>
+#include <basics/Text_Layout_Cache>
+
+namespace basics
+{
+
+    std::shared_ptr< const Text_Layout > Text_Layout_Cache::get (const Raster_Font & font, const std::wstring & text)
+    {
+        uint32_t hash = fnv32 (text);
+
+        // Se comprueban la fuente y el texto completo para descartar colisiones del hash:
+
+        auto range = index.equal_range (hash);
+
+        for (auto item = range.first; item != range.second; ++item)
+        {
+            Entry_List::iterator entry = item->second;
+
+            if (entry->layout->get_font () == &font && entry->layout->get_text () == text)
+            {
+                entries.splice (entries.begin (), entries, entry);
+
+                statistics.hits++;
+
+                return entry->layout;
+            }
+        }
+
+        statistics.misses++;
+
+        std::shared_ptr< Text_Layout > layout;
+
+        if (entries.size () >= capacity)
+        {
+            Entry_List::iterator oldest = std::prev (entries.end ());
+
+            remove_from_index (oldest);
+
+            // Si nadie más retiene la maquetación descartada, se reutiliza su memoria:
+
+            if (oldest->layout.use_count () == 1)
+            {
+                layout = std::move (oldest->layout);
+            }
+
+            entries.erase (oldest);
+
+            statistics.evictions++;
+        }
+
+        if (layout)
+        {
+            layout->update (font, text);
+        }
+        else
+        {
+            layout = std::make_shared< Text_Layout > (font, text);
+        }
+
+        entries.push_front ({ hash, layout });
+        index  .emplace    (hash, entries.begin ());
+
+        return layout;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Text_Layout_Cache::remove_from_index (Entry_List::iterator entry)
+    {
+        auto range = index.equal_range (entry->hash);
+
+        for (auto item = range.first; item != range.second; ++item)
+        {
+            if (item->second == entry)
+            {
+                index.erase (item);
+                break;
+            }
+        }
+    }
+
+}
@@ -10,9 +10,90 @@
  * C1802030155
  */
 
+#include <map>
+#include <basics/Atlas>
 #include <basics/Text_Prefab>
 
 namespace basics
 {
 
+    Id                   Text_Prefab::text_prefab_specialization_ids      [10];
+    Text_Prefab::Factory Text_Prefab::text_prefab_specialization_factories[10];
+    size_t               Text_Prefab::text_prefab_specialization_count = 0;
+
+    std::shared_ptr< Text_Prefab > Text_Prefab::create (Id id, Graphics_Context::Accessor & context, const Text_Layout & text_layout)
+    {
+        std::shared_ptr< Text_Prefab > text_prefab;
+
+        Id context_id = context->get_id ();
+
+        for (unsigned index = 0; index < text_prefab_specialization_count; ++index)
+        {
+            if (text_prefab_specialization_ids[index] == context_id)
+            {
+                text_prefab = text_prefab_specialization_factories[index] (id, text_layout);
+                break;
+            }
+        }
+
+        if (!text_prefab)
+        {
+            text_prefab = std::make_shared< Text_Prefab > (text_layout);
+        }
+
+        context->add (text_prefab);
+
+        return text_prefab;
+    }
+
+    Text_Prefab::Text_Prefab(const Text_Layout & text_layout)
+    :
+        glyphs(text_layout.get_glyphs ()),
+        width (text_layout.get_width  ()),
+        height(text_layout.get_height ())
+    {
+        if (!glyphs.empty () && glyphs.front ().slice && glyphs.front ().slice->atlas)
+        {
+            texture = glyphs.front ().slice->atlas->get_texture ();
+        }
+
+        if (!texture)
+        {
+            return;
+        }
+
+        // Los slices pertenecen al atlas de la fuente, que se puede liberar antes que el prefab, por
+        // lo que se copian (una vez por carácter distinto) a un atlas propio sobre la misma textura.
+        // Los glifos de otras páginas no se pueden dibujar con la textura del prefab y se descartan:
+
+        std::map< const Atlas::Slice *, const Atlas::Slice * > copies;
+
+        atlas.reset (new Atlas(texture));
+
+        for (auto & glyph : glyphs)
+        {
+            const Atlas::Slice * slice = glyph.slice;
+
+            if (!slice || !slice->atlas || slice->atlas->get_texture () != texture)
+            {
+                glyph.slice = nullptr;
+                continue;
+            }
+
+            const Atlas::Slice *& copy = copies[slice];
+
+            if (!copy)
+            {
+                copy = atlas->add_slice
+                (
+                    Id(copies.size ()),
+                    { slice->left,                 slice->bottom                },
+                    { slice->right - slice->left,  slice->top   - slice->bottom }
+                );
+            }
+
+            glyph.slice = copy;
+        }
+    }
+
 }
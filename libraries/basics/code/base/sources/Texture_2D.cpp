@@ -10,8 +10,16 @@
  * C1801161300
  */
 
+#include <algorithm>
+#include <cmath>
+#include <basics/convert_color>
+#include <basics/etc_decode>
+#include <basics/ktx_decode>
 #include <basics/png_decode>
+#include <basics/png_encode>
+#include <basics/resample>
 #include <basics/Texture_2D>
+#include <basics/Texture_Cache>
 
 namespace basics
 {
@@ -20,8 +28,26 @@ namespace basics
     Texture_2D::Factory Texture_2D::texture_2d_specialization_factories[10];
     size_t              Texture_2D::texture_2d_specialization_count;
 
+    Id                       Texture_2D::texture_data_specialization_ids      [10];
+    Texture_2D::Data_Factory Texture_2D::texture_data_specialization_factories[10];
+    size_t                   Texture_2D::texture_data_specialization_count;
+
     std::shared_ptr< Texture_2D > Texture_2D::create (Id id, Graphics_Context::Accessor & context, Color_Buffer< Rgba8888 > & color_buffer, const Options & options)
     {
+        if (options.format_policy != KEEP_32_BIT)
+        {
+            Texture_Data texture_data;
+
+            if (reduce_format (color_buffer, options.format_policy, texture_data))
+            {
+                Options data_options = options;
+
+                data_options.format_policy = KEEP_32_BIT;
+
+                return Texture_2D::create (id, context, texture_data, data_options);
+            }
+        }
+
         Id context_id = context->get_id ();
 
         for (unsigned index = 0; index < texture_2d_specialization_count; ++index)
@@ -37,25 +63,262 @@ namespace basics
 
     std::shared_ptr< Texture_2D > Texture_2D::create (Id id, Graphics_Context::Accessor & context, const std::string & asset_path, const Options & options)
     {
-        std::shared_ptr< Asset > asset = Asset::open (asset_path);
+        Color_Buffer< Rgba8888 > color_buffer;
+        Texture_Data             texture_data;
+        Options                  image_options = options;
+
+        if (load (asset_path, image_options, color_buffer, texture_data))
+        {
+            return create_loaded (id, context, asset_path, options, image_options, color_buffer, texture_data);
+        }
+
+        return std::shared_ptr< Texture_2D >();
+    }
+
+    std::shared_ptr< Texture_2D > Texture_2D::create_loaded
+    (
+        Id id,
+        Graphics_Context::Accessor & context,
+        const std::string          & asset_path,
+        const Options              & options,
+        Options                      image_options,
+        Color_Buffer< Rgba8888 >   & color_buffer,
+        Texture_Data               & texture_data
+    )
+    {
+        std::shared_ptr< Texture_2D > texture;
 
-        if (asset)
+        if (texture_data.levels.empty ())
         {
-            std::vector< byte >  data;
+            texture = Texture_2D::create (id, context, color_buffer, image_options);
+        }
+        else
+        {
+            // Los datos ya tienen el formato definitivo:
+
+            image_options.format_policy = KEEP_32_BIT;
+
+            texture = Texture_2D::create (id, context, texture_data, image_options);
+        }
+
+        // Se recuerda de dónde viene la textura para poder liberar sus píxeles:
+
+        if (texture)
+        {
+            texture->source_path    = asset_path;
+            texture->source_options = options;
+        }
+
+        return texture;
+    }
+
+    bool Texture_2D::load (const std::string & asset_path, Options & options, Color_Buffer< Rgba8888 > & color_buffer, Texture_Data & texture_data)
+    {
+        // Los datos se decodifican directamente desde el asset proyectado en memoria:
+
+        Asset::Mapping data = Asset::map (asset_path);
+
+        return data.good () && decode (data.get_data (), data.get_size (), options, color_buffer, texture_data);
+    }
 
-            if (asset->read_all (data))
+    bool Texture_2D::decode (const byte * data, size_t size, Options & options, Color_Buffer< Rgba8888 > & color_buffer, Texture_Data & texture_data)
+    {
+        // Los archivos KTX se suben tal cual (comprimidos) si el contexto lo permite:
+
+        if (is_ktx (data, size))
+        {
+            return ktx_decode (data, size, texture_data);
+        }
+
+        // Si los píxeles ya se decodificaron con las mismas opciones en otra ejecución, se toman de
+        // la caché persistente:
+
+        bool     cached = Texture_Cache::is_enabled ();
+        uint64_t key    = cached ? Texture_Cache::make_key (data, size, options) : 0;
+
+        if (cached && Texture_Cache::find (key, options, color_buffer, texture_data))
+        {
+            return true;
+        }
+
+        if (png_decode (data, size, color_buffer, options.width, options.height))
+        {
+            // Las imágenes que basics-cooker ha reducido guardan el tamaño de la original, que es
+            // con el que se tienen que dibujar:
+
+            png_read_logical_size (data, size, options.width, options.height);
+
+            fit_to_display (color_buffer, options);
+
+            if (reduce_format (color_buffer, options.format_policy, texture_data))
             {
-                Color_Buffer< Rgba8888 > color_buffer;
-                Texture_2D::Options      options;
+                color_buffer = Color_Buffer< Rgba8888 >();
+            }
 
-                if (png_decode (data, color_buffer, options.width, options.height))
-                {
-                    return Texture_2D::create (id, context, color_buffer, options);
-                }
+            if (cached)
+            {
+                Texture_Cache::store (key, options, color_buffer, texture_data);
             }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    bool Texture_2D::prepare_release (const Color_Buffer< Rgba8888 > & color_buffer)
+    {
+        if (can_reload ())
+        {
+            return true;
+        }
+
+        return color_buffer.size () > 0 && png_encode (color_buffer, source_blob);
+    }
+
+    bool Texture_2D::reload (Color_Buffer< Rgba8888 > & color_buffer, Texture_Data & texture_data) const
+    {
+        if (!source_path.empty ())
+        {
+            Options options = source_options;
+
+            return load (source_path, options, color_buffer, texture_data);
+        }
+
+        if (!source_blob.empty ())
+        {
+            unsigned width, height;
+
+            return png_decode (source_blob, color_buffer, width, height);
+        }
+
+        return false;
+    }
+
+    std::shared_ptr< Texture_2D > Texture_2D::create (Id id, Graphics_Context::Accessor & context, Texture_Data & texture_data, const Options & options)
+    {
+        Options data_options = options;
+
+        data_options.width  = options.width  ? options.width  : texture_data.get_width  ();
+        data_options.height = options.height ? options.height : texture_data.get_height ();
+
+        Id context_id = context->get_id ();
+
+        for (unsigned index = 0; index < texture_data_specialization_count; ++index)
+        {
+            if (texture_data_specialization_ids[index] == context_id)
+            {
+                std::shared_ptr< Texture_2D > texture = texture_data_specialization_factories[index] (id, texture_data, data_options);
+
+                if (texture) return texture;
+            }
+        }
+
+        // Formato no admitido por el contexto: se descomprime el primer nivel y se deja que sea el
+        // contexto quien genere los mipmaps si el archivo los traía:
+
+        Color_Buffer< Rgba8888 > color_buffer;
+
+        if (etc_decode (texture_data, 0, color_buffer))
+        {
+            data_options.mipmaps       = options.mipmaps || texture_data.levels.size () > 1;
+            data_options.format_policy = KEEP_32_BIT;
+
+            return Texture_2D::create (id, context, color_buffer, data_options);
         }
 
         return std::shared_ptr< Texture_2D >();
     }
 
+    void Texture_2D::fit_to_display (Color_Buffer< Rgba8888 > & color_buffer, const Options & options)
+    {
+        unsigned width  = color_buffer.get_width  ();
+        unsigned height = color_buffer.get_height ();
+
+        if (width == 0 || height == 0 || (options.display_width == 0 && options.display_height == 0))
+        {
+            return;
+        }
+
+        // Se conserva la proporción y se elige la escala que mantiene ambas dimensiones por encima
+        // del tamaño de visualización indicado (una dimensión a 0 no impone ninguna restricción):
+
+        float scale_x = options.display_width  ? float(options.display_width ) / float(width ) : 0.f;
+        float scale_y = options.display_height ? float(options.display_height) / float(height) : 0.f;
+        float scale   = std::max (scale_x, scale_y);
+
+        if (scale >= 1.f)
+        {
+            return;
+        }
+
+        unsigned target_width  = std::min (width,  std::max (1u, unsigned(std::ceil (width  * scale))));
+        unsigned target_height = std::min (height, std::max (1u, unsigned(std::ceil (height * scale))));
+
+        // Mientras se pueda reducir a la mitad se usa halve(), que es mucho más rápida. El resto de
+        // la reducción (menos de un factor 2) se hace con el filtro de caja general:
+
+        Color_Buffer< Rgba8888 > reduced;
+
+        while (color_buffer.get_width () / 2 >= target_width && color_buffer.get_height () / 2 >= target_height)
+        {
+            halve (color_buffer, reduced);
+            std::swap (color_buffer, reduced);
+        }
+
+        if (color_buffer.get_width () > target_width || color_buffer.get_height () > target_height)
+        {
+            if (downscale (color_buffer, reduced, target_width, target_height))
+            {
+                std::swap (color_buffer, reduced);
+            }
+        }
+    }
+
+    bool Texture_2D::reduce_format (const Color_Buffer< Rgba8888 > & color_buffer, Format_Policy policy, Texture_Data & texture_data)
+    {
+        if (policy == KEEP_32_BIT || color_buffer.size () == 0)
+        {
+            return false;
+        }
+
+        Color_Buffer< uint16_t > packed;
+
+        switch (analyze_alpha (color_buffer))
+        {
+            case Alpha_Usage::OPAQUE:
+            {
+                convert< Rgb565_Format > (color_buffer, packed, Dithering::ORDERED);
+                texture_data.format = Texture_Data::RGB565;
+                break;
+            }
+
+            case Alpha_Usage::BINARY:
+            {
+                convert< Rgba5551_Format > (color_buffer, packed, Dithering::ORDERED);
+                texture_data.format = Texture_Data::RGBA5551;
+                break;
+            }
+
+            case Alpha_Usage::TRANSLUCENT:
+            {
+                if (policy != FORCE_16_BIT) return false;
+
+                convert< Rgba4444_Format > (color_buffer, packed, Dithering::ORDERED);
+                texture_data.format = Texture_Data::RGBA4444;
+                break;
+            }
+        }
+
+        const byte * bytes = reinterpret_cast< const byte * >(packed.buffer.data ());
+
+        texture_data.levels.assign
+        (
+            1,
+            Texture_Data::Level{ packed.width, packed.height, std::vector< byte >(bytes, bytes + packed.size () * 2) }
+        );
+
+        return true;
+    }
+
 }
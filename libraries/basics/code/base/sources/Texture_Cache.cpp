@@ -0,0 +1,458 @@
+/*
+ * TEXTURE CACHE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803271000
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <basics/Application>
+#include <basics/Texture_Cache>
+#include <basics/Thread_Pool>
+
+namespace basics
+{
+
+    namespace
+    {
+
+        // El contenido de los assets se resume con XXH64, que es varias veces más rápido que leer
+        // el asset y mucho más que decodificarlo:
+
+        const uint64_t prime_1 = 11400714785074694791ull;
+        const uint64_t prime_2 = 14029467366897019727ull;
+        const uint64_t prime_3 =  1609587929392839161ull;
+        const uint64_t prime_4 =  9650029242287828579ull;
+        const uint64_t prime_5 =  2870177450012600261ull;
+
+        inline uint64_t rotate (uint64_t value, int bits)
+        {
+            return (value << bits) | (value >> (64 - bits));
+        }
+
+        inline uint64_t load_64 (const byte * bytes)
+        {
+            uint64_t value;
+            std::memcpy (&value, bytes, 8);
+            return value;
+        }
+
+        inline uint32_t load_32 (const byte * bytes)
+        {
+            uint32_t value;
+            std::memcpy (&value, bytes, 4);
+            return value;
+        }
+
+        inline uint64_t accumulate (uint64_t accumulator, uint64_t input)
+        {
+            return rotate (accumulator + input * prime_2, 31) * prime_1;
+        }
+
+        inline uint64_t merge (uint64_t hash, uint64_t accumulator)
+        {
+            return (hash ^ accumulate (0, accumulator)) * prime_1 + prime_4;
+        }
+
+        uint64_t xxh64 (const byte * data, size_t size, uint64_t seed)
+        {
+            const byte * end = data + size;
+            uint64_t     hash;
+
+            if (size >= 32)
+            {
+                uint64_t v1 = seed + prime_1 + prime_2;
+                uint64_t v2 = seed + prime_2;
+                uint64_t v3 = seed;
+                uint64_t v4 = seed - prime_1;
+
+                for ( ; end - data >= 32; data += 32)
+                {
+                    v1 = accumulate (v1, load_64 (data +  0));
+                    v2 = accumulate (v2, load_64 (data +  8));
+                    v3 = accumulate (v3, load_64 (data + 16));
+                    v4 = accumulate (v4, load_64 (data + 24));
+                }
+
+                hash = rotate (v1, 1) + rotate (v2, 7) + rotate (v3, 12) + rotate (v4, 18);
+                hash = merge  (hash, v1);
+                hash = merge  (hash, v2);
+                hash = merge  (hash, v3);
+                hash = merge  (hash, v4);
+            }
+            else
+                hash = seed + prime_5;
+
+            hash += size;
+
+            for ( ; end - data >= 8; data += 8)
+            {
+                hash = rotate (hash ^ accumulate (0, load_64 (data)), 27) * prime_1 + prime_4;
+            }
+
+            if (end - data >= 4)
+            {
+                hash  = rotate (hash ^ (load_32 (data) * prime_1), 23) * prime_2 + prime_3;
+                data += 4;
+            }
+
+            for ( ; data < end; ++data)
+            {
+                hash = rotate (hash ^ (*data * prime_5), 11) * prime_1;
+            }
+
+            hash ^= hash >> 33;
+            hash *= prime_2;
+            hash ^= hash >> 29;
+            hash *= prime_3;
+            hash ^= hash >> 32;
+
+            return hash;
+        }
+
+        // -----------------------------------------------------------------------------------------
+
+        const char magic[8] = { 'B', 'A', 'S', 'I', 'C', 'S', 'T', 'C' };
+
+        struct State
+        {
+            std::mutex                    mutex;
+            std::string                   directory;    ///< Vacío mientras la caché está deshabilitada.
+            std::shared_ptr< Thread_Pool > writer;      ///< Un solo hilo para no competir con la carga.
+            Texture_Cache::Statistics     statistics;
+        };
+
+        State & state ()
+        {
+            static State state;
+
+            return state;
+        }
+
+        std::string get_directory ()
+        {
+            std::lock_guard< std::mutex > lock(state ().mutex);
+
+            return state ().directory;
+        }
+
+        std::string get_entry_path (const std::string & directory, uint64_t key)
+        {
+            char name[32];
+
+            std::snprintf (name, sizeof(name), "/%016llx.tex", static_cast< unsigned long long >(key));
+
+            return directory + name;
+        }
+
+        bool write_file (const std::string & path, const std::vector< byte > & contents)
+        {
+            // Se escribe un archivo temporal que se renombra al terminar para que nunca se pueda
+            // encontrar una entrada a medio escribir:
+
+            std::string temporary_path = path + ".tmp";
+
+            int file = ::open (temporary_path.c_str (), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+
+            if (file < 0)
+            {
+                return false;
+            }
+
+            size_t written = 0;
+
+            while (written < contents.size ())
+            {
+                ssize_t count = ::write (file, contents.data () + written, contents.size () - written);
+
+                if (count <= 0) break;
+
+                written += size_t(count);
+            }
+
+            bool success = ::close (file) == 0 && written == contents.size () && std::rename (temporary_path.c_str (), path.c_str ()) == 0;
+
+            if (!success)
+            {
+                ::unlink (temporary_path.c_str ());
+            }
+
+            return success;
+        }
+
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Texture_Cache::enable (const std::string & directory)
+    {
+        std::string path = directory;
+
+        if (path.empty ())
+        {
+            std::string storage_path = application.get_storage_path ();
+
+            if (storage_path.empty ())
+            {
+                return false;
+            }
+
+            path = storage_path + "/textures";
+        }
+
+        mkdir (path.c_str (), 0700);
+
+        if (access (path.c_str (), W_OK) != 0)
+        {
+            return false;
+        }
+
+        std::lock_guard< std::mutex > lock(state ().mutex);
+
+        state ().directory = path;
+
+        if (!state ().writer)
+        {
+            state ().writer = std::make_shared< Thread_Pool > (1);
+        }
+
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Texture_Cache::disable ()
+    {
+        flush ();
+
+        std::lock_guard< std::mutex > lock(state ().mutex);
+
+        state ().directory.clear ();
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Texture_Cache::is_enabled ()
+    {
+        return !get_directory ().empty ();
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Texture_Cache::clear ()
+    {
+        flush ();
+
+        std::string directory = get_directory ();
+
+        if (DIR * entries = directory.empty () ? nullptr : opendir (directory.c_str ()))
+        {
+            while (dirent * entry = readdir (entries))
+            {
+                size_t length = std::strlen (entry->d_name);
+
+                if (length > 4 && std::strcmp (entry->d_name + length - 4, ".tex") == 0)
+                {
+                    ::unlink ((directory + '/' + entry->d_name).c_str ());
+                }
+            }
+
+            closedir (entries);
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Texture_Cache::flush ()
+    {
+        std::shared_ptr< Thread_Pool > writer;
+
+        {
+            std::lock_guard< std::mutex > lock(state ().mutex);
+
+            writer = state ().writer;
+        }
+
+        if (writer)
+        {
+            writer->wait_idle ();
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Texture_Cache::Statistics Texture_Cache::get_statistics ()
+    {
+        std::lock_guard< std::mutex > lock(state ().mutex);
+
+        return state ().statistics;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    uint64_t Texture_Cache::make_key (const byte * data, size_t size, const Texture_2D::Options & options)
+    {
+        // Solo se tienen en cuenta las opciones que cambian los píxeles resultantes:
+
+        const uint32_t parameters[] =
+        {
+            version,
+            options.width,
+            options.height,
+            options.display_width,
+            options.display_height,
+            uint32_t(options.format_policy)
+        };
+
+        return xxh64 (reinterpret_cast< const byte * >(parameters), sizeof(parameters), xxh64 (data, size, 0));
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Texture_Cache::find (uint64_t key, Texture_2D::Options & options, Color_Buffer< Rgba8888 > & color_buffer, Texture_Data & texture_data)
+    {
+        std::string directory = get_directory ();
+
+        if (directory.empty ())
+        {
+            return false;
+        }
+
+        bool found = false;
+        int  file  = ::open (get_entry_path (directory, key).c_str (), O_RDONLY | O_CLOEXEC);
+
+        struct stat status;
+
+        if (file >= 0 && fstat (file, &status) == 0 && size_t(status.st_size) >= sizeof(Header))
+        {
+            size_t file_size = size_t(status.st_size);
+            void * mapping   = mmap (nullptr, file_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+            if (mapping != MAP_FAILED)
+            {
+                const Header & header = *static_cast< const Header * >(mapping);
+                const byte   * pixels = static_cast< const byte * >(mapping) + sizeof(Header);
+
+                // Se descartan las entradas de otra versión, truncadas o con un formato inesperado:
+
+                bool valid =
+                    std::memcmp (header.magic, magic, sizeof(magic)) == 0 &&
+                    header.version   == version                          &&
+                    header.key       == key                              &&
+                    header.format    <= Texture_Data::RGBA5551           &&
+                    header.data_size == file_size - sizeof(Header)       &&
+                    header.data_size == Texture_Data::get_level_size (Texture_Data::Format(header.format), header.pixel_width, header.pixel_height);
+
+                if (valid)
+                {
+                    options.width  = header.width;
+                    options.height = header.height;
+
+                    if (header.format == Texture_Data::RGBA8888)
+                    {
+                        const Rgba8888 * colors = reinterpret_cast< const Rgba8888 * >(pixels);
+
+                        color_buffer.width  = header.pixel_width;
+                        color_buffer.height = header.pixel_height;
+                        color_buffer.buffer.assign (colors, colors + color_buffer.size ());
+                    }
+                    else
+                    {
+                        texture_data.format = Texture_Data::Format(header.format);
+
+                        texture_data.levels.assign
+                        (
+                            1,
+                            Texture_Data::Level{ header.pixel_width, header.pixel_height, std::vector< byte >(pixels, pixels + header.data_size) }
+                        );
+                    }
+
+                    found = true;
+                }
+
+                munmap (mapping, file_size);
+            }
+        }
+
+        if (file >= 0) ::close (file);
+
+        std::lock_guard< std::mutex > lock(state ().mutex);
+
+        if (found) state ().statistics.hits++; else state ().statistics.misses++;
+
+        return found;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Texture_Cache::store (uint64_t key, const Texture_2D::Options & options, const Color_Buffer< Rgba8888 > & color_buffer, const Texture_Data & texture_data)
+    {
+        std::string                    directory;
+        std::shared_ptr< Thread_Pool > writer;
+
+        {
+            std::lock_guard< std::mutex > lock(state ().mutex);
+
+            directory = state ().directory;
+            writer    = state ().writer;
+        }
+
+        // Solo se guardan los formatos sin comprimir (los KTX no se decodifican):
+
+        bool packed = !texture_data.levels.empty ();
+
+        if (directory.empty () || (packed && texture_data.format > Texture_Data::RGBA5551))
+        {
+            return;
+        }
+
+        const byte * pixels    = packed ? texture_data.levels.front ().data.data () : reinterpret_cast< const byte * >(color_buffer.buffer.data ());
+        size_t       data_size = packed ? texture_data.levels.front ().data.size () : color_buffer.size () * sizeof(Rgba8888);
+
+        Header header;
+
+        std::memset (&header, 0, sizeof(header));
+        std::memcpy (header.magic, magic, sizeof(magic));
+
+        header.version      = version;
+        header.format       = packed ? uint32_t(texture_data.format) : uint32_t(Texture_Data::RGBA8888);
+        header.key          = key;
+        header.width        = options.width;
+        header.height       = options.height;
+        header.pixel_width  = packed ? texture_data.levels.front ().width  : color_buffer.get_width  ();
+        header.pixel_height = packed ? texture_data.levels.front ().height : color_buffer.get_height ();
+        header.data_size    = data_size;
+
+        std::shared_ptr< std::vector< byte > > contents = std::make_shared< std::vector< byte > > (sizeof(Header) + data_size);
+
+        std::memcpy (contents->data (), &header, sizeof(Header));
+        std::memcpy (contents->data () + sizeof(Header), pixels, data_size);
+
+        writer->submit
+        (
+            [directory, key, contents] ()
+            {
+                if (write_file (get_entry_path (directory, key), *contents))
+                {
+                    std::lock_guard< std::mutex > lock(state ().mutex);
+
+                    state ().statistics.writes++;
+                }
+            }
+        );
+    }
+
+}
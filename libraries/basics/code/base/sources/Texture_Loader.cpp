@@ -0,0 +1,176 @@
+/*
+ * TEXTURE LOADER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803201030
+ */
+
+#include <algorithm>
+#include <basics/Log>
+#include <basics/Texture_Loader>
+#include <basics/Texture_Registry>
+#include <basics/Timer>
+
+namespace basics
+{
+
+    Texture_Loader::Handle Texture_Loader::load (Id id, const std::string & asset_path, const Texture_2D::Options & options, const Callback & callback)
+    {
+        Handle task = std::make_shared< Task > (id, asset_path, options, callback);
+
+        pending_count++;
+
+        // Si la textura ya está cargada con las mismas opciones se comparte sin leer nada. Se entrega
+        // desde upload() igual que las demás:
+
+        task->texture = Texture_Registry::find (asset_path, options);
+
+        if (task->texture)
+        {
+            task->state = Task::READY;
+
+            std::lock_guard< std::mutex > lock(mutex);
+
+            decoded.push_back (task);
+
+            return task;
+        }
+
+        // Ni la lectura ni la decodificación usan el contexto gráfico, por lo que se hacen en otros
+        // hilos. El callback de la lectura solo encarga la decodificación para no retrasar el resto
+        // de lecturas:
+
+        asset_reader.read
+        (
+            asset_path,
+            [this, task] (const Asset_Reader::Read & read)
+            {
+                Asset::Mapping data = read.get_data ();
+
+                thread_pool.submit
+                (
+                    [this, task, data] ()
+                    {
+                        bool loaded = data.good () && Texture_2D::decode (data.get_data (), data.get_size (), task->image_options, task->color_buffer, task->texture_data);
+
+                        task->state = loaded ? Task::DECODED : Task::FAILED;
+
+                        std::lock_guard< std::mutex > lock(mutex);
+
+                        decoded.push_back (task);
+                    }
+                );
+            }
+        );
+
+        return task;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    unsigned Texture_Loader::upload (Graphics_Context::Accessor & context, float budget_in_milliseconds)
+    {
+        unsigned finished = 0;
+        Timer    timer;
+
+        while (finished == 0 || timer.get_elapsed_seconds () * 1000.f < budget_in_milliseconds)
+        {
+            Handle task;
+
+            {
+                std::lock_guard< std::mutex > lock(mutex);
+
+                if (decoded.empty ()) break;
+
+                task = decoded.front ();
+
+                decoded.pop_front ();
+            }
+
+            finish (context, task);
+
+            finished++;
+        }
+
+        return finished;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Texture_Loader::upload (Graphics_Context::Accessor & context, const Handle & task)
+    {
+        {
+            std::lock_guard< std::mutex > lock(mutex);
+
+            auto item = std::find (decoded.begin (), decoded.end (), task);
+
+            if (item == decoded.end ())
+            {
+                return task->finished;
+            }
+
+            decoded.erase (item);
+        }
+
+        finish (context, task);
+
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Texture_Loader::finish (Graphics_Context::Accessor & context, const Handle & task)
+    {
+        if (task->state == Task::DECODED)
+        {
+            task->texture = Texture_2D::create_loaded
+            (
+                task->id,
+                context,
+                task->asset_path,
+                task->options,
+                task->image_options,
+                task->color_buffer,
+                task->texture_data
+            );
+
+            // El contexto no retiene la textura para que se libere con el último handle:
+
+            if (task->texture && context->attach (task->texture))
+            {
+                task->texture = Texture_Registry::add (task->asset_path, task->options, task->texture);
+                task->state   = Task::READY;
+            }
+            else
+            {
+                task->texture.reset ();
+                task->state = Task::FAILED;
+            }
+
+            // Los píxeles ya están en la textura (o en la GPU):
+
+            task->color_buffer = Color_Buffer< Rgba8888 >();
+            task->texture_data = Texture_Data();
+        }
+
+        if (task->state == Task::FAILED)
+        {
+            basics::log.w ("Texture_Loader: failed to load " + task->asset_path + '.');
+        }
+
+        task->finished = true;
+
+        pending_count--;
+
+        if (task->callback)
+        {
+            task->callback (*task);
+        }
+    }
+
+}
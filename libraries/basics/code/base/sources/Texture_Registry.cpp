@@ -0,0 +1,205 @@
+/*
+ * TEXTURE REGISTRY
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803311000
+ */
+
+#include <map>
+#include <mutex>
+#include <utility>
+#include <basics/fnv>
+#include <basics/Texture_Registry>
+
+namespace basics
+{
+
+    namespace
+    {
+
+        typedef std::pair< uint64_t, uint64_t > Key;    ///< Hash de la ruta y hash de las opciones.
+
+        struct Entry
+        {
+            std::string                 asset_path;     ///< Para descartar colisiones de los hashes.
+            std::weak_ptr< Texture_2D > texture;
+        };
+
+        struct State
+        {
+            std::mutex                     mutex;
+            std::map< Key, Entry >         entries;
+            Texture_Registry::Statistics   statistics;
+        };
+
+        State & state ()
+        {
+            static State state;
+
+            return state;
+        }
+
+        Key make_key (const std::string & asset_path, const Texture_2D::Options & options)
+        {
+            // Se resumen los campos uno a uno para no depender del relleno de la estructura:
+
+            uint64_t values[] =
+            {
+                options.width,
+                options.height,
+                options.display_width,
+                options.display_height,
+                options.mipmaps,
+                uint64_t(options.format_policy),
+                uint64_t(options.pixel_retention)
+            };
+
+            return Key(fnv64 (asset_path), fnv64 (values, sizeof(values)));
+        }
+
+        /**
+         * Retorna la textura viva de la entrada de una clave y elimina la entrada si ya no existe.
+         * Se debe llamar con el mutex bloqueado.
+         */
+        Texture_Registry::Handle find_locked (const Key & key, const std::string & asset_path)
+        {
+            auto entry = state ().entries.find (key);
+
+            if (entry != state ().entries.end ())
+            {
+                Texture_Registry::Handle texture = entry->second.texture.lock ();
+
+                if (texture && entry->second.asset_path == asset_path)
+                {
+                    return texture;
+                }
+
+                if (!texture) state ().entries.erase (entry);
+            }
+
+            return nullptr;
+        }
+
+        Texture_Registry::Handle share (const Texture_Registry::Handle & texture)
+        {
+            Texture_Registry::Statistics & statistics = state ().statistics;
+
+            statistics.duplicates++;
+            statistics.bytes_saved += texture->get_byte_size ();
+
+            return texture;
+        }
+
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Texture_Registry::Handle Texture_Registry::acquire (Id id, Graphics_Context::Accessor & context, const std::string & asset_path, const Texture_2D::Options & options)
+    {
+        Key key = make_key (asset_path, options);
+
+        {
+            std::lock_guard< std::mutex > lock(state ().mutex);
+
+            Handle texture = find_locked (key, asset_path);
+
+            if (texture) return share (texture);
+        }
+
+        // La carga se hace sin bloquear el registro. Si mientras tanto otro hilo registra la misma
+        // textura, add() retorna esa y la cargada aquí se descarta:
+
+        Handle texture = Texture_2D::create (id, context, asset_path, options);
+
+        if (texture && context->attach (texture))
+        {
+            return add (asset_path, options, texture);
+        }
+
+        return nullptr;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Texture_Registry::Handle Texture_Registry::find (const std::string & asset_path, const Texture_2D::Options & options)
+    {
+        std::lock_guard< std::mutex > lock(state ().mutex);
+
+        Handle texture = find_locked (make_key (asset_path, options), asset_path);
+
+        return texture ? share (texture) : nullptr;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Texture_Registry::Handle Texture_Registry::add (const std::string & asset_path, const Texture_2D::Options & options, const Handle & texture)
+    {
+        if (!texture) return nullptr;
+
+        Key key = make_key (asset_path, options);
+
+        std::lock_guard< std::mutex > lock(state ().mutex);
+
+        Handle registered = find_locked (key, asset_path);
+
+        if (registered && registered != texture)
+        {
+            return share (registered);
+        }
+
+        // Una colisión de los hashes sustituye a la entrada anterior, que simplemente deja de
+        // compartirse:
+
+        state ().entries[key] = Entry{ asset_path, texture };
+        state ().statistics.loads++;
+
+        return texture;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    unsigned Texture_Registry::get_count ()
+    {
+        std::lock_guard< std::mutex > lock(state ().mutex);
+
+        unsigned count = 0;
+
+        for (auto entry = state ().entries.begin (); entry != state ().entries.end (); )
+        {
+            if (entry->second.texture.expired ())
+            {
+                entry = state ().entries.erase (entry);
+            }
+            else
+            {
+                ++count; ++entry;
+            }
+        }
+
+        return count;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Texture_Registry::Statistics Texture_Registry::get_statistics ()
+    {
+        std::lock_guard< std::mutex > lock(state ().mutex);
+
+        return state ().statistics;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Texture_Registry::reset_statistics ()
+    {
+        std::lock_guard< std::mutex > lock(state ().mutex);
+
+        state ().statistics = Statistics();
+    }
+
+}
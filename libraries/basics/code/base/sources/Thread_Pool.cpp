@@ -0,0 +1,115 @@
+/*
+ * THREAD POOL
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803201000
+ */
+
+#include <basics/Thread_Pool>
+
+namespace basics
+{
+
+    Thread_Pool::Thread_Pool(unsigned thread_count)
+    :
+        busy_count(0),
+        stopping  (false)
+    {
+        if (thread_count == 0)
+        {
+            unsigned cores = std::thread::hardware_concurrency ();
+
+            thread_count = cores > 1 ? cores - 1 : 1;
+        }
+
+        threads.reserve (thread_count);
+
+        for (unsigned index = 0; index < thread_count; ++index)
+        {
+            threads.emplace_back (&Thread_Pool::run, this);
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Thread_Pool::~Thread_Pool()
+    {
+        {
+            std::lock_guard< std::mutex > lock(mutex);
+
+            tasks.clear ();
+
+            stopping = true;
+        }
+
+        task_available.notify_all ();
+
+        for (auto & thread : threads)
+        {
+            thread.join ();
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Thread_Pool::submit (const Task & task)
+    {
+        {
+            std::lock_guard< std::mutex > lock(mutex);
+
+            tasks.push_back (task);
+        }
+
+        task_available.notify_one ();
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Thread_Pool::wait_idle ()
+    {
+        std::unique_lock< std::mutex > lock(mutex);
+
+        idle.wait (lock, [this] () { return tasks.empty () && busy_count == 0; });
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Thread_Pool::run ()
+    {
+        std::unique_lock< std::mutex > lock(mutex);
+
+        for (;;)
+        {
+            task_available.wait (lock, [this] () { return stopping || !tasks.empty (); });
+
+            if (stopping) break;
+
+            Task task = std::move (tasks.front ());
+
+            tasks.pop_front ();
+
+            busy_count++;
+
+            // La tarea se ejecuta sin retener el mutex para que el resto de hilos puedan avanzar:
+
+            lock.unlock ();
+
+            task ();
+
+            lock.lock ();
+
+            busy_count--;
+
+            if (tasks.empty () && busy_count == 0)
+            {
+                idle.notify_all ();
+            }
+        }
+    }
+
+}
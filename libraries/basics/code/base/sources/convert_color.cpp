@@ -0,0 +1,342 @@
+/*
+ * CONVERT COLOR
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803171000
+ */
+
+#include <algorithm>
+#include <vector>
+#include <basics/convert_color>
+#include <basics/macros>
+
+#if   defined(BASICS_SSE2_ENABLED)
+    #include <emmintrin.h>
+#elif defined(BASICS_NEON_ENABLED)
+    #include <arm_neon.h>
+#endif
+
+namespace basics
+{
+
+    namespace
+    {
+
+        /**
+         * Matriz de Bayer de 4x4 convertida en umbrales de redondeo en el rango [0, 255). Un umbral
+         * de 127 equivale a redondear al valor más cercano.
+         */
+        const uint16_t bayer_thresholds[4][4] =
+        {
+            {   8, 136,  40, 168 },
+            { 200,  72, 232, 104 },
+            {  56, 184,  24, 152 },
+            { 248, 120, 216,  88 }
+        };
+
+        const uint16_t rounding_threshold = 127;
+
+        /**
+         * Calcula (value * maximum + threshold) / 255, que reduce un componente de 8 bits a un
+         * componente con valor máximo maximum. La división por 255 se sustituye por sumas y
+         * desplazamientos, exactos para valores menores que 65535.
+         */
+        inline unsigned quantize (unsigned value, unsigned maximum, unsigned threshold)
+        {
+            unsigned x = value * maximum + threshold;
+
+            return (x + 1 + (x >> 8)) >> 8;
+        }
+
+        inline unsigned expand (unsigned value, unsigned maximum)
+        {
+            return maximum ? (value * 255 + maximum / 2) / maximum : 255;
+        }
+
+        template< class FORMAT >
+        inline uint16_t pack (unsigned r, unsigned g, unsigned b, unsigned a)
+        {
+            return uint16_t
+            (
+                r << FORMAT::red_shift   |
+                g << FORMAT::green_shift |
+                b << FORMAT::blue_shift  |
+                a << FORMAT::alpha_shift
+            );
+        }
+
+        // -----------------------------------------------------------------------------------------
+
+        /**
+         * Conversión con umbral por píxel (sin tramado o con tramado ordenado), que no tiene
+         * dependencias entre píxeles y se puede vectorizar.
+         */
+        template< class FORMAT >
+        void convert_thresholded (const Color_Buffer< Rgba8888 > & source, Color_Buffer< uint16_t > & target, bool ordered)
+        {
+            const unsigned red_maximum   = (1u << FORMAT::red_bits  ) - 1;
+            const unsigned green_maximum = (1u << FORMAT::green_bits) - 1;
+            const unsigned blue_maximum  = (1u << FORMAT::blue_bits ) - 1;
+            const unsigned alpha_maximum = (1u << FORMAT::alpha_bits) - 1;
+
+            // El alfa de 1 bit no se trama porque produciría bordes ruidosos:
+
+            const bool dither_alpha = ordered && FORMAT::alpha_bits > 1;
+
+            for (unsigned y = 0; y < source.height; ++y)
+            {
+                const Rgba8888 * input      = &source[y * source.width];
+                uint16_t       * output     = &target[y * source.width];
+                const uint16_t * thresholds = bayer_thresholds[y & 3];
+                unsigned         x          = 0;
+
+                #if defined(BASICS_SSE2_ENABLED)
+
+                    const __m128i mask  = _mm_set1_epi32 (0xFF);
+                    const __m128i one   = _mm_set1_epi16 (1);
+                    const __m128i color_threshold = ordered
+                        ? _mm_setr_epi16 (thresholds[0], thresholds[1], thresholds[2], thresholds[3], thresholds[0], thresholds[1], thresholds[2], thresholds[3])
+                        : _mm_set1_epi16 (rounding_threshold);
+                    const __m128i alpha_threshold = dither_alpha ? color_threshold : _mm_set1_epi16 (rounding_threshold);
+
+                    auto quantize_8 = [one] (__m128i values, int maximum, __m128i threshold) -> __m128i
+                    {
+                        __m128i x = _mm_add_epi16 (_mm_mullo_epi16 (values, _mm_set1_epi16 (short(maximum))), threshold);
+
+                        return _mm_srli_epi16 (_mm_add_epi16 (_mm_add_epi16 (x, one), _mm_srli_epi16 (x, 8)), 8);
+                    };
+
+                    for ( ; x + 8 <= source.width; x += 8)
+                    {
+                        __m128i pixels_0 = _mm_loadu_si128 (reinterpret_cast< const __m128i * >(input + x    ));
+                        __m128i pixels_1 = _mm_loadu_si128 (reinterpret_cast< const __m128i * >(input + x + 4));
+
+                        // Se separan los componentes en vectores de 8 valores de 16 bits:
+
+                        __m128i r = _mm_packs_epi32 (_mm_and_si128 (pixels_0, mask), _mm_and_si128 (pixels_1, mask));
+                        __m128i g = _mm_packs_epi32 (_mm_and_si128 (_mm_srli_epi32 (pixels_0,  8), mask), _mm_and_si128 (_mm_srli_epi32 (pixels_1,  8), mask));
+                        __m128i b = _mm_packs_epi32 (_mm_and_si128 (_mm_srli_epi32 (pixels_0, 16), mask), _mm_and_si128 (_mm_srli_epi32 (pixels_1, 16), mask));
+                        __m128i a = _mm_packs_epi32 (_mm_srli_epi32 (pixels_0, 24), _mm_srli_epi32 (pixels_1, 24));
+
+                        __m128i packed = _mm_or_si128
+                        (
+                            _mm_or_si128
+                            (
+                                _mm_slli_epi16 (quantize_8 (r, red_maximum,   color_threshold), FORMAT::red_shift  ),
+                                _mm_slli_epi16 (quantize_8 (g, green_maximum, color_threshold), FORMAT::green_shift)
+                            ),
+                            _mm_or_si128
+                            (
+                                _mm_slli_epi16 (quantize_8 (b, blue_maximum,  color_threshold), FORMAT::blue_shift ),
+                                _mm_slli_epi16 (quantize_8 (a, alpha_maximum, alpha_threshold), FORMAT::alpha_shift)
+                            )
+                        );
+
+                        _mm_storeu_si128 (reinterpret_cast< __m128i * >(output + x), packed);
+                    }
+
+                #elif defined(BASICS_NEON_ENABLED)
+
+                    const uint16x8_t color_threshold = ordered
+                        ? vcombine_u16 (vld1_u16 (thresholds), vld1_u16 (thresholds))
+                        : vdupq_n_u16 (rounding_threshold);
+                    const uint16x8_t alpha_threshold = dither_alpha ? color_threshold : vdupq_n_u16 (rounding_threshold);
+
+                    auto quantize_8 = [] (uint8x8_t values, unsigned maximum, uint16x8_t threshold) -> uint16x8_t
+                    {
+                        uint16x8_t x = vaddq_u16 (vmull_u8 (values, vdup_n_u8 (uint8_t(maximum))), threshold);
+
+                        return vshrq_n_u16 (vaddq_u16 (vaddq_u16 (x, vdupq_n_u16 (1)), vshrq_n_u16 (x, 8)), 8);
+                    };
+
+                    for ( ; x + 8 <= source.width; x += 8)
+                    {
+                        // vld4 separa los componentes de 8 píxeles:
+
+                        uint8x8x4_t pixels = vld4_u8 (reinterpret_cast< const uint8_t * >(input + x));
+
+                        uint16x8_t packed = vorrq_u16
+                        (
+                            vorrq_u16
+                            (
+                                vshlq_n_u16 (quantize_8 (pixels.val[0], red_maximum,   color_threshold), FORMAT::red_shift  ),
+                                vshlq_n_u16 (quantize_8 (pixels.val[1], green_maximum, color_threshold), FORMAT::green_shift)
+                            ),
+                            vorrq_u16
+                            (
+                                vshlq_n_u16 (quantize_8 (pixels.val[2], blue_maximum,  color_threshold), FORMAT::blue_shift ),
+                                vshlq_n_u16 (quantize_8 (pixels.val[3], alpha_maximum, alpha_threshold), FORMAT::alpha_shift)
+                            )
+                        );
+
+                        vst1q_u16 (output + x, packed);
+                    }
+
+                #endif
+
+                for ( ; x < source.width; ++x)
+                {
+                    Rgba8888 pixel           = input[x];
+                    unsigned color_threshold = ordered      ? thresholds[x & 3] : rounding_threshold;
+                    unsigned alpha_threshold = dither_alpha ? thresholds[x & 3] : rounding_threshold;
+
+                    output[x] = pack< FORMAT >
+                    (
+                        quantize ((pixel      ) & 0xFF, red_maximum,   color_threshold),
+                        quantize ((pixel >>  8) & 0xFF, green_maximum, color_threshold),
+                        quantize ((pixel >> 16) & 0xFF, blue_maximum,  color_threshold),
+                        quantize ((pixel >> 24)       , alpha_maximum, alpha_threshold)
+                    );
+                }
+            }
+        }
+
+        // -----------------------------------------------------------------------------------------
+
+        /**
+         * Conversión con difusión del error de Floyd-Steinberg: el error de cuantización de cada
+         * píxel se reparte entre sus vecinos todavía no procesados (7/16 a la derecha y 3/16, 5/16
+         * y 1/16 en la fila siguiente).
+         */
+        template< class FORMAT >
+        void convert_diffused (const Color_Buffer< Rgba8888 > & source, Color_Buffer< uint16_t > & target)
+        {
+            const unsigned maximums[4] =
+            {
+                (1u << FORMAT::red_bits  ) - 1,
+                (1u << FORMAT::green_bits) - 1,
+                (1u << FORMAT::blue_bits ) - 1,
+                (1u << FORMAT::alpha_bits) - 1
+            };
+
+            // Errores acumulados (multiplicados por 16) de la fila actual y de la siguiente, con una
+            // columna de margen a cada lado para no tener que comprobar los bordes:
+
+            std::vector< int > current((source.width + 2) * 4, 0);
+            std::vector< int > next   ((source.width + 2) * 4, 0);
+
+            for (unsigned y = 0; y < source.height; ++y)
+            {
+                const Rgba8888 * input  = &source[y * source.width];
+                uint16_t       * output = &target[y * source.width];
+
+                std::fill (next.begin (), next.end (), 0);
+
+                for (unsigned x = 0; x < source.width; ++x)
+                {
+                    unsigned quantized[4];
+
+                    for (unsigned channel = 0; channel < 4; ++channel)
+                    {
+                        int   * error    = &current[(x + 1) * 4 + channel];
+                        int     original = int((input[x] >> (channel * 8)) & 0xFF);
+                        int     value    = std::min (std::max (original + (*error + 8) / 16, 0), 255);
+
+                        // El alfa de 1 bit no se trama:
+
+                        if (channel == 3 && FORMAT::alpha_bits <= 1) value = original;
+
+                        quantized[channel] = quantize (unsigned(value), maximums[channel], rounding_threshold);
+
+                        int residual = value - int(expand (quantized[channel], maximums[channel]));
+
+                        if (maximums[channel] == 0) residual = 0;
+
+                        error[4]                          += residual * 7;
+                        next[(x    ) * 4 + channel]       += residual * 3;
+                        next[(x + 1) * 4 + channel]       += residual * 5;
+                        next[(x + 2) * 4 + channel]       += residual;
+                    }
+
+                    output[x] = pack< FORMAT > (quantized[0], quantized[1], quantized[2], quantized[3]);
+                }
+
+                current.swap (next);
+            }
+        }
+
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    template< class FORMAT >
+    void convert (const Color_Buffer< Rgba8888 > & source, Color_Buffer< typename FORMAT::Color > & target, Dithering dithering)
+    {
+        target.resize (source.width, source.height);
+
+        if (source.size () == 0)
+        {
+            return;
+        }
+
+        if (dithering == Dithering::ERROR_DIFFUSION)
+        {
+            convert_diffused< FORMAT > (source, target);
+        }
+        else
+        {
+            convert_thresholded< FORMAT > (source, target, dithering == Dithering::ORDERED);
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    template< class FORMAT >
+    void convert (const Color_Buffer< typename FORMAT::Color > & source, Color_Buffer< Rgba8888 > & target)
+    {
+        const unsigned red_maximum   = (1u << FORMAT::red_bits  ) - 1;
+        const unsigned green_maximum = (1u << FORMAT::green_bits) - 1;
+        const unsigned blue_maximum  = (1u << FORMAT::blue_bits ) - 1;
+        const unsigned alpha_maximum = (1u << FORMAT::alpha_bits) - 1;
+
+        target.resize (source.width, source.height);
+
+        for (unsigned index = 0, count = source.size (); index < count; ++index)
+        {
+            unsigned pixel = source[index];
+
+            target[index] =
+                Rgba8888(expand ((pixel >> FORMAT::red_shift  ) & red_maximum,   red_maximum  ))       |
+                Rgba8888(expand ((pixel >> FORMAT::green_shift) & green_maximum, green_maximum)) <<  8 |
+                Rgba8888(expand ((pixel >> FORMAT::blue_shift ) & blue_maximum,  blue_maximum )) << 16 |
+                Rgba8888(expand ((pixel >> FORMAT::alpha_shift) & alpha_maximum, alpha_maximum)) << 24;
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Alpha_Usage analyze_alpha (const Color_Buffer< Rgba8888 > & color_buffer)
+    {
+        Alpha_Usage usage = Alpha_Usage::OPAQUE;
+
+        for (unsigned index = 0, count = color_buffer.size (); index < count; ++index)
+        {
+            unsigned alpha = color_buffer[index] >> 24;
+
+            if (alpha != 255)
+            {
+                if (alpha != 0) return Alpha_Usage::TRANSLUCENT;
+
+                usage = Alpha_Usage::BINARY;
+            }
+        }
+
+        return usage;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    template void convert< Rgb565_Format   > (const Color_Buffer< Rgba8888 > &, Color_Buffer< uint16_t > &, Dithering);
+    template void convert< Rgba4444_Format > (const Color_Buffer< Rgba8888 > &, Color_Buffer< uint16_t > &, Dithering);
+    template void convert< Rgba5551_Format > (const Color_Buffer< Rgba8888 > &, Color_Buffer< uint16_t > &, Dithering);
+
+    template void convert< Rgb565_Format   > (const Color_Buffer< uint16_t > &, Color_Buffer< Rgba8888 > &);
+    template void convert< Rgba4444_Format > (const Color_Buffer< uint16_t > &, Color_Buffer< Rgba8888 > &);
+    template void convert< Rgba5551_Format > (const Color_Buffer< uint16_t > &, Color_Buffer< Rgba8888 > &);
+
+}
@@ -0,0 +1,350 @@
+/*
+ * ETC DECODE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803161000
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <basics/convert_color>
+#include <basics/etc_decode>
+
+// Implementación basada en la especificación de OpenGL ES 3.0 (apartado C.1, "ETC Compressed
+// Texture Image Formats"). Los bloques de 4x4 píxeles se almacenan en big-endian y los índices de
+// los píxeles recorren el bloque por columnas.
+
+namespace basics
+{
+
+    namespace
+    {
+
+        const int etc1_modifiers[8][2] =
+        {
+            {  2,   8 }, {  5,  17 }, {  9,  29 }, { 13,  42 },
+            { 18,  60 }, { 24,  80 }, { 33, 106 }, { 47, 183 }
+        };
+
+        const int etc2_distances[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+
+        const int eac_modifiers[16][8] =
+        {
+            { -3, -6,  -9, -15, 2, 5, 8, 14 },
+            { -3, -7, -10, -13, 2, 6, 9, 12 },
+            { -2, -5,  -8, -13, 1, 4, 7, 12 },
+            { -2, -4,  -6, -13, 1, 3, 5, 12 },
+            { -3, -6,  -8, -12, 2, 5, 7, 11 },
+            { -3, -7,  -9, -11, 2, 6, 8, 10 },
+            { -4, -7,  -8, -11, 3, 6, 7, 10 },
+            { -3, -5,  -8, -11, 2, 4, 7, 10 },
+            { -2, -6,  -8, -10, 1, 5, 7,  9 },
+            { -2, -5,  -8, -10, 1, 4, 7,  9 },
+            { -2, -4,  -8, -10, 1, 3, 7,  9 },
+            { -2, -5,  -7, -10, 1, 4, 6,  9 },
+            { -3, -4,  -7, -10, 2, 3, 6,  9 },
+            { -1, -2,  -3, -10, 0, 1, 2,  9 },
+            { -4, -6,  -8,  -9, 3, 5, 7,  8 },
+            { -3, -5,  -7,  -9, 2, 4, 6,  8 }
+        };
+
+        typedef Rgba8888 Block[16];                     ///< Píxeles de un bloque indexados por x * 4 + y.
+
+        inline int clamp_255 (int value)
+        {
+            return value < 0 ? 0 : value > 255 ? 255 : value;
+        }
+
+        inline Rgba8888 pack (int r, int g, int b, int a = 255)
+        {
+            return Rgba8888(clamp_255 (r)) | Rgba8888(clamp_255 (g)) << 8 | Rgba8888(clamp_255 (b)) << 16 | Rgba8888(a) << 24;
+        }
+
+        inline Rgba8888 offset (Rgba8888 color, int delta)
+        {
+            return pack (int(color & 0xFF) + delta, int((color >> 8) & 0xFF) + delta, int((color >> 16) & 0xFF) + delta);
+        }
+
+        inline int extend_4 (int value) { return value << 4 | value;        }
+        inline int extend_5 (int value) { return value << 3 | value >> 2;   }
+        inline int extend_6 (int value) { return value << 2 | value >> 4;   }
+        inline int extend_7 (int value) { return value << 1 | value >> 6;   }
+
+        inline int sign_extend_3 (int value)
+        {
+            return value >= 4 ? value - 8 : value;
+        }
+
+        /**
+         * Modos T y H: cuatro colores de pintura de los que cada píxel elige uno.
+         */
+        void decode_paint (const byte * bytes, const Rgba8888 (& paint)[4], bool punchthrough, Block & block)
+        {
+            uint32_t indices = uint32_t(bytes[4]) << 24 | uint32_t(bytes[5]) << 16 | uint32_t(bytes[6]) << 8 | bytes[7];
+
+            for (unsigned pixel = 0; pixel < 16; ++pixel)
+            {
+                unsigned index = ((indices >> (pixel + 15)) & 2) | ((indices >> pixel) & 1);
+
+                block[pixel] = punchthrough && index == 2 ? 0 : paint[index];
+            }
+        }
+
+        void decode_t_mode (const byte * bytes, bool punchthrough, Block & block)
+        {
+            int r1 = (bytes[0] >> 3 & 3) << 2 | (bytes[0] & 3);
+            int g1 =  bytes[1] >> 4;
+            int b1 =  bytes[1] & 15;
+            int r2 =  bytes[2] >> 4;
+            int g2 =  bytes[2] & 15;
+            int b2 =  bytes[3] >> 4;
+            int d  =  etc2_distances[(bytes[3] >> 2 & 3) << 1 | (bytes[3] & 1)];
+
+            Rgba8888 color_2 = pack (extend_4 (r2), extend_4 (g2), extend_4 (b2));
+
+            const Rgba8888 paint[4] =
+            {
+                pack   (extend_4 (r1), extend_4 (g1), extend_4 (b1)),
+                offset (color_2,  d),
+                color_2,
+                offset (color_2, -d)
+            };
+
+            decode_paint (bytes, paint, punchthrough, block);
+        }
+
+        void decode_h_mode (const byte * bytes, bool punchthrough, Block & block)
+        {
+            int r1 =  bytes[0] >> 3 & 15;
+            int g1 = (bytes[0] & 7) << 1 | (bytes[1] >> 4 & 1);
+            int b1 = (bytes[1] & 8) | (bytes[1] & 3) << 1 | bytes[2] >> 7;
+            int r2 =  bytes[2] >> 3 & 15;
+            int g2 = (bytes[2] & 7) << 1 | bytes[3] >> 7;
+            int b2 =  bytes[3] >> 3 & 15;
+
+            // El bit menos significativo de la distancia está implícito en el orden de los colores:
+
+            int order = (r1 << 8 | g1 << 4 | b1) >= (r2 << 8 | g2 << 4 | b2) ? 1 : 0;
+            int d     = etc2_distances[(bytes[3] & 4) | (bytes[3] & 1) << 1 | order];
+
+            Rgba8888 color_1 = pack (extend_4 (r1), extend_4 (g1), extend_4 (b1));
+            Rgba8888 color_2 = pack (extend_4 (r2), extend_4 (g2), extend_4 (b2));
+
+            const Rgba8888 paint[4] =
+            {
+                offset (color_1,  d),
+                offset (color_1, -d),
+                offset (color_2,  d),
+                offset (color_2, -d)
+            };
+
+            decode_paint (bytes, paint, punchthrough, block);
+        }
+
+        void decode_planar_mode (const byte * bytes, Block & block)
+        {
+            int ro = extend_6 ( bytes[0] >> 1 & 63);
+            int go = extend_7 ((bytes[0] & 1) << 6 | (bytes[1] >> 1 & 63));
+            int bo = extend_6 ((bytes[1] & 1) << 5 | (bytes[2] >> 3 & 3) << 3 | (bytes[2] & 3) << 1 | bytes[3] >> 7);
+            int rh = extend_6 ((bytes[3] >> 2 & 31) << 1 | (bytes[3] & 1));
+            int gh = extend_7 ( bytes[4] >> 1);
+            int bh = extend_6 ((bytes[4] & 1) << 5 | bytes[5] >> 3);
+            int rv = extend_6 ((bytes[5] & 7) << 3 | bytes[6] >> 5);
+            int gv = extend_7 ((bytes[6] & 31) << 2 | bytes[7] >> 6);
+            int bv = extend_6 ( bytes[7] & 63);
+
+            for (int x = 0; x < 4; ++x)
+            {
+                for (int y = 0; y < 4; ++y)
+                {
+                    block[x * 4 + y] = pack
+                    (
+                        (x * (rh - ro) + y * (rv - ro) + 4 * ro + 2) >> 2,
+                        (x * (gh - go) + y * (gv - go) + 4 * go + 2) >> 2,
+                        (x * (bh - bo) + y * (bv - bo) + 4 * bo + 2) >> 2
+                    );
+                }
+            }
+        }
+
+        /**
+         * Decodifica un bloque de color de 64 bits.
+         * @param etc2 Si es false se interpreta como ETC1 (sin modos T, H y planar).
+         * @param punchthrough Si es true (RGB8A1) el bit "diff" indica si el bloque es opaco.
+         */
+        void decode_color_block (const byte * bytes, bool etc2, bool punchthrough, Block & block)
+        {
+            bool differential = punchthrough || (bytes[3] & 2) != 0;
+            bool transparent  = punchthrough && (bytes[3] & 2) == 0;
+            bool flip         = (bytes[3] & 1) != 0;
+
+            Rgba8888 base[2];
+
+            if (differential)
+            {
+                int r = bytes[0] >> 3, dr = sign_extend_3 (bytes[0] & 7);
+                int g = bytes[1] >> 3, dg = sign_extend_3 (bytes[1] & 7);
+                int b = bytes[2] >> 3, db = sign_extend_3 (bytes[2] & 7);
+
+                // En ETC2 los desbordamientos de la diferencia seleccionan los modos adicionales:
+
+                if (etc2)
+                {
+                    if (r + dr < 0 || r + dr > 31) { decode_t_mode      (bytes, transparent, block); return; }
+                    if (g + dg < 0 || g + dg > 31) { decode_h_mode      (bytes, transparent, block); return; }
+                    if (b + db < 0 || b + db > 31) { decode_planar_mode (bytes,              block); return; }
+                }
+
+                base[0] = pack (extend_5 (r     ), extend_5 (g     ), extend_5 (b     ));
+                base[1] = pack (extend_5 (r + dr), extend_5 (g + dg), extend_5 (b + db));
+            }
+            else
+            {
+                base[0] = pack (extend_4 (bytes[0] >> 4), extend_4 (bytes[1] >> 4), extend_4 (bytes[2] >> 4));
+                base[1] = pack (extend_4 (bytes[0] & 15), extend_4 (bytes[1] & 15), extend_4 (bytes[2] & 15));
+            }
+
+            const int * modifiers[2] = { etc1_modifiers[bytes[3] >> 5], etc1_modifiers[bytes[3] >> 2 & 7] };
+
+            uint32_t indices = uint32_t(bytes[4]) << 24 | uint32_t(bytes[5]) << 16 | uint32_t(bytes[6]) << 8 | bytes[7];
+
+            for (unsigned x = 0; x < 4; ++x)
+            {
+                for (unsigned y = 0; y < 4; ++y)
+                {
+                    unsigned pixel    = x * 4 + y;
+                    unsigned subblock = flip ? (y >= 2) : (x >= 2);
+                    unsigned msb      = indices >> (pixel + 16) & 1;
+                    unsigned lsb      = indices >>  pixel       & 1;
+
+                    // En los bloques RGB8A1 no opacos el índice 2 es transparente y los modificadores
+                    // pequeños se anulan:
+
+                    if (transparent && msb && !lsb)
+                    {
+                        block[pixel] = 0;
+                        continue;
+                    }
+
+                    int modifier = transparent && !lsb ? 0 : modifiers[subblock][lsb];
+
+                    block[pixel] = offset (base[subblock], msb ? -modifier : modifier);
+                }
+            }
+        }
+
+        /**
+         * Decodifica un bloque de alfa EAC de 64 bits y sustituye el alfa de los píxeles.
+         */
+        void decode_alpha_block (const byte * bytes, Block & block)
+        {
+            int        base       = bytes[0];
+            int        multiplier = bytes[1] >> 4;
+            const int * modifiers = eac_modifiers[bytes[1] & 15];
+
+            uint64_t indices = 0;
+
+            for (unsigned index = 2; index < 8; ++index) indices = indices << 8 | bytes[index];
+
+            for (unsigned pixel = 0; pixel < 16; ++pixel)
+            {
+                int alpha = clamp_255 (base + modifiers[indices >> (45 - 3 * pixel) & 7] * multiplier);
+
+                block[pixel] = (block[pixel] & 0x00FFFFFF) | Rgba8888(alpha) << 24;
+            }
+        }
+
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool etc_decode (const Texture_Data & texture_data, unsigned level, Color_Buffer< Rgba8888 > & color_buffer)
+    {
+        if (level >= texture_data.levels.size ())
+        {
+            return false;
+        }
+
+        const Texture_Data::Level & source = texture_data.levels[level];
+
+        if (source.data.size () < Texture_Data::get_level_size (texture_data.format, source.width, source.height))
+        {
+            return false;
+        }
+
+        color_buffer.resize (source.width, source.height);
+
+        if (texture_data.format == Texture_Data::RGBA8888)
+        {
+            std::memcpy (&color_buffer[0], source.data.data (), size_t(source.width) * source.height * 4);
+
+            return true;
+        }
+
+        if (texture_data.is_16_bit ())
+        {
+            Color_Buffer< uint16_t > packed(source.width, source.height);
+
+            std::memcpy (&packed[0], source.data.data (), size_t(source.width) * source.height * 2);
+
+            switch (texture_data.format)
+            {
+                case Texture_Data::RGB565:   convert< Rgb565_Format   > (packed, color_buffer); break;
+                case Texture_Data::RGBA4444: convert< Rgba4444_Format > (packed, color_buffer); break;
+                default:                     convert< Rgba5551_Format > (packed, color_buffer); break;
+            }
+
+            return true;
+        }
+
+        const bool   etc2         = texture_data.format != Texture_Data::ETC1_RGB8;
+        const bool   punchthrough = texture_data.format == Texture_Data::ETC2_RGB8A1;
+        const bool   eac          = texture_data.format == Texture_Data::ETC2_RGBA8;
+        const byte * bytes        = source.data.data ();
+
+        Block block;
+
+        for (unsigned block_y = 0; block_y < source.height; block_y += 4)
+        {
+            for (unsigned block_x = 0; block_x < source.width; block_x += 4)
+            {
+                if (eac)
+                {
+                    decode_color_block (bytes + 8, etc2, false, block);
+                    decode_alpha_block (bytes,                  block);
+
+                    bytes += 16;
+                }
+                else
+                {
+                    decode_color_block (bytes, etc2, punchthrough, block);
+
+                    bytes += 8;
+                }
+
+                // Se copian los píxeles del bloque que caen dentro de la imagen:
+
+                unsigned columns = std::min (4u, source.width  - block_x);
+                unsigned rows    = std::min (4u, source.height - block_y);
+
+                for (unsigned y = 0; y < rows; ++y)
+                {
+                    Rgba8888 * target = &color_buffer[(block_y + y) * source.width + block_x];
+
+                    for (unsigned x = 0; x < columns; ++x)
+                    {
+                        target[x] = block[x * 4 + y];
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+}
@@ -0,0 +1,213 @@
+/*
+ * KTX DECODE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803161000
+ */
+
+#include <cstring>
+#include <basics/ktx_decode>
+
+namespace basics
+{
+
+    namespace
+    {
+
+        const byte ktx_identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+        // Constantes de OpenGL usadas en la cabecera (no se incluyen los headers de GL porque este
+        // módulo no depende de ellos):
+
+        enum : uint32_t
+        {
+            GL_UNSIGNED_BYTE_VALUE                            = 0x1401,
+            GL_UNSIGNED_SHORT_4_4_4_4_VALUE                   = 0x8033,
+            GL_UNSIGNED_SHORT_5_5_5_1_VALUE                   = 0x8034,
+            GL_UNSIGNED_SHORT_5_6_5_VALUE                     = 0x8363,
+            GL_RGB_VALUE                                      = 0x1907,
+            GL_RGBA_VALUE                                     = 0x1908,
+            GL_RGBA8_VALUE                                    = 0x8058,
+            GL_ETC1_RGB8_OES_VALUE                            = 0x8D64,
+            GL_COMPRESSED_RGB8_ETC2_VALUE                     = 0x9274,
+            GL_COMPRESSED_SRGB8_ETC2_VALUE                    = 0x9275,
+            GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2_VALUE = 0x9276,
+            GL_COMPRESSED_RGBA8_ETC2_EAC_VALUE                = 0x9278,
+        };
+
+        struct Header
+        {
+            uint32_t endianness;
+            uint32_t gl_type;
+            uint32_t gl_type_size;
+            uint32_t gl_format;
+            uint32_t gl_internal_format;
+            uint32_t gl_base_internal_format;
+            uint32_t pixel_width;
+            uint32_t pixel_height;
+            uint32_t pixel_depth;
+            uint32_t number_of_array_elements;
+            uint32_t number_of_faces;
+            uint32_t number_of_mipmap_levels;
+            uint32_t bytes_of_key_value_data;
+        };
+
+        inline uint32_t swap_bytes (uint32_t value)
+        {
+            return (value >> 24) | ((value >> 8) & 0xFF00) | ((value << 8) & 0xFF0000) | (value << 24);
+        }
+
+        bool get_format (const Header & header, Texture_Data::Format & format)
+        {
+            switch (header.gl_internal_format)
+            {
+                case GL_ETC1_RGB8_OES_VALUE:                             format = Texture_Data::ETC1_RGB8;   return true;
+                case GL_COMPRESSED_RGB8_ETC2_VALUE:
+                case GL_COMPRESSED_SRGB8_ETC2_VALUE:                     format = Texture_Data::ETC2_RGB8;   return true;
+                case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2_VALUE:  format = Texture_Data::ETC2_RGB8A1; return true;
+                case GL_COMPRESSED_RGBA8_ETC2_EAC_VALUE:                 format = Texture_Data::ETC2_RGBA8;  return true;
+
+                case GL_RGB_VALUE:
+                {
+                    if (header.gl_type == GL_UNSIGNED_SHORT_5_6_5_VALUE && header.gl_format == GL_RGB_VALUE)
+                    {
+                        format = Texture_Data::RGB565;
+                        return true;
+                    }
+
+                    break;
+                }
+
+                case GL_RGBA_VALUE:
+                case GL_RGBA8_VALUE:
+                {
+                    if (header.gl_format == GL_RGBA_VALUE)
+                    {
+                        switch (header.gl_type)
+                        {
+                            case GL_UNSIGNED_BYTE_VALUE:          format = Texture_Data::RGBA8888; return true;
+                            case GL_UNSIGNED_SHORT_4_4_4_4_VALUE: format = Texture_Data::RGBA4444; return true;
+                            case GL_UNSIGNED_SHORT_5_5_5_1_VALUE: format = Texture_Data::RGBA5551; return true;
+                        }
+                    }
+
+                    break;
+                }
+            }
+
+            return false;
+        }
+
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool is_ktx (const byte * encoded_data, size_t size)
+    {
+        return size >= sizeof(ktx_identifier) && std::memcmp (encoded_data, ktx_identifier, sizeof(ktx_identifier)) == 0;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool ktx_decode (const byte * encoded_data, size_t size, Texture_Data & texture_data)
+    {
+        if (!is_ktx (encoded_data, size) || size < sizeof(ktx_identifier) + sizeof(Header))
+        {
+            return false;
+        }
+
+        Header header;
+
+        std::memcpy (&header, encoded_data + sizeof(ktx_identifier), sizeof(Header));
+
+        // Si el archivo se escribió en una máquina con otro orden de bytes, se invierten los campos
+        // de la cabecera y los tamaños de los niveles (los datos comprimidos se leen byte a byte):
+
+        bool swapped = header.endianness == 0x01020304;
+
+        if (swapped)
+        {
+            uint32_t * fields = reinterpret_cast< uint32_t * >(&header);
+
+            for (size_t index = 0; index < sizeof(Header) / sizeof(uint32_t); ++index)
+            {
+                fields[index] = swap_bytes (fields[index]);
+            }
+        }
+
+        if (header.endianness != 0x04030201)
+        {
+            return false;
+        }
+
+        // Solo se admiten texturas 2D simples (sin caras de cubemap, arrays ni profundidad):
+
+        if
+        (
+            header.pixel_width  == 0 || header.pixel_depth             > 1 ||
+            header.pixel_height == 0 || header.number_of_array_elements > 0 ||
+            header.number_of_faces != 1
+        )
+        {
+            return false;
+        }
+
+        Texture_Data::Format format;
+
+        if (!get_format (header, format))
+        {
+            return false;
+        }
+
+        size_t   offset      = sizeof(ktx_identifier) + sizeof(Header) + header.bytes_of_key_value_data;
+        unsigned level_count = header.number_of_mipmap_levels ? header.number_of_mipmap_levels : 1;
+        unsigned width       = header.pixel_width;
+        unsigned height      = header.pixel_height;
+
+        texture_data.format = format;
+        texture_data.levels.clear ();
+
+        for (unsigned level = 0; level < level_count; ++level)
+        {
+            uint32_t image_size;
+
+            if (offset + sizeof(image_size) > size)
+            {
+                return false;
+            }
+
+            std::memcpy (&image_size, encoded_data + offset, sizeof(image_size));
+
+            if (swapped) image_size = swap_bytes (image_size);
+
+            offset += sizeof(image_size);
+
+            if (image_size < Texture_Data::get_level_size (format, width, height) || offset + image_size > size)
+            {
+                return false;
+            }
+
+            texture_data.levels.push_back
+            ({
+                width,
+                height,
+                std::vector< byte >(encoded_data + offset, encoded_data + offset + image_size)
+            });
+
+            // Cada nivel se rellena hasta un múltiplo de 4 bytes:
+
+            offset += (image_size + 3) & ~size_t(3);
+
+            width  = width  > 1 ? width  / 2 : 1;
+            height = height > 1 ? height / 2 : 1;
+        }
+
+        return true;
+    }
+
+}
@@ -0,0 +1,184 @@
+/*
+ * LZ4
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803251000
+ */
+
+#include <cstring>
+#include <basics/lz4>
+
+namespace basics
+{
+
+    namespace
+    {
+
+        const size_t   min_match          = 4;
+        const size_t   last_literals      = 5;          ///< El formato exige que los últimos bytes sean literales.
+        const size_t   match_start_limit  = 12;         ///< Y que la última coincidencia empiece antes de estos bytes finales.
+        const size_t   max_offset         = 65535;
+        const unsigned hash_bits          = 14;
+
+        inline uint32_t read_u32 (const byte * pointer)
+        {
+            uint32_t value;
+            std::memcpy (&value, pointer, sizeof(value));
+            return value;
+        }
+
+        inline unsigned hash (uint32_t sequence)
+        {
+            return (sequence * 2654435761u) >> (32 - hash_bits);
+        }
+
+        void write_length (std::vector< byte > & output, size_t length)
+        {
+            for ( ; length >= 255; length -= 255) output.push_back (255);
+
+            output.push_back (byte(length));
+        }
+
+        void write_sequence (std::vector< byte > & output, const byte * literals, size_t literal_count, size_t offset, size_t match_length)
+        {
+            size_t match_code = match_length ? match_length - min_match : 0;
+
+            output.push_back (byte((literal_count < 15 ? literal_count : 15) << 4 | (match_code < 15 ? match_code : 15)));
+
+            if (literal_count >= 15) write_length (output, literal_count - 15);
+
+            output.insert (output.end (), literals, literals + literal_count);
+
+            if (match_length)
+            {
+                output.push_back (byte(offset     ));
+                output.push_back (byte(offset >> 8));
+
+                if (match_code >= 15) write_length (output, match_code - 15);
+            }
+        }
+
+        inline bool read_length (const byte *& input, const byte * input_end, size_t & length)
+        {
+            byte value;
+
+            do
+            {
+                if (input >= input_end) return false;
+
+                length += value = *input++;
+            }
+            while (value == 255);
+
+            return true;
+        }
+
+    }
+
+    void lz4_compress (const byte * data, size_t size, std::vector< byte > & compressed_data)
+    {
+        compressed_data.clear ();
+        compressed_data.reserve (size + size / 255 + 16);
+
+        size_t anchor = 0;
+
+        if (size > match_start_limit)
+        {
+            // Cada entrada de la tabla guarda la última posición (más uno) en la que apareció una
+            // secuencia de 4 bytes con ese hash:
+
+            std::vector< uint32_t > table(size_t(1) << hash_bits, 0);
+
+            size_t limit = size - match_start_limit;
+
+            for (size_t position = 0; position < limit; )
+            {
+                uint32_t sequence  = read_u32 (data + position);
+                uint32_t & slot    = table[hash (sequence)];
+                size_t   candidate = slot;
+
+                slot = uint32_t(position + 1);
+
+                if (candidate-- > 0 && position - candidate <= max_offset && read_u32 (data + candidate) == sequence)
+                {
+                    size_t length     = min_match;
+                    size_t max_length = size - last_literals - position;
+
+                    while (length < max_length && data[candidate + length] == data[position + length]) ++length;
+
+                    write_sequence (compressed_data, data + anchor, position - anchor, position - candidate, length);
+
+                    position += length;
+                    anchor    = position;
+                }
+                else
+                    ++position;
+            }
+        }
+
+        write_sequence (compressed_data, data + anchor, size - anchor, 0, 0);
+    }
+
+    bool lz4_decompress (const byte * compressed_data, size_t size, byte * decompressed_data, size_t decompressed_size)
+    {
+        const byte * input      = compressed_data;
+        const byte * input_end  = compressed_data + size;
+        byte       * output     = decompressed_data;
+        byte       * output_end = decompressed_data + decompressed_size;
+
+        while (input < input_end)
+        {
+            unsigned token   = *input++;
+            size_t   literal_count = token >> 4;
+
+            if (literal_count == 15 && !read_length (input, input_end, literal_count)) return false;
+
+            if (literal_count > size_t(input_end - input) || literal_count > size_t(output_end - output)) return false;
+
+            if (literal_count) std::memcpy (output, input, literal_count);
+
+            output += literal_count;
+            input  += literal_count;
+
+            // La última secuencia solo tiene literales:
+
+            if (input == input_end) break;
+
+            if (input_end - input < 2) return false;
+
+            size_t offset = size_t(input[0]) | size_t(input[1]) << 8;
+            size_t length = token & 15;
+
+            input += 2;
+
+            if (length == 15 && !read_length (input, input_end, length)) return false;
+
+            length += min_match;
+
+            if (offset == 0 || offset > size_t(output - decompressed_data) || length > size_t(output_end - output)) return false;
+
+            const byte * match = output - offset;
+
+            if (offset >= length)
+            {
+                std::memcpy (output, match, length);
+
+                output += length;
+            }
+            else
+            {
+                // Las coincidencias que se solapan con lo que se está escribiendo repiten un patrón:
+
+                for (byte * end = output + length; output < end; ) *output++ = *match++;
+            }
+        }
+
+        return output == output_end;
+    }
+
+}
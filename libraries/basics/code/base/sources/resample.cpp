@@ -0,0 +1,304 @@
+/*
+ * RESAMPLE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803151000
+ */
+
+#include <algorithm>
+#include <vector>
+#include <basics/macros>
+#include <basics/resample>
+
+#if   defined(BASICS_SSE2_ENABLED)
+    #include <emmintrin.h>
+#elif defined(BASICS_NEON_ENABLED)
+    #include <arm_neon.h>
+#endif
+
+namespace basics
+{
+
+    namespace
+    {
+
+        /**
+         * Contribución de los píxeles de origen a un píxel de destino en una dimensión.
+         */
+        struct Footprint
+        {
+            unsigned             first;
+            std::vector< float > weights;
+        };
+
+        std::vector< Footprint > compute_footprints (unsigned source_size, unsigned target_size)
+        {
+            std::vector< Footprint > footprints(target_size);
+
+            double scale = double(source_size) / double(target_size);
+
+            for (unsigned index = 0; index < target_size; ++index)
+            {
+                double start = index * scale;
+                double end   = start + scale;
+
+                unsigned first = unsigned(start);
+                unsigned last  = std::min (source_size, unsigned(end + 0.999999));
+
+                footprints[index].first = first;
+
+                for (unsigned source = first; source < last; ++source)
+                {
+                    double overlap = std::min (end, double(source + 1)) - std::max (start, double(source));
+
+                    footprints[index].weights.push_back (float(overlap / scale));
+                }
+            }
+
+            return footprints;
+        }
+
+    }
+
+    bool downscale (const Color_Buffer< Rgba8888 > & source, Color_Buffer< Rgba8888 > & target, unsigned width, unsigned height)
+    {
+        if (width == 0 || height == 0 || width > source.width || height > source.height)
+        {
+            return false;
+        }
+
+        std::vector< Footprint > horizontal = compute_footprints (source.width,  width );
+        std::vector< Footprint >   vertical = compute_footprints (source.height, height);
+
+        // Primera pasada (horizontal) sobre componentes premultiplicados en coma flotante:
+
+        std::vector< float > rows(size_t(width) * source.height * 4);
+
+        for (unsigned y = 0; y < source.height; ++y)
+        {
+            const Rgba8888 * source_row = &source[y * source.width];
+            float          * target_row = &rows[size_t(y) * width * 4];
+
+            for (unsigned x = 0; x < width; ++x)
+            {
+                const Footprint & footprint = horizontal[x];
+
+                float r = 0.f, g = 0.f, b = 0.f, a = 0.f;
+
+                for (size_t k = 0; k < footprint.weights.size (); ++k)
+                {
+                    Rgba8888 pixel  = source_row[footprint.first + k];
+                    float    alpha  = float(pixel >> 24) * footprint.weights[k];
+
+                    r += float((pixel      ) & 0xFF) * alpha;
+                    g += float((pixel >>  8) & 0xFF) * alpha;
+                    b += float((pixel >> 16) & 0xFF) * alpha;
+                    a += alpha;
+                }
+
+                target_row[x * 4 + 0] = r;
+                target_row[x * 4 + 1] = g;
+                target_row[x * 4 + 2] = b;
+                target_row[x * 4 + 3] = a;
+            }
+        }
+
+        // Segunda pasada (vertical) y vuelta a componentes sin premultiplicar:
+
+        target.resize (width, height);
+
+        for (unsigned y = 0; y < height; ++y)
+        {
+            const Footprint & footprint = vertical[y];
+
+            for (unsigned x = 0; x < width; ++x)
+            {
+                float r = 0.f, g = 0.f, b = 0.f, a = 0.f;
+
+                for (size_t k = 0; k < footprint.weights.size (); ++k)
+                {
+                    const float * pixel  = &rows[(size_t(footprint.first + k) * width + x) * 4];
+                    float         weight = footprint.weights[k];
+
+                    r += pixel[0] * weight;
+                    g += pixel[1] * weight;
+                    b += pixel[2] * weight;
+                    a += pixel[3] * weight;
+                }
+
+                unsigned alpha = unsigned(std::min (a + .5f, 255.f));
+
+                if (a > 0.f)
+                {
+                    float inverse = 1.f / a;
+
+                    r *= inverse;
+                    g *= inverse;
+                    b *= inverse;
+                }
+
+                target[y * width + x] =
+                    Rgba8888(std::min (r + .5f, 255.f))       |
+                    Rgba8888(std::min (g + .5f, 255.f)) <<  8 |
+                    Rgba8888(std::min (b + .5f, 255.f)) << 16 |
+                    Rgba8888(alpha)                     << 24;
+            }
+        }
+
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void halve (const Color_Buffer< Rgba8888 > & source, Color_Buffer< Rgba8888 > & target)
+    {
+        if (source.size () == 0)
+        {
+            target.resize (0, 0);
+            return;
+        }
+
+        const unsigned width  = std::max (1u, source.width  / 2);
+        const unsigned height = std::max (1u, source.height / 2);
+
+        target.resize (width, height);
+
+        for (unsigned y = 0; y < height; ++y)
+        {
+            const Rgba8888 * row_0  = &source[std::min (y * 2,     source.height - 1) * source.width];
+            const Rgba8888 * row_1  = &source[std::min (y * 2 + 1, source.height - 1) * source.width];
+            Rgba8888       * output = &target[y * width];
+            unsigned         x      = 0;
+
+            // Si la imagen tiene al menos 2 columnas, cada píxel de destino tiene sus 4 de origen
+            // dentro de la imagen y se pueden promediar 4 de ellos a la vez:
+
+            if (source.width >= 2)
+            {
+                #if defined(BASICS_SSE2_ENABLED)
+
+                    const __m128i zero = _mm_setzero_si128 ();
+                    const __m128i two  = _mm_set1_epi16 (2);
+
+                    for ( ; x + 4 <= width; x += 4)
+                    {
+                        __m128i sums[2];
+
+                        for (unsigned half = 0; half < 2; ++half)
+                        {
+                            __m128i a = _mm_loadu_si128 (reinterpret_cast< const __m128i * >(row_0 + x * 2 + half * 4));
+                            __m128i b = _mm_loadu_si128 (reinterpret_cast< const __m128i * >(row_1 + x * 2 + half * 4));
+
+                            // Suma vertical con los canales expandidos a 16 bits...
+
+                            __m128i low  = _mm_add_epi16 (_mm_unpacklo_epi8 (a, zero), _mm_unpacklo_epi8 (b, zero));
+                            __m128i high = _mm_add_epi16 (_mm_unpackhi_epi8 (a, zero), _mm_unpackhi_epi8 (b, zero));
+
+                            // ...y suma horizontal de cada pareja de columnas:
+
+                            __m128i sum  = _mm_add_epi16 (_mm_unpacklo_epi64 (low, high), _mm_unpackhi_epi64 (low, high));
+
+                            sums[half] = _mm_srli_epi16 (_mm_add_epi16 (sum, two), 2);
+                        }
+
+                        _mm_storeu_si128 (reinterpret_cast< __m128i * >(output + x), _mm_packus_epi16 (sums[0], sums[1]));
+                    }
+
+                #elif defined(BASICS_NEON_ENABLED)
+
+                    for ( ; x + 4 <= width; x += 4)
+                    {
+                        // vld2q separa las columnas pares de las impares:
+
+                        uint32x4x2_t a = vld2q_u32 (row_0 + x * 2);
+                        uint32x4x2_t b = vld2q_u32 (row_1 + x * 2);
+
+                        uint16x8_t low  = vaddq_u16
+                        (
+                            vaddl_u8 (vget_low_u8  (vreinterpretq_u8_u32 (a.val[0])), vget_low_u8  (vreinterpretq_u8_u32 (a.val[1]))),
+                            vaddl_u8 (vget_low_u8  (vreinterpretq_u8_u32 (b.val[0])), vget_low_u8  (vreinterpretq_u8_u32 (b.val[1])))
+                        );
+
+                        uint16x8_t high = vaddq_u16
+                        (
+                            vaddl_u8 (vget_high_u8 (vreinterpretq_u8_u32 (a.val[0])), vget_high_u8 (vreinterpretq_u8_u32 (a.val[1]))),
+                            vaddl_u8 (vget_high_u8 (vreinterpretq_u8_u32 (b.val[0])), vget_high_u8 (vreinterpretq_u8_u32 (b.val[1])))
+                        );
+
+                        vst1q_u32 (output + x, vreinterpretq_u32_u8 (vcombine_u8 (vrshrn_n_u16 (low, 2), vrshrn_n_u16 (high, 2))));
+                    }
+
+                #endif
+            }
+
+            for ( ; x < width; ++x)
+            {
+                unsigned x0 = std::min (x * 2,     source.width - 1);
+                unsigned x1 = std::min (x * 2 + 1, source.width - 1);
+
+                Rgba8888 result = 0;
+
+                for (unsigned shift = 0; shift < 32; shift += 8)
+                {
+                    unsigned sum = ((row_0[x0] >> shift) & 0xFF) + ((row_0[x1] >> shift) & 0xFF)
+                                 + ((row_1[x0] >> shift) & 0xFF) + ((row_1[x1] >> shift) & 0xFF);
+
+                    result |= Rgba8888((sum + 2) >> 2) << shift;
+                }
+
+                output[x] = result;
+            }
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void premultiply_alpha (Color_Buffer< Rgba8888 > & color_buffer)
+    {
+        for (unsigned index = 0, count = color_buffer.size (); index < count; ++index)
+        {
+            Rgba8888 pixel = color_buffer[index];
+            unsigned alpha = pixel >> 24;
+
+            if (alpha < 255)
+            {
+                unsigned r = ((pixel      ) & 0xFF) * alpha + 128;
+                unsigned g = ((pixel >>  8) & 0xFF) * alpha + 128;
+                unsigned b = ((pixel >> 16) & 0xFF) * alpha + 128;
+
+                color_buffer[index] =
+                    ((r + (r >> 8)) >> 8)       |
+                    ((g + (g >> 8)) >> 8) <<  8 |
+                    ((b + (b >> 8)) >> 8) << 16 |
+                    (pixel & 0xFF000000);
+            }
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void copy_extruded (const Color_Buffer< Rgba8888 > & source, Color_Buffer< Rgba8888 > & target, unsigned left, unsigned top, unsigned extrusion)
+    {
+        if (source.size () == 0)
+        {
+            return;
+        }
+
+        for (int row = -int(extrusion), rows = int(source.height + extrusion); row < rows; ++row)
+        {
+            unsigned         source_row = unsigned(std::min (std::max (row, 0), int(source.height) - 1));
+            const Rgba8888 * from       = &source[source_row * source.width];
+            Rgba8888       * to         = &target[unsigned(int(top) + row) * target.width + left];
+
+            std::fill (to - extrusion,    to,                                from[0]               );
+            std::copy (from,              from + source.width,               to                    );
+            std::fill (to + source.width, to + source.width + extrusion,     from[source.width - 1]);
+        }
+    }
+
+}
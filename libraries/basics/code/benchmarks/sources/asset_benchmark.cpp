@@ -0,0 +1,233 @@
+/*
+ * ASSET BENCHMARK
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803241020
+ */
+
+// Mide el coste de las distintas formas de leer los assets con el adaptador de Linux: copia completa
+// (read_all()), proyección en memoria (Asset::map()), lecturas por bloques con pread() (read_at()) y
+// lectura byte a byte; y las lecturas por lotes de Asset_Reader con io_uring y con el Thread_Pool. Las
+// rutas son relativas a la raíz de los assets que se indique. Con --cold se pide al kernel que
+// descarte los assets de la caché de páginas antes de cada iteración (sin contar ese tiempo), lo que
+// permite medir lecturas desde el disco sin privilegios.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <basics/Asset>
+#include <basics/Asset_Reader>
+
+using namespace basics;
+
+namespace
+{
+
+    typedef size_t (* Reader) (const std::string & path);
+
+    size_t read_all (const std::string & path)
+    {
+        std::shared_ptr< Asset > asset = Asset::open (path);
+        std::vector< byte >      data;
+
+        return asset && asset->read_all (data) ? data.size () : 0;
+    }
+
+    size_t touch (const Asset::Mapping & mapping)
+    {
+        // Se toca una vez cada página para que el coste de cargarlas se cuente aunque estén proyectadas:
+
+        volatile byte checksum = 0;
+
+        for (size_t offset = 0; offset < mapping.get_size (); offset += 4096) checksum ^= mapping.get_data ()[offset];
+
+        return mapping.get_size ();
+    }
+
+    size_t read_mapping (const std::string & path)
+    {
+        return touch (Asset::map (path));
+    }
+
+    size_t read_blocks (const std::string & path)
+    {
+        std::shared_ptr< Asset > asset = Asset::open (path);
+        size_t                   total = 0;
+
+        if (asset)
+        {
+            std::vector< byte > block(65536);
+
+            while (size_t count = asset->read_at (total, block.data (), block.size ())) total += count;
+        }
+
+        return total;
+    }
+
+    size_t read_bytes (const std::string & path)
+    {
+        std::shared_ptr< Asset > asset = Asset::open (path);
+        size_t                   total = 0;
+
+        if (asset)
+        {
+            for (size_t size = asset->size (); total < size; ++total) asset->read ();
+        }
+
+        return total;
+    }
+
+    void find_assets (const std::string & root, const std::string & path, std::vector< std::string > & assets)
+    {
+        std::string full_path = path.empty () ? root : root + '/' + path;
+        struct stat status;
+
+        if (stat (full_path.c_str (), &status) != 0) return;
+
+        if (S_ISDIR(status.st_mode))
+        {
+            if (DIR * directory = opendir (full_path.c_str ()))
+            {
+                while (dirent * entry = readdir (directory))
+                {
+                    if (entry->d_name[0] != '.') find_assets (root, path.empty () ? entry->d_name : path + '/' + entry->d_name, assets);
+                }
+
+                closedir (directory);
+            }
+        }
+        else
+            assets.push_back (path);
+    }
+
+    void evict (const std::string & root, const std::vector< std::string > & assets)
+    {
+        for (auto & path : assets)
+        {
+            int file = open ((root + '/' + path).c_str (), O_RDONLY);
+
+            if (file >= 0)
+            {
+                posix_fadvise (file, 0, 0, POSIX_FADV_DONTNEED);
+                close (file);
+            }
+        }
+    }
+
+    typedef std::chrono::steady_clock::duration Duration;
+
+    void report (const char * name, Duration elapsed, size_t bytes)
+    {
+        double seconds = std::chrono::duration< double >(elapsed).count ();
+
+        std::printf ("%-20s %9.2f ms %9.1f MB/s\n", name, seconds * 1000.0, bytes / seconds / 1e6);
+    }
+
+    void measure (const char * name, Reader reader, const std::string & root, const std::vector< std::string > & assets, unsigned iterations, bool cold)
+    {
+        size_t   bytes   = 0;
+        Duration elapsed = Duration::zero ();
+
+        for (unsigned iteration = 0; iteration < iterations; ++iteration)
+        {
+            if (cold) evict (root, assets);
+
+            auto start = std::chrono::steady_clock::now ();
+
+            for (auto & path : assets) bytes += reader (path);
+
+            elapsed += std::chrono::steady_clock::now () - start;
+        }
+
+        report (name, elapsed, bytes);
+    }
+
+    void measure_batch (bool native_reads, const std::string & root, const std::vector< std::string > & assets, unsigned iterations, bool cold)
+    {
+        Asset_Reader reader(0, native_reads);
+        size_t       bytes   = 0;
+        Duration     elapsed = Duration::zero ();
+
+        for (unsigned iteration = 0; iteration < iterations; ++iteration)
+        {
+            if (cold) evict (root, assets);
+
+            auto start = std::chrono::steady_clock::now ();
+
+            for (auto & read : reader.read (assets))
+            {
+                if (read->wait ()) bytes += touch (read->get_data ());
+            }
+
+            elapsed += std::chrono::steady_clock::now () - start;
+        }
+
+        report ((std::string("batch (") + reader.get_backend_name () + ")").c_str (), elapsed, bytes);
+    }
+
+}
+
+int main (int argc, char * argv[])
+{
+    std::string root;
+    unsigned    iterations = 10;
+    bool        cold       = false;
+
+    for (int index = 1; index < argc; ++index)
+    {
+        if (std::strcmp (argv[index], "--iterations") == 0 && index + 1 < argc)
+        {
+            iterations = unsigned(std::atoi (argv[++index]));
+        }
+        else
+        if (std::strcmp (argv[index], "--cold") == 0)
+        {
+            cold = true;
+        }
+        else
+            root = argv[index];
+    }
+
+    std::vector< std::string > assets;
+
+    if (!root.empty ())
+    {
+        Asset::set_root (root);
+
+        find_assets (root, std::string(), assets);
+    }
+
+    if (assets.empty ())
+    {
+        std::printf ("usage: basics-asset-benchmark [--iterations <n>] [--cold] <assets directory>\n");
+        return 1;
+    }
+
+    size_t total_size = 0;
+
+    for (auto & path : assets) total_size += Asset::size (path);
+
+    std::printf ("%zu assets, %zu KiB, %u iterations%s\n", assets.size (), total_size / 1024, iterations, cold ? ", cold cache" : "");
+
+    measure ("read_all", read_all,     root, assets, iterations, cold);
+    measure ("map",      read_mapping, root, assets, iterations, cold);
+    measure ("read_at",  read_blocks,  root, assets, iterations, cold);
+    measure ("read",     read_bytes,   root, assets, iterations, cold);
+
+    measure_batch (false, root, assets, iterations, cold);
+    measure_batch (true,  root, assets, iterations, cold);
+
+    return 0;
+}
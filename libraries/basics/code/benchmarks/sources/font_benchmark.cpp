@@ -0,0 +1,206 @@
+/*
+ * FONT BENCHMARK
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803291000
+ */
+
+// Compara la carga de una fuente desde su .fnt en XML y desde la .font binaria que genera
+// basics-cooker --binary, y la búsqueda de caracteres de Raster_Font (tabla directa para Latin-1 y
+// búsqueda binaria para el resto) con la anterior, basada en un std::unordered_map. Durante las
+// cargas se mantiene cargada una fuente de cada tipo para que Texture_Registry comparta su textura,
+// por lo que se mide solo el coste de leer la fuente. Como el .fnt usa la .font que tenga al lado, se
+// le debe pasar el .fnt sin cocinar.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <basics/enable>
+#include <basics/Raster_Font>
+#include <basics/Text_Layout>
+#include <basics/software/Context>
+#include <basics/software/Software_Rasterizer>
+
+using namespace basics;
+
+namespace
+{
+
+    typedef std::unordered_map< uint32_t, Raster_Font::Character > Character_Map;
+
+    typedef std::chrono::steady_clock Clock;
+
+    double milliseconds_since (Clock::time_point start)
+    {
+        return std::chrono::duration< double, std::milli >(Clock::now () - start).count ();
+    }
+
+    void measure_load (const char * name, const std::string & path, Graphics_Context::Accessor & context, unsigned iterations)
+    {
+        bool failed = false;
+
+        auto start = Clock::now ();
+
+        for (unsigned iteration = 0; iteration < iterations; ++iteration)
+        {
+            Raster_Font font(path, context);
+
+            failed |= !font.good ();
+        }
+
+        std::printf ("%-22s %9.3f ms per font%s\n", name, milliseconds_since (start) / iterations, failed ? "   (the font failed to load)" : "");
+    }
+
+    /**
+     * Texto de prueba con los caracteres de la fuente, la mayoría de Basic Latin y Latin-1 como en
+     * los textos de los juegos y algunos de fuera de ese rango si la fuente los tiene.
+     */
+    std::wstring make_text (const Raster_Font & font, size_t length)
+    {
+        std::vector< wchar_t > latin_1, others;
+
+        for (uint32_t code = 0; code < 0x30000; ++code)
+        {
+            if (font.get_character (code)) (code < Raster_Font::direct_range ? latin_1 : others).push_back (wchar_t(code));
+        }
+
+        std::wstring text;
+
+        srand (1);
+
+        while (text.size () < length && !latin_1.empty ())
+        {
+            text += rand () % 32 == 0 && !others.empty () ? others[rand () % others.size ()] : latin_1[rand () % latin_1.size ()];
+
+            if (rand () % 40 == 0) text += L'\n';
+        }
+
+        return text;
+    }
+
+    template< typename FIND >
+    void measure_lookup (const char * name, const std::wstring & text, FIND find, unsigned iterations)
+    {
+        float checksum = 0.f;
+
+        auto start = Clock::now ();
+
+        for (unsigned iteration = 0; iteration < iterations; ++iteration)
+        {
+            for (wchar_t c : text)
+            {
+                if (const Raster_Font::Character * character = find (uint32_t(c))) checksum += character->advance;
+            }
+        }
+
+        double elapsed = milliseconds_since (start);
+
+        std::printf ("%-22s %9.2f ns per character   (checksum %g)\n", name, elapsed * 1e6 / (double(iterations) * text.size ()), checksum);
+    }
+
+}
+
+int main (int argc, char * argv[])
+{
+    std::string xml_path;
+    std::string binary_path;
+    unsigned    iterations = 50;
+
+    for (int index = 1; index < argc; ++index)
+    {
+        if (std::strcmp (argv[index], "--iterations") == 0 && index + 1 < argc)
+        {
+            iterations = unsigned(std::atoi (argv[++index]));
+        }
+        else
+        if (xml_path.empty ())
+        {
+            xml_path = argv[index];
+        }
+        else
+            binary_path = argv[index];
+    }
+
+    if (xml_path.empty () || iterations == 0)
+    {
+        std::printf ("usage: basics-font-benchmark [--iterations <n>] <.fnt file> [<.font file>]\n");
+        return 1;
+    }
+
+    enable< Software_Rasterizer > ();
+
+    auto                       software_context = software::Context::create ({ 64, 64 });
+    Graphics_Context::Accessor context          = software_context->lock ();
+
+    Raster_Font font(xml_path, context);
+
+    if (!font.good ())
+    {
+        std::printf ("cannot load %s\n", xml_path.c_str ());
+        return 1;
+    }
+
+    measure_load ("load .fnt (XML)", xml_path, context, iterations);
+
+    if (!binary_path.empty ())
+    {
+        Raster_Font binary_font(binary_path, context);
+
+        measure_load ("load .font (binary)", binary_path, context, iterations);
+    }
+
+    // Búsqueda de caracteres como la hace Text_Layout:
+
+    Character_Map character_map;
+
+    for (uint32_t code = 0; code < 0x30000; ++code)
+    {
+        if (const Raster_Font::Character * character = font.get_character (code)) character_map[code] = *character;
+    }
+
+    std::wstring text = make_text (font, 4096);
+
+    std::printf ("%zu characters in the font, %zu in the text, %s\n", character_map.size (), text.size (), font.has_kerning () ? "with kerning" : "without kerning");
+
+    measure_lookup
+    (
+        "unordered_map",
+        text,
+        [&character_map] (uint32_t code) -> const Raster_Font::Character *
+        {
+            Character_Map::const_iterator item = character_map.find (code);
+            return item != character_map.end () ? &item->second : nullptr;
+        },
+        iterations * 40
+    );
+
+    measure_lookup
+    (
+        "direct + sorted",
+        text,
+        [&font] (uint32_t code) { return font.get_character (code); },
+        iterations * 40
+    );
+
+    // Maquetación completa del texto (incluido el kerning si la fuente lo tiene):
+
+    auto start = Clock::now ();
+
+    for (unsigned iteration = 0; iteration < iterations; ++iteration)
+    {
+        Text_Layout layout(font, text);
+    }
+
+    std::printf ("%-22s %9.2f ns per character\n", "Text_Layout", milliseconds_since (start) * 1e6 / (double(iterations) * text.size ()));
+
+    return 0;
+}
@@ -0,0 +1,266 @@
+/*
+ * PNG BENCHMARK
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803211200
+ */
+
+// Compara el tiempo de decodificación y el pico de memoria de png_decode() con el camino anterior
+// (lodepng::decode() a un vector temporal y copia al Color_Buffer). Cada camino se mide en un proceso
+// hijo para que el pico de memoria de uno no oculte el del otro. Con --validate se comprueba además
+// que png_decode() produce exactamente los mismos píxeles que lodepng.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <basics/png_decode>
+#include "lodepng.h"
+
+using namespace basics;
+
+namespace
+{
+
+    struct Image
+    {
+        std::string         path;
+        std::vector< byte > data;
+    };
+
+    typedef bool (* Decoder) (const std::vector< byte > & , Color_Buffer< Rgba8888 > & , unsigned & , unsigned & );
+
+    bool decode_with_copy (const std::vector< byte > & data, Color_Buffer< Rgba8888 > & color_buffer, unsigned & width, unsigned & height)
+    {
+        std::vector< byte > decoded_data;
+
+        if (lodepng::decode (decoded_data, width, height, data, LCT_RGBA, 8) != 0)
+        {
+            return false;
+        }
+
+        color_buffer.resize (width, height);
+
+        byte * buffer = color_buffer;
+
+        for (auto i = decoded_data.begin (); i != decoded_data.end (); ++i)
+        {
+            *buffer++ = *i;
+        }
+
+        return true;
+    }
+
+    bool decode_with_options (const std::vector< byte > & data, Color_Buffer< Rgba8888 > & color_buffer, unsigned & width, unsigned & height, const Png_Decode_Options & options)
+    {
+        if (!png_read_size (data.data (), data.size (), width, height))
+        {
+            return false;
+        }
+
+        color_buffer.resize (width, height);
+
+        return png_decode (data.data (), data.size (), color_buffer.buffer.data (), width * sizeof(Rgba8888), options);
+    }
+
+    bool decode_with_lodepng_inflate (const std::vector< byte > & data, Color_Buffer< Rgba8888 > & color_buffer, unsigned & width, unsigned & height)
+    {
+        Png_Decode_Options options;
+
+        options.fast_inflate = false;
+
+        return decode_with_options (data, color_buffer, width, height, options);
+    }
+
+    bool decode_without_checksum (const std::vector< byte > & data, Color_Buffer< Rgba8888 > & color_buffer, unsigned & width, unsigned & height)
+    {
+        Png_Decode_Options options;
+
+        options.verify_checksum = false;
+
+        return decode_with_options (data, color_buffer, width, height, options);
+    }
+
+    void find_images (const std::string & path, std::vector< Image > & images)
+    {
+        struct stat status;
+
+        if (stat (path.c_str (), &status) != 0) return;
+
+        if (S_ISDIR(status.st_mode))
+        {
+            if (DIR * directory = opendir (path.c_str ()))
+            {
+                while (dirent * entry = readdir (directory))
+                {
+                    if (entry->d_name[0] != '.') find_images (path + '/' + entry->d_name, images);
+                }
+
+                closedir (directory);
+            }
+        }
+        else
+        if (path.size () > 4 && path.compare (path.size () - 4, 4, ".png") == 0)
+        {
+            Image image;
+
+            image.path = path;
+
+            if (lodepng::load_file (image.data, path) == 0) images.push_back (std::move (image));
+        }
+    }
+
+    size_t resident_kilobytes ()
+    {
+        long pages = 0, resident = 0;
+
+        if (FILE * file = std::fopen ("/proc/self/statm", "r"))
+        {
+            if (std::fscanf (file, "%ld %ld", &pages, &resident) != 2) resident = 0;
+
+            std::fclose (file);
+        }
+
+        return size_t(resident) * size_t(sysconf (_SC_PAGESIZE)) / 1024;
+    }
+
+    void measure (const char * name, Decoder decoder, const std::vector< Image > & images, unsigned iterations)
+    {
+        std::fflush (stdout);
+
+        pid_t child = fork ();
+
+        if (child == 0)
+        {
+            size_t baseline = resident_kilobytes ();
+            size_t pixels   = 0;
+            size_t bytes    = 0;
+            bool   failed   = false;
+
+            auto start = std::chrono::steady_clock::now ();
+
+            for (unsigned iteration = 0; iteration < iterations; ++iteration)
+            {
+                for (auto & image : images)
+                {
+                    Color_Buffer< Rgba8888 > color_buffer;
+                    unsigned                 width, height;
+
+                    if (decoder (image.data, color_buffer, width, height)) pixels += color_buffer.size (); else failed = true;
+
+                    bytes += image.data.size ();
+                }
+            }
+
+            double seconds = std::chrono::duration< double >(std::chrono::steady_clock::now () - start).count ();
+
+            rusage usage;
+            getrusage (RUSAGE_SELF, &usage);
+
+            std::printf
+            (
+                "%-22s %9.2f ms %9.1f Mpixel/s %8.1f MB/s   peak RSS +%zu KiB%s\n",
+                name,
+                seconds * 1000.0,
+                pixels / seconds / 1e6,
+                bytes  / seconds / 1e6,
+                size_t(usage.ru_maxrss) > baseline ? size_t(usage.ru_maxrss) - baseline : 0,
+                failed ? "   (some images failed)" : ""
+            );
+
+            std::fflush (stdout);
+            _exit (0);
+        }
+
+        int status;
+        waitpid (child, &status, 0);
+    }
+
+    /**
+     * Comprueba que png_decode() produce los mismos píxeles que lodepng con cada imagen.
+     * @return Número de imágenes que no coinciden.
+     */
+    unsigned validate (const std::vector< Image > & images)
+    {
+        unsigned mismatches = 0;
+
+        for (auto & image : images)
+        {
+            std::vector< byte >      expected;
+            Color_Buffer< Rgba8888 > color_buffer;
+            unsigned                 width, height, decoded_width, decoded_height;
+
+            bool expected_success = lodepng::decode (expected, width, height, image.data, LCT_RGBA, 8) == 0;
+            bool success          = png_decode (image.data, color_buffer, decoded_width, decoded_height);
+
+            if (success != expected_success || (success && (width != decoded_width || height != decoded_height || std::memcmp (expected.data (), color_buffer.buffer.data (), expected.size ()) != 0)))
+            {
+                std::printf ("mismatch: %s\n", image.path.c_str ());
+
+                ++mismatches;
+            }
+        }
+
+        std::printf ("validated %zu images, %u mismatches\n", images.size (), mismatches);
+
+        return mismatches;
+    }
+
+}
+
+int main (int argc, char * argv[])
+{
+    std::vector< Image > images;
+    unsigned             iterations = 10;
+    bool                 validation = false;
+
+    for (int index = 1; index < argc; ++index)
+    {
+        if (std::strcmp (argv[index], "--iterations") == 0 && index + 1 < argc)
+        {
+            iterations = unsigned(std::atoi (argv[++index]));
+        }
+        else
+        if (std::strcmp (argv[index], "--validate") == 0)
+        {
+            validation = true;
+        }
+        else
+        {
+            find_images (argv[index], images);
+        }
+    }
+
+    if (images.empty ())
+    {
+        std::printf ("usage: basics-png-benchmark [--iterations <n>] [--validate] <png files or directories>\n");
+        return 1;
+    }
+
+    size_t encoded_size = 0;
+
+    for (auto & image : images) encoded_size += image.data.size ();
+
+    std::printf ("%zu images, %zu KiB encoded, %u iterations\n", images.size (), encoded_size / 1024, iterations);
+
+    measure ("lodepng+copy",         decode_with_copy,            images, iterations);
+    measure ("png_decode (lodepng)", decode_with_lodepng_inflate, images, iterations);
+    measure ("png_decode",           png_decode,                  images, iterations);
+    measure ("png_decode (no adler)", decode_without_checksum,    images, iterations);
+
+    // La validación se hace al final porque los procesos hijos heredan el pico de memoria del padre:
+
+    return validation && validate (images) > 0 ? 1 : 0;
+}
@@ -0,0 +1,155 @@
+/*
+ * TEXTURE CACHE BENCHMARK
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803271000
+ */
+
+// Mide lo que tarda en obtener los píxeles de todas las texturas PNG de un directorio de assets (como
+// al iniciar el juego) sin la Texture_Cache, con la caché vacía (primer arranque, incluida la
+// escritura de las entradas) y con la caché llena (arranques siguientes). La caché se crea en un
+// directorio temporal que se vacía al empezar.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <basics/Texture_2D>
+#include <basics/Texture_Cache>
+
+using namespace basics;
+
+namespace
+{
+
+    void find_images (const std::string & root, const std::string & path, std::vector< std::string > & images)
+    {
+        std::string full_path = path.empty () ? root : root + '/' + path;
+        struct stat status;
+
+        if (stat (full_path.c_str (), &status) != 0) return;
+
+        if (S_ISDIR(status.st_mode))
+        {
+            if (DIR * directory = opendir (full_path.c_str ()))
+            {
+                while (dirent * entry = readdir (directory))
+                {
+                    if (entry->d_name[0] != '.') find_images (root, path.empty () ? entry->d_name : path + '/' + entry->d_name, images);
+                }
+
+                closedir (directory);
+            }
+        }
+        else
+        if (path.size () > 4 && path.compare (path.size () - 4, 4, ".png") == 0)
+        {
+            images.push_back (path);
+        }
+    }
+
+    void measure (const char * name, const std::vector< std::string > & images, const Texture_2D::Options & options, unsigned iterations)
+    {
+        size_t bytes  = 0;
+        bool   failed = false;
+
+        auto start = std::chrono::steady_clock::now ();
+
+        for (unsigned iteration = 0; iteration < iterations; ++iteration)
+        {
+            for (auto & path : images)
+            {
+                Color_Buffer< Rgba8888 > color_buffer;
+                Texture_Data             texture_data;
+                Texture_2D::Options      image_options = options;
+
+                if (Texture_2D::load (path, image_options, color_buffer, texture_data))
+                {
+                    bytes += texture_data.levels.empty () ? color_buffer.size () * sizeof(Rgba8888) : texture_data.get_size ();
+                }
+                else
+                    failed = true;
+            }
+        }
+
+        // Las escrituras en segundo plano forman parte del coste del primer arranque:
+
+        Texture_Cache::flush ();
+
+        double seconds = std::chrono::duration< double >(std::chrono::steady_clock::now () - start).count ();
+
+        std::printf ("%-14s %9.2f ms %9.1f MB/s of pixels%s\n", name, seconds * 1000.0 / iterations, bytes / seconds / 1e6, failed ? "   (some images failed)" : "");
+    }
+
+}
+
+int main (int argc, char * argv[])
+{
+    std::string root;
+    std::string cache_directory = "/tmp/basics-texture-cache-benchmark";
+    unsigned    iterations      = 5;
+
+    Texture_2D::Options options = { 0, 0, 0, 0, false, Texture_2D::PREFER_16_BIT, Texture_2D::RELEASE_PIXELS };
+
+    for (int index = 1; index < argc; ++index)
+    {
+        if (std::strcmp (argv[index], "--iterations") == 0 && index + 1 < argc)
+        {
+            iterations = unsigned(std::atoi (argv[++index]));
+        }
+        else
+        if (std::strcmp (argv[index], "--cache") == 0 && index + 1 < argc)
+        {
+            cache_directory = argv[++index];
+        }
+        else
+        if (std::strcmp (argv[index], "--32-bit") == 0)
+        {
+            options.format_policy = Texture_2D::KEEP_32_BIT;
+        }
+        else
+            root = argv[index];
+    }
+
+    std::vector< std::string > images;
+
+    if (!root.empty ())
+    {
+        Asset::set_root (root);
+
+        find_images (root, std::string(), images);
+    }
+
+    if (images.empty () || !Texture_Cache::enable (cache_directory))
+    {
+        std::printf ("usage: basics-texture-cache-benchmark [--iterations <n>] [--cache <directory>] [--32-bit] <assets directory>\n");
+        return 1;
+    }
+
+    std::printf ("%zu images, %u iterations, cache in %s\n", images.size (), iterations, cache_directory.c_str ());
+
+    Texture_Cache::clear   ();
+    Texture_Cache::disable ();
+
+    measure ("no cache", images, options, iterations);
+
+    Texture_Cache::enable (cache_directory);
+
+    measure ("first start", images, options, 1);
+    measure ("warm start",  images, options, iterations);
+
+    Texture_Cache::Statistics statistics = Texture_Cache::get_statistics ();
+
+    std::printf ("cache: %u hits, %u misses, %u writes\n", statistics.hits, statistics.misses, statistics.writes);
+
+    return 0;
+}
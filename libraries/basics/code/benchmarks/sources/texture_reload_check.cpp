@@ -0,0 +1,359 @@
+/*
+ * TEXTURE RELOAD CHECK
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1804011000
+ */
+
+// Simula la pérdida del contexto gráfico con texturas de opengles::Texture_2D que liberan sus
+// píxeles tras subirlos (RELEASE_PIXELS). Sube las texturas a un contexto EGL sin superficie, lee
+// sus texels, destruye el contexto como lo hace el sistema al perderlo, crea otro con la misma
+// Graphics_Resource_Cache (que restaura las texturas volviendo a decodificar sus assets o el PNG
+// compacto de las que no tienen asset) y comprueba que los texels vuelven a ser los mismos. Funciona
+// con el driver por software de Mesa (llvmpipe), por lo que no necesita GPU. Si no se puede crear
+// el contexto, termina con el código 77 (que CTest trata como prueba omitida).
+
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <basics/Asset>
+#include <basics/Graphics_Context>
+#include <basics/Graphics_Resource_Cache>
+#include <basics/opengles/Texture_2D>
+#include <basics/Window>
+
+using namespace basics;
+
+namespace
+{
+
+    /**
+     * Contexto OpenGL ES 2 de EGL sin superficie (EGL_MESA_platform_surfaceless o, si no está, el
+     * display por defecto con un pbuffer de 1x1).
+     */
+    class Egl_Context : public Graphics_Context, public std::enable_shared_from_this< Egl_Context >
+    {
+
+        class Offscreen_Window final : public Window
+        {
+        public:
+
+            Offscreen_Window() : Window(ID(offscreen))
+            {
+                available = true;
+            }
+
+            Size2u   get_size   () override { return { 1u, 1u }; }
+            unsigned get_width  () override { return 1; }
+            unsigned get_height () override { return 1; }
+
+        };
+
+    public:
+
+        static std::shared_ptr< Egl_Context > create (Graphics_Resource_Cache * cache)
+        {
+            std::shared_ptr< Egl_Context > context(new Egl_Context(std::make_shared< Offscreen_Window > (), cache));
+
+            if (!context->is_available ())
+            {
+                return nullptr;
+            }
+
+            // Igual que los contextos de las ventanas, al crearse restaura los recursos de la caché:
+
+            context->initialize ();
+
+            return context;
+        }
+
+    private:
+
+        std::shared_ptr< Offscreen_Window > offscreen_window;
+        std::mutex                          mutex;
+
+        EGLDisplay display;
+        EGLContext context;
+        EGLSurface surface;
+
+    private:
+
+        Egl_Context(const std::shared_ptr< Offscreen_Window > & window, Graphics_Resource_Cache * cache)
+        :
+            Graphics_Context(*window, cache),
+            offscreen_window(window),
+            display         (EGL_NO_DISPLAY),
+            context         (EGL_NO_CONTEXT),
+            surface         (EGL_NO_SURFACE)
+        {
+            auto get_platform_display = reinterpret_cast< PFNEGLGETPLATFORMDISPLAYEXTPROC >(eglGetProcAddress ("eglGetPlatformDisplayEXT"));
+
+            if (get_platform_display)
+            {
+                display = get_platform_display (EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            }
+
+            if (display == EGL_NO_DISPLAY || !eglInitialize (display, nullptr, nullptr))
+            {
+                display = eglGetDisplay (EGL_DEFAULT_DISPLAY);
+
+                if (display == EGL_NO_DISPLAY || !eglInitialize (display, nullptr, nullptr)) return;
+            }
+
+            const EGLint config_attributes[] =
+            {
+                EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+                EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+                EGL_NONE
+            };
+
+            const EGLint context_attributes[] = { EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE };
+            const EGLint surface_attributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+
+            EGLConfig config;
+            EGLint    config_count = 0;
+
+            if (!eglChooseConfig (display, config_attributes, &config, 1, &config_count) || config_count == 0)
+            {
+                return;
+            }
+
+            eglBindAPI (EGL_OPENGL_ES_API);
+
+            context = eglCreateContext (display, config, EGL_NO_CONTEXT, context_attributes);
+
+            if (context == EGL_NO_CONTEXT) return;
+
+            // Sin la extensión EGL_KHR_surfaceless_context hace falta una superficie:
+
+            if (!eglMakeCurrent (display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+            {
+                surface = eglCreatePbufferSurface (display, config, surface_attributes);
+
+                if (!eglMakeCurrent (display, surface, surface, context))
+                {
+                    eglDestroyContext (display, context);
+
+                    context = EGL_NO_CONTEXT;
+                }
+            }
+        }
+
+    public:
+
+       ~Egl_Context()
+        {
+            finalize ();
+
+            if (context != EGL_NO_CONTEXT)
+            {
+                eglMakeCurrent    (display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+                eglDestroyContext (display, context);
+            }
+
+            if (surface != EGL_NO_SURFACE)
+            {
+                eglDestroySurface (display, surface);
+            }
+        }
+
+    public:
+
+        Graphics_Context::Accessor lock ()
+        {
+            return Graphics_Context::Accessor(shared_from_this (), mutex);
+        }
+
+    public:
+
+        void invalidate   () override { }
+        void suspend      () override { }
+        bool resume       () override { return true; }
+
+        bool is_available () const override { return context != EGL_NO_CONTEXT; }
+        bool is_current   () const override { return true; }
+
+        Id get_id () const override
+        {
+            return ID(opengles2);
+        }
+
+        unsigned get_surface_width  () override { return 1; }
+        unsigned get_surface_height () override { return 1; }
+
+        bool set_sync_swap  (bool ) override { return false; }
+        void reset_viewport () override { }
+        void set_viewport   (const Point2u & , const Size2u & ) override { }
+
+        bool make_current      () override { return true; }
+        bool flush_and_display () override { return true; }
+
+    };
+
+    struct Case
+    {
+        const char                    * name;
+        std::string                     asset_path;     ///< Vacía para las texturas creadas a partir de un Color_Buffer.
+        Texture_2D::Options             options;
+        std::shared_ptr< Texture_2D >   texture;
+        std::vector< uint8_t >          texels;         ///< Texels leídos antes de perder el contexto.
+    };
+
+    /**
+     * Lee el nivel 0 de una textura asociándola a un framebuffer (OpenGL ES 2 no tiene
+     * glGetTexImage).
+     */
+    std::vector< uint8_t > read_texels (const opengles::Texture_2D & texture)
+    {
+        std::vector< uint8_t > texels;
+
+        if (!texture.use ()) return texels;
+
+        GLint  texture_id = 0;
+        GLuint framebuffer;
+
+        glGetIntegerv          (GL_TEXTURE_BINDING_2D, &texture_id);
+        glGenFramebuffers      (1, &framebuffer);
+        glBindFramebuffer      (GL_FRAMEBUFFER, framebuffer);
+        glFramebufferTexture2D (GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, GLuint(texture_id), 0);
+
+        if (glCheckFramebufferStatus (GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE)
+        {
+            GLsizei width  = GLsizei(texture.get_width  ());
+            GLsizei height = GLsizei(texture.get_height ());
+
+            texels.resize (size_t(width) * size_t(height) * 4);
+
+            glReadPixels (0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, texels.data ());
+        }
+
+        glBindFramebuffer    (GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers (1, &framebuffer);
+
+        return texels;
+    }
+
+    Texture_2D::Options make_options (bool mipmaps, Texture_2D::Format_Policy format_policy)
+    {
+        Texture_2D::Options options{};
+
+        options.mipmaps         = mipmaps;
+        options.format_policy   = format_policy;
+        options.pixel_retention = Texture_2D::RELEASE_PIXELS;
+
+        return options;
+    }
+
+}
+
+int main (int argc, char * argv[])
+{
+    Asset::set_root (argc > 1 ? argv[1] : "assets");
+
+    opengles::Texture_2D::enable ();
+
+    Graphics_Resource_Cache        cache;
+    std::shared_ptr< Egl_Context > context = Egl_Context::create (&cache);
+
+    if (!context)
+    {
+        std::printf ("no OpenGL ES 2 context could be created, skipped\n");
+        return 77;
+    }
+
+    std::printf ("%s\n", reinterpret_cast< const char * >(glGetString (GL_RENDERER)));
+
+    std::vector< Case > cases;
+
+    cases.push_back ({ "asset, 32 bit",           "logo.png",                 make_options (false, Texture_2D::KEEP_32_BIT  ), nullptr, {} });
+    cases.push_back ({ "asset, 16 bit",           "menu-scene/main-menu.png", make_options (false, Texture_2D::PREFER_16_BIT), nullptr, {} });
+    cases.push_back ({ "asset, mipmaps",          "game-scene/ball.png",      make_options (true,  Texture_2D::KEEP_32_BIT  ), nullptr, {} });
+    cases.push_back ({ "color buffer (no asset)", "",                         make_options (false, Texture_2D::KEEP_32_BIT  ), nullptr, {} });
+
+    unsigned failures    = 0;
+    size_t   pixel_bytes = 0;
+    size_t   video_bytes = 0;
+
+    {
+        Graphics_Context::Accessor accessor = context->lock ();
+
+        for (auto & test : cases)
+        {
+            if (test.asset_path.empty ())
+            {
+                Color_Buffer< Rgba8888 > color_buffer(96, 80);
+
+                for (unsigned index = 0; index < color_buffer.size (); ++index)
+                {
+                    color_buffer.buffer[index] = Rgba8888(index * 2654435761u);
+                }
+
+                test.options.width  = color_buffer.get_width  ();
+                test.options.height = color_buffer.get_height ();
+                test.texture        = Texture_2D::create (ID(buffer), accessor, color_buffer, test.options);
+            }
+            else
+                test.texture = Texture_2D::create (ID(asset), accessor, test.asset_path, test.options);
+
+            if (!test.texture || !accessor->add (test.texture))
+            {
+                std::printf ("%-24s cannot be created\n", test.name);
+                return 1;
+            }
+
+            auto & texture = static_cast< opengles::Texture_2D & >(*test.texture);
+
+            test.texels  = read_texels (texture);
+            pixel_bytes += texture.get_pixel_copy_size ();
+            video_bytes += texture.get_byte_size ();
+        }
+    }
+
+    std::printf ("after upload: %zu KiB of pixel copies for %zu KiB of video memory\n", pixel_bytes / 1024, video_bytes / 1024);
+
+    // Al perder el contexto el sistema destruye sus objetos, por lo que no basta con finalize():
+    // se destruye el contexto EGL y se crea otro, que restaura las texturas desde la caché:
+
+    context.reset ();
+    context = Egl_Context::create (&cache);
+
+    if (!context)
+    {
+        std::printf ("the context could not be created again\n");
+        return 1;
+    }
+
+    Graphics_Context::Accessor accessor = context->lock ();
+
+    for (auto & test : cases)
+    {
+        auto & texture  = static_cast< opengles::Texture_2D & >(*test.texture);
+        auto   restored = read_texels (texture);
+        bool   same     = !restored.empty () && restored == test.texels;
+
+        std::printf
+        (
+            "%-24s %4gx%-4g restored %-3s texels %s\n",
+            test.name,
+            texture.get_width  (),
+            texture.get_height (),
+            texture.is_usable () ? "yes" : "no",
+            same ? "identical" : "DIFFERENT"
+        );
+
+        if (!texture.is_usable () || !same) ++failures;
+    }
+
+    std::printf ("%u failures\n", failures);
+
+    return failures > 0 ? 1 : 0;
+}
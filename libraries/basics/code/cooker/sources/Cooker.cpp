@@ -0,0 +1,1152 @@
+/*
+ * COOKER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803151200
+ */
+
+#include "Cooker.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <thread>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <rapidxml.hpp>
+#include <basics/Font_Table>
+#include <basics/fnv>
+#include <basics/png_decode>
+#include <basics/png_encode>
+#include <basics/Rectangle_Packer>
+#include <basics/resample>
+#include <basics/Slice_Table>
+
+namespace basics { namespace cooker
+{
+
+    namespace
+    {
+
+        const char   manifest_name[] = "manifest.txt";
+        const char   display_sizes_name[] = "display-sizes.txt";
+        const char   atlas_suffix [] = ".atlas";
+        const char   png_suffix   [] = ".png";
+        const char   sprites_suffix[] = ".sprites";
+        const char   fnt_suffix   [] = ".fnt";
+
+        bool ends_with (const std::string & text, const std::string & suffix)
+        {
+            return text.size () >= suffix.size () && text.compare (text.size () - suffix.size (), suffix.size (), suffix) == 0;
+        }
+
+        std::string join (const std::string & a, const std::string & b)
+        {
+            return a.empty () ? b : b.empty () ? a : a + '/' + b;
+        }
+
+        bool is_directory (const std::string & path)
+        {
+            struct stat info;
+
+            return stat (path.c_str (), &info) == 0 && S_ISDIR(info.st_mode);
+        }
+
+        bool exists (const std::string & path)
+        {
+            struct stat info;
+
+            return stat (path.c_str (), &info) == 0;
+        }
+
+        /**
+         * Crea el directorio que contiene un archivo y todos sus directorios padre.
+         */
+        bool make_parent_directories (const std::string & file_path)
+        {
+            for (size_t slash = file_path.find ('/', 1); slash != std::string::npos; slash = file_path.find ('/', slash + 1))
+            {
+                std::string directory = file_path.substr (0, slash);
+
+                if (mkdir (directory.c_str (), 0755) != 0 && errno != EEXIST)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        bool read_file (const std::string & path, std::vector< uint8_t > & data)
+        {
+            std::ifstream reader(path, std::ios::binary);
+
+            if (reader)
+            {
+                reader.seekg (0, std::ios::end);
+                data.resize  (size_t(reader.tellg ()));
+                reader.seekg (0, std::ios::beg);
+
+                return reader.read (reinterpret_cast< char * >(data.data ()), std::streamsize(data.size ())).good () || data.empty ();
+            }
+
+            return false;
+        }
+
+        bool write_file (const std::string & path, const void * data, size_t size)
+        {
+            if (make_parent_directories (path))
+            {
+                std::ofstream writer(path, std::ios::binary | std::ios::trunc);
+
+                if (writer)
+                {
+                    return writer.write (reinterpret_cast< const char * >(data), std::streamsize(size)).good ();
+                }
+            }
+
+            return false;
+        }
+
+        bool write_file (const std::string & path, const std::string & text)
+        {
+            return write_file (path, text.data (), text.size ());
+        }
+
+        /**
+         * Convierte la ruta de una imagen dentro de un directorio .atlas en el nombre de su slice:
+         * los subdirectorios se separan con puntos (como los "dir" anidados de los .sprites) y se
+         * quita la extensión.
+         */
+        std::string slice_name (const std::string & atlas_directory, const std::string & image_path)
+        {
+            std::string name = image_path.substr (atlas_directory.size () + 1);
+
+            name.erase   (name.size () - (sizeof(png_suffix) - 1));
+            std::replace (name.begin (), name.end (), '/', '.');
+
+            return name;
+        }
+
+        std::string page_name (const std::string & output, size_t page_index)
+        {
+            return page_index == 0 ? output : output + '-' + std::to_string (page_index);
+        }
+
+        std::string base_name (const std::string & path)
+        {
+            size_t slash = path.rfind ('/');
+
+            return slash == std::string::npos ? path : path.substr (slash + 1);
+        }
+
+        /**
+         * Construye una tabla .slices (ver Slice_Table) ordenando sus entradas por id.
+         */
+        std::string make_slice_table (const std::string & texture_name, uint32_t texture_width, uint32_t texture_height, std::vector< Slice_Table::Entry > & entries)
+        {
+            std::sort
+            (
+                entries.begin (),
+                entries.end   (),
+                [] (const Slice_Table::Entry & a, const Slice_Table::Entry & b) { return a.id < b.id; }
+            );
+
+            Slice_Table::Header header
+            {
+                Slice_Table::MAGIC,
+                Slice_Table::VERSION,
+                texture_width,
+                texture_height,
+                uint32_t(entries.size ()),
+                uint32_t(texture_name.size ())
+            };
+
+            std::string table(reinterpret_cast< const char * >(&header), sizeof(header));
+
+            table += texture_name;
+            table.resize (table.size () + (4 - texture_name.size () % 4) % 4, '\0');
+            table.append (reinterpret_cast< const char * >(entries.data ()), entries.size () * sizeof(Slice_Table::Entry));
+
+            return table;
+        }
+
+        /**
+         * Recorre un tag "dir" de un .sprites dando a cada "spr" el mismo nombre que le da Atlas al
+         * parsearlo (los "dir" anidados se separan con puntos y el "dir" raíz "/" no cuenta).
+         * @return false si algún slice no cabe en una entrada de la tabla.
+         */
+        bool collect_sprites (rapidxml::xml_node<> * dir_tag, const std::string & prefix, std::vector< Slice_Table::Entry > & entries)
+        {
+            for (rapidxml::xml_node<> * child = dir_tag->first_node (); child; child = child->next_sibling ())
+            {
+                rapidxml::xml_attribute<> * name_attribute = child->first_attribute ("name");
+
+                if (child->type () != rapidxml::node_element || !name_attribute) continue;
+
+                std::string name = prefix + name_attribute->value ();
+
+                if (child->name () == std::string("dir"))
+                {
+                    if (name == "/") name.clear (); else name += '.';
+
+                    if (!collect_sprites (child, name, entries)) return false;
+                }
+                else
+                if (child->name () == std::string("spr"))
+                {
+                    long values[4] = { -1, -1, -1, -1 };
+                    const char * attributes[] = { "x", "y", "w", "h" };
+
+                    for (int index = 0; index < 4; ++index)
+                    {
+                        if (rapidxml::xml_attribute<> * attribute = child->first_attribute (attributes[index]))
+                        {
+                            values[index] = std::atol (attribute->value ());
+                        }
+
+                        if (values[index] < 0 || values[index] > 0xFFFF) return false;
+                    }
+
+                    entries.push_back ({ fnv32 (name), uint16_t(values[0]), uint16_t(values[1]), uint16_t(values[2]), uint16_t(values[3]) });
+                }
+            }
+
+            return true;
+        }
+
+        /**
+         * Convierte un .sprites de darkFunction Editor en una tabla .slices equivalente.
+         */
+        bool convert_sprites (std::vector< uint8_t > xml_data, std::string & table)
+        {
+            xml_data.push_back (0);
+
+            rapidxml::xml_document<> xml;
+
+            try
+            {
+                xml.parse< 0 > (reinterpret_cast< char * >(xml_data.data ()));
+            }
+            catch (const rapidxml::parse_error & )
+            {
+                return false;
+            }
+
+            rapidxml::xml_node<>      * img_tag        = xml.first_node ("img");
+            rapidxml::xml_attribute<> * name_attribute = img_tag ? img_tag->first_attribute ("name") : nullptr;
+
+            if (!name_attribute)
+            {
+                return false;
+            }
+
+            rapidxml::xml_attribute<> * w_attribute     = img_tag->first_attribute ("w");
+            rapidxml::xml_attribute<> * h_attribute     = img_tag->first_attribute ("h");
+            rapidxml::xml_node<>      * definitions_tag = img_tag->first_node ("definitions");
+
+            std::vector< Slice_Table::Entry > entries;
+
+            if (definitions_tag)
+            {
+                for (rapidxml::xml_node<> * dir_tag = definitions_tag->first_node ("dir"); dir_tag; dir_tag = dir_tag->next_sibling ("dir"))
+                {
+                    if (!collect_sprites (dir_tag, std::string(), entries)) return false;
+                }
+            }
+
+            table = make_slice_table
+            (
+                name_attribute->value (),
+                w_attribute ? uint32_t(std::atol (w_attribute->value ())) : 0,
+                h_attribute ? uint32_t(std::atol (h_attribute->value ())) : 0,
+                entries
+            );
+
+            return true;
+        }
+
+
+        /**
+         * Lee de un tag los atributos indicados como enteros.
+         * @return false si falta alguno o si alguno está fuera del rango [minimum, maximum].
+         */
+        bool read_attributes (rapidxml::xml_node<> * tag, const char * const * names, long * values, unsigned count, long minimum, long maximum)
+        {
+            for (unsigned index = 0; index < count; ++index)
+            {
+                rapidxml::xml_attribute<> * attribute = tag->first_attribute (names[index]);
+
+                if (!attribute) return false;
+
+                values[index] = std::atol (attribute->value ());
+
+                if (values[index] < minimum || values[index] > maximum) return false;
+            }
+
+            return true;
+        }
+
+        /**
+         * Convierte un .fnt en XML de BMFont en una fuente binaria .font (ver Font_Table). Se
+         * rechazan las mismas fuentes que rechaza Raster_Font al parsear el XML.
+         */
+        bool convert_font (std::vector< uint8_t > xml_data, std::string & table)
+        {
+            xml_data.push_back (0);
+
+            rapidxml::xml_document<> xml;
+
+            try
+            {
+                xml.parse< 0 > (reinterpret_cast< char * >(xml_data.data ()));
+            }
+            catch (const rapidxml::parse_error & )
+            {
+                return false;
+            }
+
+            rapidxml::xml_node<> * font_tag   = xml.first_node ("font");
+            rapidxml::xml_node<> * info_tag   = font_tag ? font_tag->first_node ("info"  ) : nullptr;
+            rapidxml::xml_node<> * common_tag = font_tag ? font_tag->first_node ("common") : nullptr;
+            rapidxml::xml_node<> * pages_tag  = font_tag ? font_tag->first_node ("pages" ) : nullptr;
+            rapidxml::xml_node<> * chars_tag  = font_tag ? font_tag->first_node ("chars" ) : nullptr;
+            rapidxml::xml_node<> * page_tag   = pages_tag ? pages_tag->first_node ("page") : nullptr;
+
+            if (!info_tag || !common_tag || !chars_tag || !page_tag)
+            {
+                return false;
+            }
+
+            rapidxml::xml_attribute<> * face_attribute  = info_tag  ->first_attribute ("face" );
+            rapidxml::xml_attribute<> * file_attribute  = page_tag  ->first_attribute ("file" );
+            rapidxml::xml_attribute<> * pages_attribute = common_tag->first_attribute ("pages");
+
+            static const char * const common_names[] = { "lineHeight", "base" };
+            static const char * const   char_names[] = { "id", "x", "y", "width", "height", "xoffset", "yoffset", "xadvance" };
+            static const char * const kerning_names[] = { "first", "second", "amount" };
+
+            long common[2];
+
+            if
+            (
+                !face_attribute || !file_attribute ||
+                (pages_attribute && std::atol (pages_attribute->value ()) != 1) ||
+                !read_attributes (common_tag, common_names, common, 2, 0, 0xFFFF) ||
+                common[0] == 0 || common[1] == 0
+            )
+            {
+                return false;
+            }
+
+            std::vector< Font_Table::Glyph   > glyphs;
+            std::vector< Font_Table::Kerning > kernings;
+
+            for (rapidxml::xml_node<> * char_tag = chars_tag->first_node ("char"); char_tag; char_tag = char_tag->next_sibling ("char"))
+            {
+                long values[8];
+
+                if (!read_attributes (char_tag, char_names, values, 8, -0x8000, 0x10FFFF) || values[0] < 0)
+                {
+                    return false;
+                }
+
+                for (int index = 1; index < 5; ++index) if (values[index] < 0 || values[index] > 0xFFFF) return false;
+                for (int index = 5; index < 8; ++index) if (values[index] > 0x7FFF) return false;
+
+                if (values[3] == 0 || values[4] == 0)
+                {
+                    return false;
+                }
+
+                glyphs.push_back
+                ({
+                    uint32_t(values[0]),
+                    uint16_t(values[1]), uint16_t(values[2]), uint16_t(values[3]), uint16_t(values[4]),
+                    int16_t (values[5]), int16_t (values[6]), int16_t (values[7]),
+                    0
+                });
+            }
+
+            rapidxml::xml_attribute<> * count_attribute = chars_tag->first_attribute ("count");
+
+            if (glyphs.empty () || (count_attribute && std::atol (count_attribute->value ()) != 0 && size_t(std::atol (count_attribute->value ())) != glyphs.size ()))
+            {
+                return false;
+            }
+
+            if (rapidxml::xml_node<> * kernings_tag = font_tag->first_node ("kernings"))
+            {
+                for (rapidxml::xml_node<> * kerning_tag = kernings_tag->first_node ("kerning"); kerning_tag; kerning_tag = kerning_tag->next_sibling ("kerning"))
+                {
+                    long values[3];
+
+                    if (read_attributes (kerning_tag, kerning_names, values, 3, -0x8000, 0x7FFF) && values[2] != 0)
+                    {
+                        kernings.push_back ({ uint32_t(values[0]), uint32_t(values[1]), int16_t(values[2]), 0 });
+                    }
+                }
+            }
+
+            std::sort
+            (
+                glyphs.begin (),
+                glyphs.end   (),
+                [] (const Font_Table::Glyph & a, const Font_Table::Glyph & b) { return a.code < b.code; }
+            );
+
+            std::sort
+            (
+                kernings.begin (),
+                kernings.end   (),
+                [] (const Font_Table::Kerning & a, const Font_Table::Kerning & b) { return a.first < b.first || (a.first == b.first && a.second < b.second); }
+            );
+
+            for (size_t index = 1; index < glyphs.size (); ++index)
+            {
+                if (glyphs[index].code == glyphs[index - 1].code) return false;
+            }
+
+            std::string face         = face_attribute->value ();
+            std::string texture_name = file_attribute->value ();
+
+            Font_Table::Header header
+            {
+                Font_Table::MAGIC,
+                Font_Table::VERSION,
+                uint32_t(common[0]),
+                uint32_t(common[1]),
+                uint32_t(glyphs.size ()),
+                uint32_t(kernings.size ()),
+                uint32_t(face.size ()),
+                uint32_t(texture_name.size ())
+            };
+
+            table.assign (reinterpret_cast< const char * >(&header), sizeof(header));
+
+            table += face;
+            table.resize (table.size () + (4 - face.size () % 4) % 4, '\0');
+            table += texture_name;
+            table.resize (table.size () + (4 - texture_name.size () % 4) % 4, '\0');
+            table.append (reinterpret_cast< const char * >(glyphs.data   ()), glyphs.size   () * sizeof(Font_Table::Glyph  ));
+            table.append (reinterpret_cast< const char * >(kernings.data ()), kernings.size () * sizeof(Font_Table::Kerning));
+
+            return true;
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Cooker::Cooker(const Settings & settings)
+    :
+        settings(settings)
+    {
+        if (this->settings.thread_count == 0)
+        {
+            this->settings.thread_count = std::max (1u, std::thread::hardware_concurrency ());
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Cooker::run ()
+    {
+        if (!is_directory (settings.input_path))
+        {
+            report ("error: the input path is not a directory: " + settings.input_path);
+
+            return false;
+        }
+
+        jobs.clear ();
+
+        load_display_sizes ();
+        scan               ("");
+        load_manifest      ();
+
+        // Los trabajos se reparten dinámicamente: cada hilo toma el siguiente libre, lo que
+        // equilibra la carga cuando unos (los atlas) son mucho más costosos que otros:
+
+        std::atomic< size_t >      next_job(0);
+        std::vector< std::thread > workers;
+
+        unsigned thread_count = std::min< unsigned > (settings.thread_count, unsigned(std::max< size_t > (jobs.size (), 1)));
+
+        for (unsigned index = 0; index < thread_count; ++index)
+        {
+            workers.emplace_back
+            (
+                [this, &next_job] ()
+                {
+                    for (size_t index = next_job++; index < jobs.size (); index = next_job++)
+                    {
+                        jobs[index].failed = !cook (jobs[index]);
+                    }
+                }
+            );
+        }
+
+        for (auto & worker : workers) worker.join ();
+
+        size_t cooked_count  = 0;
+        size_t skipped_count = 0;
+        size_t failed_count  = 0;
+
+        for (auto & job : jobs)
+        {
+            if (job.failed) failed_count++; else
+            if (job.cooked) cooked_count++; else skipped_count++;
+        }
+
+        bool manifest_saved = save_manifest ();
+
+        std::ostringstream summary;
+
+        summary << jobs.size () << " jobs: " << cooked_count << " cooked, " << skipped_count << " up to date, " << failed_count << " failed.";
+
+        report (summary.str ());
+
+        return failed_count == 0 && manifest_saved;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Cooker::scan (const std::string & relative_path)
+    {
+        DIR * directory = opendir (join (settings.input_path, relative_path).c_str ());
+
+        if (directory)
+        {
+            std::vector< std::string > names;
+
+            while (dirent * entry = readdir (directory))
+            {
+                if (entry->d_name[0] != '.') names.push_back (entry->d_name);
+            }
+
+            closedir (directory);
+
+            // Se ordenan los nombres para que los trabajos (y el manifiesto) sean deterministas:
+
+            std::sort (names.begin (), names.end ());
+
+            for (auto & name : names)
+            {
+                std::string path = join (relative_path, name);
+
+                if (path == display_sizes_name)
+                {
+                    continue;
+                }
+
+                if (is_directory (join (settings.input_path, path)))
+                {
+                    if (ends_with (name, atlas_suffix))
+                    {
+                        Job job{ Job::ATLAS, path.substr (0, path.size () - (sizeof(atlas_suffix) - 1)), { }, 0, false, false };
+
+                        collect_pngs (path, job.inputs);
+
+                        if (!job.inputs.empty ()) jobs.push_back (job);
+                    }
+                    else
+                        scan (path);
+                }
+                else
+                if (ends_with (name, png_suffix))
+                {
+                    jobs.push_back ({ Job::IMAGE, path, { path }, 0, false, false });
+                }
+                else
+                {
+                    jobs.push_back ({ Job::COPY,  path, { path }, 0, false, false });
+                }
+            }
+        }
+        else
+            report ("warning: cannot open the directory " + join (settings.input_path, relative_path));
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Cooker::collect_pngs (const std::string & relative_path, std::vector< std::string > & files)
+    {
+        DIR * directory = opendir (join (settings.input_path, relative_path).c_str ());
+
+        if (directory)
+        {
+            std::vector< std::string > names;
+
+            while (dirent * entry = readdir (directory))
+            {
+                if (entry->d_name[0] != '.') names.push_back (entry->d_name);
+            }
+
+            closedir (directory);
+
+            std::sort (names.begin (), names.end ());
+
+            for (auto & name : names)
+            {
+                std::string path = join (relative_path, name);
+
+                if (is_directory (join (settings.input_path, path)))
+                {
+                    collect_pngs (path, files);
+                }
+                else
+                if (ends_with (name, png_suffix))
+                {
+                    files.push_back (path);
+                }
+            }
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Cooker::cook (Job & job)
+    {
+        std::vector< Buffer > data(job.inputs.size ());
+
+        // La clave del trabajo depende de los ajustes que afectan a su salida, de las rutas y del
+        // contenido de sus entradas, por lo que cualquier cambio fuerza que se vuelva a cocinar:
+
+        std::ostringstream parameters;
+
+        parameters << int(job.type) << ' ' << job.output;
+
+        if (job.type != Job::COPY)
+        {
+            parameters << ' ' << settings.premultiply;
+        }
+
+        if (job.type == Job::IMAGE)
+        {
+            parameters << ' ' << settings.max_size << " logical-size";
+        }
+
+        if (job.type == Job::COPY && (ends_with (job.output, sprites_suffix) || ends_with (job.output, fnt_suffix)))
+        {
+            parameters << ' ' << settings.binary_tables;
+        }
+
+        if (job.type == Job::ATLAS)
+        {
+            parameters << ' ' << settings.page_size << ' ' << settings.padding << ' ' << settings.extrusion << ' ' << settings.binary_tables;
+        }
+
+        job.key = fnv64 (parameters.str ());
+
+        for (size_t index = 0; index < job.inputs.size (); ++index)
+        {
+            if (!read_file (join (settings.input_path, job.inputs[index]), data[index]))
+            {
+                report ("error: cannot read " + job.inputs[index]);
+
+                return false;
+            }
+
+            job.key = job.key * 31 + fnv64 (job.inputs[index]);
+            job.key = job.key * 31 + fnv64 (data[index].data (), data[index].size ());
+
+            Display_Size display_size;
+
+            if (job.type == Job::IMAGE && find_display_size (job.inputs[index], display_size))
+            {
+                job.key = job.key * 31 + (uint64_t(display_size.width) << 32 | display_size.height);
+            }
+        }
+
+        std::string main_output = join (settings.output_path, job.type == Job::ATLAS ? job.output + png_suffix : job.output);
+
+        if (!settings.force && exists (main_output))
+        {
+            auto previous = previous_manifest.find (job.output);
+
+            if (previous != previous_manifest.end () && previous->second == job.key)
+            {
+                return true;
+            }
+        }
+
+        bool success = false;
+
+        switch (job.type)
+        {
+            case Job::COPY:  success = cook_copy  (job, data); break;
+            case Job::IMAGE: success = cook_image (job, data); break;
+            case Job::ATLAS: success = cook_atlas (job, data); break;
+        }
+
+        job.cooked = success;
+
+        if (success) report ("cooked " + job.output);
+
+        return success;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Cooker::cook_copy (const Job & job, const std::vector< Buffer > & data)
+    {
+        if (!write_file (join (settings.output_path, job.output), data[0].data (), data[0].size ()))
+        {
+            report ("error: cannot write " + job.output);
+
+            return false;
+        }
+
+        // Los .sprites hechos a mano y las fuentes de BMFont también se convierten a tablas binarias
+        // si se han pedido:
+
+        if (settings.binary_tables && (ends_with (job.output, sprites_suffix) || ends_with (job.output, fnt_suffix)))
+        {
+            bool        sprites = ends_with (job.output, sprites_suffix);
+            std::string table;
+            std::string table_path = sprites
+                ? job.output.substr (0, job.output.size () - (sizeof(sprites_suffix) - 1)) + ".slices"
+                : job.output.substr (0, job.output.size () - (sizeof(fnt_suffix    ) - 1)) + ".font";
+
+            if (!(sprites ? convert_sprites (data[0], table) : convert_font (data[0], table)))
+            {
+                report ("error: cannot convert " + job.inputs[0]);
+
+                return false;
+            }
+
+            if (!write_file (join (settings.output_path, table_path), table))
+            {
+                report ("error: cannot write " + table_path);
+
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Cooker::cook_image (const Job & job, const std::vector< Buffer > & data)
+    {
+        Color_Buffer< Rgba8888 > image;
+        std::vector< byte >      encoded;
+        Size2u                   logical_size;
+
+        if (!prepare_image (data[0], image, job.inputs[0], &logical_size))
+        {
+            return false;
+        }
+
+        // Si la imagen se ha reducido se guarda su tamaño original para que se siga dibujando igual:
+
+        bool reduced    = image.get_width () != logical_size.width || image.get_height () != logical_size.height;
+        bool encoded_ok = reduced
+                        ? png_encode (image, encoded, logical_size.width, logical_size.height)
+                        : png_encode (image, encoded);
+
+        if (!encoded_ok || !write_file (join (settings.output_path, job.output), encoded.data (), encoded.size ()))
+        {
+            report ("error: cannot write " + job.output);
+
+            return false;
+        }
+
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Cooker::cook_atlas (const Job & job, const std::vector< Buffer > & data)
+    {
+        struct Image
+        {
+            std::string              name;
+            Color_Buffer< Rgba8888 > pixels;
+        };
+
+        struct Placement
+        {
+            size_t  image;
+            Point2u position;
+        };
+
+        struct Page
+        {
+            Rectangle_Packer         packer;
+            std::vector< Placement > placements;
+        };
+
+        std::string atlas_directory = job.output + atlas_suffix;
+
+        std::vector< Image > images(job.inputs.size ());
+
+        for (size_t index = 0; index < job.inputs.size (); ++index)
+        {
+            images[index].name = slice_name (atlas_directory, job.inputs[index]);
+
+            if (!prepare_image (data[index], images[index].pixels, job.inputs[index], nullptr))
+            {
+                return false;
+            }
+        }
+
+        // Se empaqueta igual que en Atlas_Builder (las más altas primero):
+
+        const unsigned page_size = settings.page_size;
+        const unsigned extrusion = settings.extrusion;
+        const unsigned margin    = settings.extrusion * 2 + settings.padding;
+
+        std::vector< size_t > order(images.size ());
+
+        std::iota (order.begin (), order.end (), size_t(0));
+        std::stable_sort
+        (
+            order.begin (),
+            order.end   (),
+            [&images] (size_t a, size_t b)
+            {
+                const Color_Buffer< Rgba8888 > & image_a = images[a].pixels;
+                const Color_Buffer< Rgba8888 > & image_b = images[b].pixels;
+
+                return image_a.height != image_b.height ? image_a.height > image_b.height : image_a.width > image_b.width;
+            }
+        );
+
+        std::vector< Page > pages;
+
+        for (size_t index : order)
+        {
+            const Color_Buffer< Rgba8888 > & image = images[index].pixels;
+
+            Size2u  cell{ image.width + margin, image.height + margin };
+            Point2u position;
+            bool    placed = false;
+
+            for (auto & page : pages)
+            {
+                if (page.packer.insert (cell, position))
+                {
+                    page.placements.push_back ({ index, position });
+                    placed = true;
+                    break;
+                }
+            }
+
+            if (!placed)
+            {
+                pages.push_back ({ Rectangle_Packer(page_size, page_size), std::vector< Placement >() });
+
+                if (!pages.back ().packer.insert (cell, position))
+                {
+                    report ("error: " + job.inputs[index] + " does not fit in a " + std::to_string (page_size) + " pixels page");
+
+                    return false;
+                }
+
+                pages.back ().placements.push_back ({ index, position });
+            }
+        }
+
+        // Cada página se escribe como un PNG con su .sprites (y su .slices si se ha pedido):
+
+        for (size_t page_index = 0; page_index < pages.size (); ++page_index)
+        {
+            Page   & page = pages[page_index];
+            unsigned page_width  = 1;
+            unsigned page_height = 1;
+
+            // Las páginas se recortan a la potencia de 2 que abarca lo ocupado:
+
+            for (auto & placement : page.placements)
+            {
+                const Color_Buffer< Rgba8888 > & image = images[placement.image].pixels;
+
+                while (page_width  < placement.position[0] + image.width  + margin) page_width  <<= 1;
+                while (page_height < placement.position[1] + image.height + margin) page_height <<= 1;
+            }
+
+            page_width  = std::min (page_width,  page_size);
+            page_height = std::min (page_height, page_size);
+
+            // Las entradas se ordenan por nombre para que las salidas sean deterministas:
+
+            std::sort
+            (
+                page.placements.begin (),
+                page.placements.end   (),
+                [&images] (const Placement & a, const Placement & b)
+                {
+                    return images[a.image].name < images[b.image].name;
+                }
+            );
+
+            Color_Buffer< Rgba8888 > pixels(page_width, page_height);
+
+            for (auto & placement : page.placements)
+            {
+                copy_extruded (images[placement.image].pixels, pixels, placement.position[0] + extrusion, placement.position[1] + extrusion, extrusion);
+            }
+
+            std::string         name         = page_name (job.output, page_index);
+            std::string         texture_name = base_name (name) + png_suffix;
+            std::vector< byte > encoded;
+
+            if (!png_encode (pixels, encoded) || !write_file (join (settings.output_path, name + png_suffix), encoded.data (), encoded.size ()))
+            {
+                report ("error: cannot write " + name + png_suffix);
+
+                return false;
+            }
+
+            std::ostringstream sprites;
+
+            sprites << "<?xml version=\"1.0\"?>\n"
+                    << "<!-- Generated by basics-cooker -->\n"
+                    << "<img name=\"" << texture_name << "\" w=\"" << page_width << "\" h=\"" << page_height << "\">\n"
+                    << "\t<definitions>\n"
+                    << "\t\t<dir name=\"/\">\n";
+
+            for (auto & placement : page.placements)
+            {
+                const Image & image = images[placement.image];
+
+                sprites << "\t\t\t<spr name=\"" << image.name
+                        << "\" x=\"" << placement.position[0] + extrusion
+                        << "\" y=\"" << placement.position[1] + extrusion
+                        << "\" w=\"" << image.pixels.width
+                        << "\" h=\"" << image.pixels.height << "\"/>\n";
+            }
+
+            sprites << "\t\t</dir>\n"
+                    << "\t</definitions>\n"
+                    << "</img>\n";
+
+            if (!write_file (join (settings.output_path, name + ".sprites"), sprites.str ()))
+            {
+                report ("error: cannot write " + name + ".sprites");
+
+                return false;
+            }
+
+            if (settings.binary_tables)
+            {
+                std::vector< Slice_Table::Entry > entries;
+
+                for (auto & placement : page.placements)
+                {
+                    const Image & image = images[placement.image];
+
+                    entries.push_back
+                    ({
+                        fnv32 (image.name),
+                        uint16_t(placement.position[0] + extrusion),
+                        uint16_t(placement.position[1] + extrusion),
+                        uint16_t(image.pixels.width ),
+                        uint16_t(image.pixels.height)
+                    });
+                }
+
+                std::string table = make_slice_table (texture_name, page_width, page_height, entries);
+
+                if (!write_file (join (settings.output_path, name + ".slices"), table))
+                {
+                    report ("error: cannot write " + name + ".slices");
+
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Cooker::prepare_image (const Buffer & png, Color_Buffer< Rgba8888 > & image, const std::string & name, Size2u * logical_size)
+    {
+        unsigned width, height;
+
+        if (!png_decode (png, image, width, height))
+        {
+            report ("error: cannot decode " + name);
+
+            return false;
+        }
+
+        // Las imágenes de los atlas no se reducen porque las tablas de slices no guardan un tamaño
+        // lógico distinto del de los píxeles, por lo que los sprites se dibujarían más pequeños:
+
+        if (!logical_size)
+        {
+            if (settings.premultiply) premultiply_alpha (image);
+
+            return true;
+        }
+
+        *logical_size = { width, height };
+
+        // Las imágenes que exceden el tamaño máximo o el tamaño con el que se dibujan se reducen
+        // conservando su proporción:
+
+        unsigned     max_width  = settings.max_size > 0 ? settings.max_size : width;
+        unsigned     max_height = settings.max_size > 0 ? settings.max_size : height;
+        Display_Size display_size;
+
+        if (find_display_size (name, display_size))
+        {
+            max_width  = std::min (max_width,  display_size.width );
+            max_height = std::min (max_height, display_size.height);
+        }
+
+        if (width > max_width || height > max_height)
+        {
+            float    scale  = std::min (float(max_width) / float(width), float(max_height) / float(height));
+            unsigned target_width  = std::max (1u, unsigned(width  * scale + .5f));
+            unsigned target_height = std::max (1u, unsigned(height * scale + .5f));
+
+            Color_Buffer< Rgba8888 > reduced;
+
+            if (!downscale (image, reduced, std::min (target_width, max_width), std::min (target_height, max_height)))
+            {
+                report ("error: cannot downscale " + name);
+
+                return false;
+            }
+
+            image = std::move (reduced);
+        }
+
+        if (settings.premultiply)
+        {
+            premultiply_alpha (image);
+        }
+
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Cooker::load_manifest ()
+    {
+        previous_manifest.clear ();
+
+        std::ifstream reader(join (settings.output_path, manifest_name));
+        std::string   line;
+
+        while (std::getline (reader, line))
+        {
+            unsigned long long key;
+            int                length = 0;
+
+            if (std::sscanf (line.c_str (), "%16llx %n", &key, &length) == 1 && length > 0)
+            {
+                previous_manifest[line.substr (size_t(length))] = uint64_t(key);
+            }
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Cooker::save_manifest () const
+    {
+        // Solo se anotan los trabajos correctos, de modo que los fallidos se repitan la próxima vez:
+
+        std::string text;
+        char        key[32];
+
+        for (auto & job : jobs)
+        {
+            if (!job.failed)
+            {
+                std::snprintf (key, sizeof(key), "%016llx ", (unsigned long long)job.key);
+
+                text += key;
+                text += job.output;
+                text += '\n';
+            }
+        }
+
+        return write_file (join (settings.output_path, manifest_name), text);
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Cooker::load_display_sizes ()
+    {
+        display_sizes.clear ();
+
+        std::ifstream reader(join (settings.input_path, display_sizes_name));
+        std::string   line;
+
+        while (std::getline (reader, line))
+        {
+            std::istringstream fields(line);
+            std::string        path;
+            Display_Size       size{ 0, 0 };
+
+            if (!(fields >> path) || path[0] == '#')
+            {
+                continue;
+            }
+
+            if (!(fields >> size.width) || size.width == 0)
+            {
+                report ("warning: ignoring the display size of " + path);
+                continue;
+            }
+
+            if (!(fields >> size.height) || size.height == 0)
+            {
+                size.height = size.width;
+            }
+
+            display_sizes[path] = size;
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Cooker::find_display_size (const std::string & path, Display_Size & size) const
+    {
+        // Primero se busca la ruta completa y después la de cada directorio que la contiene,
+        // empezando por el más cercano:
+
+        auto entry = display_sizes.find (path);
+
+        for (size_t end = path.size (); entry == display_sizes.end () && end != std::string::npos && end > 0; )
+        {
+            end   = path.find_last_of ('/', end - 1);
+            entry = end != std::string::npos ? display_sizes.find (path.substr (0, end + 1)) : display_sizes.end ();
+        }
+
+        if (entry != display_sizes.end ())
+        {
+            size = entry->second;
+            return true;
+        }
+
+        return false;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Cooker::report (const std::string & message)
+    {
+        std::lock_guard< std::mutex > lock(output_mutex);
+
+        std::cout << message << std::endl;
+    }
+
+}}
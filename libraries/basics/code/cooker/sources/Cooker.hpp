@@ -0,0 +1,140 @@
+/*
+ * COOKER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803151200
+ */
+
+#ifndef BASICS_COOKER_HEADER
+#define BASICS_COOKER_HEADER
+
+    #include <cstdint>
+    #include <map>
+    #include <mutex>
+    #include <string>
+    #include <vector>
+    #include <basics/Color_Buffer>
+    #include <basics/Size>
+
+    namespace basics { namespace cooker
+    {
+
+        struct Settings
+        {
+            std::string input_path;
+            std::string output_path;
+            unsigned    thread_count;
+            unsigned    max_size;                       ///< Lado máximo de las imágenes (0 = sin límite).
+            unsigned    page_size;                      ///< Tamaño máximo de las páginas de los atlas.
+            unsigned    padding;
+            unsigned    extrusion;
+            bool        binary_tables;                  ///< Escribir también tablas .slices y fuentes .font binarias.
+            bool        premultiply;
+            bool        force;                          ///< Ignorar el manifiesto y cocinarlo todo.
+        };
+
+        /**
+         * Prepara el árbol de assets para el dispositivo:
+         *
+         *   - Los directorios cuyo nombre termina en ".atlas" se empaquetan en un atlas (una o varias
+         *     páginas PNG con su .sprites y, opcionalmente, su .slices).
+         *   - Los demás PNG se reducen si superan el tamaño máximo o el tamaño con el que se dibujan
+         *     (ver display-sizes.txt más abajo) y se vuelven a codificar. Las reducidas guardan su
+         *     tamaño original (chunk bsSz de png_encode), que Texture_2D usa como tamaño lógico para
+         *     que se sigan dibujando igual.
+         *   - El resto de archivos se copian tal cual. Los .sprites copiados se convierten también a
+         *     .slices y los .fnt de BMFont a .font si se piden tablas binarias.
+         *
+         * El archivo display-sizes.txt del directorio de entrada (opcional) indica el tamaño máximo
+         * en píxeles con el que se dibuja cada imagen, con una entrada por línea:
+         *
+         *     <ruta> <ancho> [<alto>]
+         *
+         * La ruta es relativa al directorio de entrada y, si termina en '/', se aplica a todas las
+         * imágenes del directorio (prevalece la entrada más específica). Las imágenes de los atlas
+         * no se reducen (ni por este archivo ni por el tamaño máximo) porque las tablas de slices no
+         * pueden guardar su tamaño original. Las líneas vacías y las que empiezan por '#' no se
+         * tienen en cuenta. El archivo no se copia a la salida.
+         *
+         * Cada trabajo se identifica con un hash de sus entradas y de los ajustes que le afectan, que
+         * se guarda en manifest.txt para no repetir el trabajo en la siguiente ejecución.
+         */
+        class Cooker
+        {
+
+            struct Job
+            {
+                enum Type { COPY, IMAGE, ATLAS };
+
+                Type                       type;
+                std::string                output;      ///< Ruta relativa de la salida (sin extensión para los atlas).
+                std::vector< std::string > inputs;      ///< Rutas relativas de las entradas.
+                uint64_t                   key;
+                bool                       cooked;
+                bool                       failed;
+            };
+
+            struct Display_Size
+            {
+                unsigned width;
+                unsigned height;
+            };
+
+            typedef std::map< std::string, uint64_t     > Manifest;
+            typedef std::map< std::string, Display_Size > Display_Size_Map;
+            typedef std::vector< uint8_t >                Buffer;
+
+        private:
+
+            Settings           settings;
+            std::vector< Job > jobs;
+            Manifest           previous_manifest;
+            Display_Size_Map   display_sizes;
+            std::mutex         output_mutex;
+
+        public:
+
+            Cooker(const Settings & settings);
+
+        public:
+
+            /**
+             * Cocina todo el árbol de entrada.
+             * @return false si algún trabajo ha fallado.
+             */
+            bool run ();
+
+        private:
+
+            void scan          (const std::string & relative_path);
+            void collect_pngs  (const std::string & relative_path, std::vector< std::string > & files);
+
+            bool cook          (Job & job);
+            bool cook_copy     (const Job & job, const std::vector< Buffer > & data);
+            bool cook_image    (const Job & job, const std::vector< Buffer > & data);
+            bool cook_atlas    (const Job & job, const std::vector< Buffer > & data);
+
+            /**
+             * Decodifica una imagen y, si se indica dónde guardar su tamaño lógico, la reduce según
+             * el tamaño máximo y display-sizes.txt.
+             */
+            bool prepare_image (const Buffer & png, Color_Buffer< Rgba8888 > & image, const std::string & name, Size2u * logical_size);
+
+            void load_manifest ();
+            bool save_manifest () const;
+
+            void load_display_sizes ();
+            bool find_display_size  (const std::string & path, Display_Size & size) const;
+
+            void report        (const std::string & message);
+
+        };
+
+    }}
+
+#endif
@@ -0,0 +1,103 @@
+/*
+ * COOKER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803151200
+ */
+
+#include "Cooker.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace basics::cooker;
+
+namespace
+{
+
+    void print_usage ()
+    {
+        std::cout <<
+            "usage: basics-cooker [options] <input directory> <output directory>\n"
+            "\n"
+            "  --threads <n>       number of worker threads (default: all the cores)\n"
+            "  --max-size <n>      downscale the images larger than n pixels (default: 2048, 0 = never)\n"
+            "                      (except the atlas slices), keeping their original size as the\n"
+            "                      size at which they are drawn\n"
+            "  --page-size <n>     maximum size of the atlas pages (default: 1024)\n"
+            "  --padding <n>       empty pixels between atlas slices (default: 2)\n"
+            "  --extrusion <n>     border pixels replicated around each slice (default: 1)\n"
+            "  --binary            also write binary .slices tables next to the .sprites\n"
+            "                      (including the .sprites that are copied as they are)\n"
+            "                      and binary .font files next to the BMFont .fnt files\n"
+            "  --premultiply       premultiply the alpha of the images\n"
+            "  --force             ignore the manifest and cook everything\n"
+            "\n"
+            "Directories named <name>.atlas are packed into <name>.png + <name>.sprites.\n"
+            "The images listed in <input directory>/display-sizes.txt (\"<path> <width> [<height>]\"\n"
+            "per line, a path ending in '/' applies to a whole directory) are also downscaled\n"
+            "to the size at which they are drawn (the atlas slices are never downscaled).\n";
+    }
+
+    bool parse_unsigned (int & index, int argc, char * argv[], unsigned & value)
+    {
+        if (index + 1 < argc)
+        {
+            char * end;
+            long   parsed = std::strtol (argv[++index], &end, 10);
+
+            if (*end == '\0' && parsed >= 0)
+            {
+                value = unsigned(parsed);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+}
+
+int main (int argc, char * argv[])
+{
+    Settings settings{ "", "", 0, 2048, 1024, 2, 1, false, false, false };
+
+    for (int index = 1; index < argc; ++index)
+    {
+        const char * argument = argv[index];
+        bool         valid    = true;
+
+        if (!std::strcmp (argument, "--threads"    )) valid = parse_unsigned (index, argc, argv, settings.thread_count); else
+        if (!std::strcmp (argument, "--max-size"   )) valid = parse_unsigned (index, argc, argv, settings.max_size    ); else
+        if (!std::strcmp (argument, "--page-size"  )) valid = parse_unsigned (index, argc, argv, settings.page_size   ); else
+        if (!std::strcmp (argument, "--padding"    )) valid = parse_unsigned (index, argc, argv, settings.padding     ); else
+        if (!std::strcmp (argument, "--extrusion"  )) valid = parse_unsigned (index, argc, argv, settings.extrusion   ); else
+        if (!std::strcmp (argument, "--binary"     )) settings.binary_tables = true; else
+        if (!std::strcmp (argument, "--premultiply")) settings.premultiply   = true; else
+        if (!std::strcmp (argument, "--force"      )) settings.force         = true; else
+        if (argument[0] == '-') valid = false; else
+        if (settings.input_path .empty ()) settings.input_path  = argument; else
+        if (settings.output_path.empty ()) settings.output_path = argument; else valid = false;
+
+        if (!valid)
+        {
+            print_usage ();
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (settings.input_path.empty () || settings.output_path.empty () || settings.page_size == 0)
+    {
+        print_usage ();
+        return EXIT_FAILURE;
+    }
+
+    Cooker cooker(settings);
+
+    return cooker.run () ? EXIT_SUCCESS : EXIT_FAILURE;
+}
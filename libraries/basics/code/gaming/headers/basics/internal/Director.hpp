@@ -18,6 +18,7 @@
     #include <basics/Event_Queue>
     #include <basics/Graphics_Context>
     #include <basics/Graphics_Resource_Cache>
+    #include <basics/Prefetcher>
     #include <basics/Window>
 
     namespace basics
@@ -69,6 +70,7 @@
 
             Graphics_Context_Factory graphics_context_factory;
             Graphics_Resource_Cache  graphics_resource_cache;
+            Prefetcher               prefetcher;
 
         private:
 
@@ -83,6 +85,23 @@
 
             Graphics_Context::Accessor lock_graphics_context ();
 
+            /**
+             * Permite consultar la memoria de vídeo ocupada por los recursos y limitarla con
+             * set_budget().
+             */
+            Graphics_Resource_Cache & get_graphics_resource_cache ()
+            {
+                return graphics_resource_cache;
+            }
+
+            /**
+             * Permite que una escena pida los assets de las escenas que pueden venir después.
+             */
+            Prefetcher & get_prefetcher ()
+            {
+                return prefetcher;
+            }
+
         public:
 
             void run_scene (const std::shared_ptr< Scene > & new_scene);
@@ -0,0 +1,148 @@
+/*
+ * LOADING SCHEDULER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803311000
+ */
+
+#ifndef BASICS_LOADING_SCHEDULER_HEADER
+#define BASICS_LOADING_SCHEDULER_HEADER
+
+    #include <deque>
+    #include <functional>
+    #include <basics/Id>
+    #include <basics/Non_Copyable>
+
+    namespace basics
+    {
+
+        /**
+         * Reparte el trabajo de carga de una escena entre varios fotogramas. Las tareas se encargan
+         * con una estimación de su coste (en cualquier unidad proporcional al tiempo que tardan, como
+         * bytes o píxeles) y en cada fotograma run() ejecuta todas las que caben en el presupuesto de
+         * tiempo. El tiempo por unidad de coste se aprende de lo que tardan las tareas terminadas, de
+         * modo que en un dispositivo rápido se ejecutan muchas por fotograma y en uno lento pocas.
+         * Se debe usar desde un único hilo (normalmente el de la escena).
+         */
+        class Loading_Scheduler : Non_Copyable
+        {
+        public:
+
+            /**
+             * Paso de una tarea. Retorna true cuando la tarea ha terminado y false si todavía no se
+             * puede completar (por ejemplo, porque espera a una decodificación en otro hilo), en cuyo
+             * caso se vuelve a llamar más adelante.
+             */
+            typedef std::function< bool () > Step;
+
+        private:
+
+            struct Task
+            {
+                Id     id;
+                float  cost;                            ///< Coste estimado.
+                float  spent;                           ///< Milisegundos gastados en sus pasos.
+                Step   step;
+            };
+
+            std::deque< Task > tasks;
+
+            float    budget;                            ///< Milisegundos por fotograma.
+            float    milliseconds_per_unit;             ///< Tiempo aprendido por unidad de coste (0 si aún no se sabe).
+            float    total_cost;
+            float    completed_cost;
+            unsigned completed_count;
+
+        public:
+
+            /**
+             * @param budget_in_milliseconds Tiempo de cada fotograma que se puede dedicar a cargar.
+             * @param initial_milliseconds_per_unit Estimación inicial del tiempo por unidad de coste
+             *     (0 para que el primer fotograma ejecute una sola tarea y lo mida).
+             */
+            Loading_Scheduler(float budget_in_milliseconds = 8.f, float initial_milliseconds_per_unit = 0.f);
+
+        public:
+
+            /**
+             * Encarga una tarea. Las tareas se ejecutan en el orden en que se encargan.
+             * @param estimated_cost Coste estimado (un valor <= 0 cuenta como 1).
+             */
+            void add (Id id, float estimated_cost, const Step & step);
+
+            /**
+             * Ejecuta tareas hasta agotar el presupuesto de tiempo. Antes de ejecutar cada tarea se
+             * predice lo que tardará y no se empieza si no cabe en lo que queda, salvo que sea la
+             * primera del fotograma (así siempre se avanza). Las tareas que no pueden terminar se
+             * dejan para el siguiente fotograma y se sigue con las demás.
+             * @return Número de tareas terminadas en la llamada.
+             */
+            unsigned run ();
+
+            /**
+             * Descarta las tareas pendientes y reinicia el progreso (lo aprendido se conserva).
+             */
+            void clear ();
+
+        public:
+
+            void set_budget (float budget_in_milliseconds)
+            {
+                budget = budget_in_milliseconds;
+            }
+
+            float get_budget () const
+            {
+                return budget;
+            }
+
+            /**
+             * Retorna el tiempo estimado por unidad de coste aprendido hasta el momento.
+             */
+            float get_milliseconds_per_unit () const
+            {
+                return milliseconds_per_unit;
+            }
+
+            /**
+             * Retorna la fracción del coste total encargado que ya se ha completado, entre 0 y 1
+             * (1 si no hay nada encargado). Sirve para dibujar el progreso en las pantallas de carga.
+             */
+            float get_progress () const
+            {
+                return total_cost > 0.f ? completed_cost / total_cost : 1.f;
+            }
+
+            /**
+             * Retorna una estimación de los milisegundos de trabajo que quedan.
+             */
+            float get_remaining_milliseconds () const
+            {
+                return (total_cost - completed_cost) * milliseconds_per_unit;
+            }
+
+            unsigned get_pending_count () const
+            {
+                return unsigned(tasks.size ());
+            }
+
+            unsigned get_completed_count () const
+            {
+                return completed_count;
+            }
+
+            bool is_done () const
+            {
+                return tasks.empty ();
+            }
+
+        };
+
+    }
+
+#endif
@@ -0,0 +1,132 @@
+/*
+ * PREFETCHER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803301000
+ */
+
+#ifndef BASICS_PREFETCHER_HEADER
+#define BASICS_PREFETCHER_HEADER
+
+    #include <memory>
+    #include <mutex>
+    #include <string>
+    #include <unordered_set>
+    #include <basics/Asset_Manifest>
+    #include <basics/Asset_Reader>
+    #include <basics/Non_Copyable>
+
+    namespace basics
+    {
+
+        /**
+         * Lee por adelantado los assets de las escenas que probablemente se van a ejecutar a
+         * continuación (a partir de sus manifiestos) mientras se ejecuta la actual, de modo que al
+         * cargarlos ya estén en la caché del sistema. Sigue las dependencias de los atlas y de las
+         * fuentes (sus tablas binarias y sus texturas) y no vuelve a pedir los assets que ya ha pedido
+         * para otra escena. Lo tiene el Director y se usa desde cualquier escena.
+         *
+         * Los assets se leen completos con un Asset_Reader de un solo hilo y su contenido se descarta
+         * después de recorrerlo, por lo que no se queda en memoria nada que no esté en la caché del
+         * sistema. En Linux se leen con io_uring (o con el Thread_Pool del lector). En Android se
+         * proyectan con AAssetManager en el hilo del lector: los que están comprimidos en el APK se
+         * descomprimen al proyectarlos y los demás se leen al recorrer sus páginas. Los assets de los
+         * archivos montados (Asset_Archive) ya están en memoria y no se leen.
+         */
+        class Prefetcher : Non_Copyable
+        {
+        public:
+
+            struct Statistics
+            {
+                unsigned manifests;                     ///< Manifiestos procesados.
+                unsigned requests;                      ///< Assets pedidos (incluidas las dependencias).
+                unsigned duplicates;                    ///< Assets o manifiestos que no se han pedido porque ya se habían pedido.
+                unsigned dependencies;                  ///< Texturas pedidas por ser dependencias de atlas o fuentes.
+                unsigned skipped;                       ///< Assets que no se han pedido por superar el presupuesto.
+                size_t   estimated_size;                ///< Suma de los tamaños estimados de los assets pedidos.
+                size_t   read_size;                     ///< Bytes leídos de los assets pedidos que existen.
+            };
+
+        private:
+
+            std::unordered_set< std::string > requested;    ///< Rutas ya pedidas (de cualquier escena).
+            std::unordered_set< std::string > manifests;    ///< Manifiestos ya pedidos.
+            Statistics                        statistics;
+            size_t                            budget;       ///< Límite de estimated_size (0 si no hay límite).
+            std::mutex                        mutex;
+
+            std::unique_ptr< Asset_Reader >   reader;       ///< Se crea al usarlo y se destruye el primero para que sus callbacks no usen lo demás.
+
+        public:
+
+            Prefetcher();
+
+        public:
+
+            /**
+             * Pide los assets de un manifiesto de escena (ver Asset_Manifest). El manifiesto se lee y
+             * se parsea en el hilo del lector, por lo que no retrasa a la escena, y no se vuelve a
+             * leer si ya se ha pedido. No espera a que se lean los assets.
+             */
+            void prefetch (const std::string & manifest_path);
+
+            void prefetch (const Asset_Manifest & manifest);
+
+            /**
+             * Limita la suma de los tamaños estimados de los assets que se piden para no desalojar de
+             * la caché del sistema lo que usa la escena actual en dispositivos con poca memoria.
+             * @param new_budget Tamaño en bytes (0 para no limitarlo).
+             */
+            void set_budget (size_t new_budget)
+            {
+                std::lock_guard< std::mutex > lock(mutex);
+
+                budget = new_budget;
+            }
+
+            bool is_requested (const std::string & path)
+            {
+                std::lock_guard< std::mutex > lock(mutex);
+
+                return requested.count (path) > 0;
+            }
+
+            Statistics get_statistics ()
+            {
+                std::lock_guard< std::mutex > lock(mutex);
+
+                return statistics;
+            }
+
+            /**
+             * Olvida los assets pedidos para que se puedan volver a pedir (por ejemplo, después de
+             * que el sistema haya liberado memoria).
+             */
+            void forget ()
+            {
+                std::lock_guard< std::mutex > lock(mutex);
+
+                requested.clear ();
+                manifests.clear ();
+            }
+
+        private:
+
+            Asset_Reader & get_reader ();
+
+            bool request          (const std::string & path, size_t estimated_size);
+            void read_asset       (const std::string & path);
+            void read_descriptor  (const std::string & path, const std::string & fallback_path, Asset_Manifest::Kind kind);
+            void prefetch_texture (const Asset_Reader::Read & descriptor, Asset_Manifest::Kind kind);
+
+        };
+
+    }
+
+#endif
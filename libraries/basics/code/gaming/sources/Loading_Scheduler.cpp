@@ -0,0 +1,135 @@
+/*
+ * LOADING SCHEDULER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803311000
+ */
+
+#include <basics/Loading_Scheduler>
+#include <basics/Timer>
+
+namespace basics
+{
+
+    namespace
+    {
+
+        // Peso de la última medida en la media del tiempo por unidad de coste. Con un valor
+        // intermedio la estimación se adapta en pocas tareas sin que una aislada la descontrole:
+
+        const float learning_rate = .25f;
+
+        float milliseconds_since (const Timer & timer)
+        {
+            return timer.get_elapsed_seconds () * 1000.f;
+        }
+
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Loading_Scheduler::Loading_Scheduler(float budget_in_milliseconds, float initial_milliseconds_per_unit)
+    :
+        budget               (budget_in_milliseconds       ),
+        milliseconds_per_unit(initial_milliseconds_per_unit),
+        total_cost           (0.f                          ),
+        completed_cost       (0.f                          ),
+        completed_count      (0                            )
+    {
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Loading_Scheduler::add (Id id, float estimated_cost, const Step & step)
+    {
+        Task task;
+
+        task.id    = id;
+        task.cost  = estimated_cost > 0.f ? estimated_cost : 1.f;
+        task.spent = 0.f;
+        task.step  = step;
+
+        total_cost += task.cost;
+
+        tasks.push_back (task);
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    unsigned Loading_Scheduler::run ()
+    {
+        Timer    timer;
+        unsigned finished = 0;
+        unsigned started  = 0;
+
+        // Cada tarea se intenta como mucho una vez por llamada, incluidas las que se aplazan:
+
+        for (size_t attempts = tasks.size (); attempts > 0 && !tasks.empty (); --attempts)
+        {
+            Task & task = tasks.front ();
+
+            // Sin una estimación del tiempo por unidad no se puede predecir nada, por lo que solo
+            // se termina una tarea para medirla (las que se aplazan no sirven para medir):
+
+            if (started > 0)
+            {
+                if (milliseconds_per_unit <= 0.f && finished > 0) break;
+
+                float predicted = task.cost * milliseconds_per_unit - task.spent;
+
+                if (milliseconds_since (timer) + predicted > budget) break;
+            }
+
+            Timer step_timer;
+            bool  done = task.step ();
+
+            task.spent += milliseconds_since (step_timer);
+
+            started++;
+
+            if (done)
+            {
+                float measured = task.spent / task.cost;
+
+                milliseconds_per_unit = milliseconds_per_unit > 0.f
+                                      ? milliseconds_per_unit + (measured - milliseconds_per_unit) * learning_rate
+                                      : measured;
+
+                completed_cost += task.cost;
+                completed_count++;
+                finished++;
+
+                tasks.pop_front ();
+            }
+            else
+            {
+                // La tarea espera a algo que no depende de ella, por lo que se deja para después y
+                // se aprovecha el presupuesto con las siguientes:
+
+                tasks.push_back (std::move (task));
+                tasks.pop_front ();
+            }
+
+            if (milliseconds_since (timer) >= budget) break;
+        }
+
+        return finished;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Loading_Scheduler::clear ()
+    {
+        tasks.clear ();
+
+        total_cost      = 0.f;
+        completed_cost  = 0.f;
+        completed_count = 0;
+    }
+
+}
@@ -0,0 +1,360 @@
+/*
+ * PREFETCHER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803301000
+ */
+
+#include <cstring>
+#include <basics/Font_Table>
+#include <basics/Log>
+#include <basics/Prefetcher>
+#include <basics/Slice_Table>
+
+using namespace std;
+
+namespace basics
+{
+
+    namespace
+    {
+
+        bool ends_with (const string & text, const char * suffix)
+        {
+            size_t length = std::strlen (suffix);
+
+            return text.size () > length && text.compare (text.size () - length, length, suffix) == 0;
+        }
+
+        string replace_extension (const string & path, const char * old_extension, const char * new_extension)
+        {
+            return path.substr (0, path.size () - std::strlen (old_extension)) + new_extension;
+        }
+
+        /**
+         * Busca el valor de un atributo del primer tag con el nombre indicado de un XML sin
+         * parsearlo completo (basta para los .sprites y los .fnt, que tienen ese tag una vez).
+         */
+        bool find_attribute (const Asset::Mapping & xml, const char * tag, const char * attribute, string & value)
+        {
+            string text(xml.begin (), xml.end ());
+            size_t tag_start = text.find (string("<") + tag);
+
+            if (tag_start == string::npos)
+            {
+                return false;
+            }
+
+            string prefix          = string(" ") + attribute + "=\"";
+            size_t tag_end         = text.find ('>', tag_start);
+            size_t attribute_start = text.find (prefix, tag_start);
+
+            if (attribute_start == string::npos || attribute_start > tag_end)
+            {
+                return false;
+            }
+
+            size_t value_start = attribute_start + prefix.size ();
+            size_t value_end   = text.find ('"', value_start);
+
+            if (value_end == string::npos)
+            {
+                return false;
+            }
+
+            value = text.substr (value_start, value_end - value_start);
+
+            return true;
+        }
+
+        /**
+         * Recorre el contenido de un asset tocando un byte por página para que también se lean las
+         * páginas de los que se entregan proyectados en memoria sin haberlas leído todavía.
+         * @return Tamaño del asset.
+         */
+        size_t touch (const Asset::Mapping & data)
+        {
+            const size_t  page_size = 4096;
+            volatile byte sink      = 0;
+
+            for (size_t offset = 0; offset < data.get_size (); offset += page_size)
+            {
+                sink ^= data.get_data ()[offset];
+            }
+
+            return data.get_size ();
+        }
+
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Prefetcher::Prefetcher()
+    :
+        statistics(),
+        budget    (0)
+    {
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Prefetcher::prefetch (const string & manifest_path)
+    {
+        {
+            std::lock_guard< std::mutex > lock(mutex);
+
+            if (!manifests.insert (manifest_path).second)
+            {
+                ++statistics.duplicates;
+
+                return;
+            }
+        }
+
+        get_reader ().read
+        (
+            manifest_path,
+            [this] (const Asset_Reader::Read & read)
+            {
+                if (read.has_failed ())
+                {
+                    basics::log.w ("Prefetcher: cannot read the manifest " + read.get_path () + '.');
+                    return;
+                }
+
+                Asset_Manifest manifest;
+
+                manifest.parse (read.get_data ().begin (), read.get_data ().end ());
+
+                prefetch (manifest);
+            }
+        );
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Prefetcher::prefetch (const Asset_Manifest & manifest)
+    {
+        {
+            std::lock_guard< std::mutex > lock(mutex);
+
+            ++statistics.manifests;
+        }
+
+        // Los assets sin dependencias se leen sin más. De los atlas y las fuentes se lee la tabla que
+        // van a usar (la binaria si la hay) para saber cuál es su textura:
+
+        for (auto & entry : manifest.get_entries ())
+        {
+            if (!request (entry.path, entry.estimated_size))
+            {
+                continue;
+            }
+
+            switch (entry.kind)
+            {
+                case Asset_Manifest::ATLAS:
+                {
+                    if (ends_with (entry.path, ".sprites"))
+                    {
+                        read_descriptor (replace_extension (entry.path, ".sprites", ".slices"), entry.path, entry.kind);
+                    }
+                    else
+                        read_descriptor (entry.path, string(), entry.kind);
+
+                    break;
+                }
+
+                case Asset_Manifest::FONT:
+                {
+                    if (ends_with (entry.path, ".fnt"))
+                    {
+                        read_descriptor (replace_extension (entry.path, ".fnt", ".font"), entry.path, entry.kind);
+                    }
+                    else
+                        read_descriptor (entry.path, string(), entry.kind);
+
+                    break;
+                }
+
+                default:
+                {
+                    read_asset (entry.path);
+                }
+            }
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Asset_Reader & Prefetcher::get_reader ()
+    {
+        // Solo se crea desde prefetch(), por lo que ya existe cuando lo usan los callbacks de las
+        // lecturas. Con un solo hilo las lecturas anticipadas no compiten por los núcleos con la
+        // escena que se está ejecutando:
+
+        if (!reader)
+        {
+            reader.reset (new Asset_Reader(1));
+        }
+
+        return *reader;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    bool Prefetcher::request (const string & path, size_t estimated_size)
+    {
+        std::lock_guard< std::mutex > lock(mutex);
+
+        if (requested.count (path) > 0)
+        {
+            ++statistics.duplicates;
+
+            return false;
+        }
+
+        if (budget > 0 && statistics.estimated_size + estimated_size > budget)
+        {
+            ++statistics.skipped;
+
+            return false;
+        }
+
+        requested.insert (path);
+
+        ++statistics.requests;
+
+        statistics.estimated_size += estimated_size;
+
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Prefetcher::read_asset (const string & path)
+    {
+        // El contenido se suelta al terminar el callback. Lo que se consigue es que esté en la caché
+        // del sistema cuando se cargue de verdad:
+
+        get_reader ().read
+        (
+            path,
+            [this] (const Asset_Reader::Read & read)
+            {
+                if (!read.has_failed ())
+                {
+                    size_t size = touch (read.get_data ());
+
+                    std::lock_guard< std::mutex > lock(mutex);
+
+                    statistics.read_size += size;
+                }
+            }
+        );
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Prefetcher::read_descriptor (const string & path, const string & fallback_path, Asset_Manifest::Kind kind)
+    {
+        // Si la tabla binaria no existe se lee la que está en XML:
+
+        get_reader ().read
+        (
+            path,
+            [this, fallback_path, kind] (const Asset_Reader::Read & read)
+            {
+                if (!read.has_failed ())
+                {
+                    {
+                        std::lock_guard< std::mutex > lock(mutex);
+
+                        statistics.read_size += read.get_data ().get_size ();
+                    }
+
+                    prefetch_texture (read, kind);
+                }
+                else
+                if (!fallback_path.empty ())
+                {
+                    read_descriptor (fallback_path, string(), kind);
+                }
+            }
+        );
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Prefetcher::prefetch_texture (const Asset_Reader::Read & descriptor, Asset_Manifest::Kind kind)
+    {
+        const string         & path = descriptor.get_path ();
+        const Asset::Mapping & data = descriptor.get_data ();
+
+        string texture_name;
+
+        if (ends_with (path, ".slices"))
+        {
+            Slice_Table::Header header;
+
+            if (data.get_size () >= sizeof(header))
+            {
+                std::memcpy (&header, data.get_data (), sizeof(header));
+
+                if (header.magic == Slice_Table::MAGIC && sizeof(header) + header.name_length <= data.get_size ())
+                {
+                    texture_name.assign (reinterpret_cast< const char * >(data.get_data () + sizeof(header)), header.name_length);
+                }
+            }
+        }
+        else
+        if (ends_with (path, ".font"))
+        {
+            Font_Table::Header header;
+
+            if (data.get_size () >= sizeof(header))
+            {
+                std::memcpy (&header, data.get_data (), sizeof(header));
+
+                size_t name_offset = sizeof(header) + ((header.face_length + 3) & ~size_t(3));
+
+                if (header.magic == Font_Table::MAGIC && name_offset + header.texture_name_length <= data.get_size ())
+                {
+                    texture_name.assign (reinterpret_cast< const char * >(data.get_data () + name_offset), header.texture_name_length);
+                }
+            }
+        }
+        else
+        if (kind == Asset_Manifest::ATLAS)
+        {
+            find_attribute (data, "img", "name", texture_name);
+        }
+        else
+            find_attribute (data, "page", "file", texture_name);
+
+        if (!texture_name.empty ())
+        {
+            // La ruta de la textura es relativa al directorio de la tabla:
+
+            size_t separator    = path.find_last_of ("/\\");
+            string texture_path = separator == string::npos ? texture_name : path.substr (0, separator + 1) + texture_name;
+
+            if (request (texture_path, 0))
+            {
+                {
+                    std::lock_guard< std::mutex > lock(mutex);
+
+                    ++statistics.dependencies;
+                }
+
+                read_asset (texture_path);
+            }
+        }
+    }
+
+}
@@ -49,6 +49,7 @@
 
             Transformation2f transform;
             Transformation2f projection;
+            Transformation2f clip_transform;                ///< projection * transform (para el culling).
 
             std::shared_ptr< Shader_Program > shader_program_f;
             std::shared_ptr< Shader_Program > shader_program_t;
@@ -98,6 +99,10 @@
             void fill_rectangle  (const Point2f & where, const Size2f & size, const basics::Texture_2D * texture, int handling = CENTER) override;
             void fill_rectangle  (const Point2f & where, const Size2f & size, const Atlas::Slice * slice, int handling = CENTER) override;
 
+            using basics::Canvas::draw_text;
+
+            void draw_text       (const Point2f & where, const basics::Text_Prefab & text_prefab, int handling = TOP | LEFT) override;
+
         };
 
     }}
@@ -34,6 +34,8 @@
 
             static const Shader_Program * active_shader_program;
             static       unsigned         instance_count;
+            static       std::string      binary_cache_path;
+            static       bool             binary_cache_enabled;
 
         public:
 
@@ -47,6 +49,21 @@
                 glUseProgram (0);
             }
 
+            /**
+             * Establece el directorio en el que se guardan los binarios de los programas enlazados
+             * (extensión GL_OES_get_program_binary) para no tener que compilarlos en cada arranque ni
+             * tras cada pérdida del contexto. Si no se establece, se usa application.get_storage_path ().
+             */
+            static void set_binary_cache_path (const std::string & path)
+            {
+                binary_cache_path = path;
+            }
+
+            static void enable_binary_cache (bool enabled)
+            {
+                binary_cache_enabled = enabled;
+            }
+
         private:
 
             std::vector< Shader::Source_Code > source_code;
@@ -100,7 +117,10 @@
 
         private:
 
-            bool link ();
+            bool        link               ();
+            std::string get_binary_path    () const;
+            bool        load_binary        (const std::string & path);
+            void        save_binary        (const std::string & path);
 
         public:
 
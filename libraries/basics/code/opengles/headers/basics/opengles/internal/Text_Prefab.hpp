@@ -13,20 +13,85 @@
 #ifndef BASICS_OPENGLES_TEXT_PREFAB_HEADER
 #define BASICS_OPENGLES_TEXT_PREFAB_HEADER
 
-    #include <basics/Text_Layout>
+    #include <vector>
+    #include <basics/Text_Prefab>
+    #include <basics/opengles/OpenGL_ES2>
 
-    namespace basics
+    namespace basics { namespace opengles
     {
 
-        class Text_Prefab
+        /**
+         * Guarda los quads de todos los glifos en un vertex buffer object con las posiciones y las
+         * coordenadas de textura intercaladas, de modo que Canvas_ES2 pueda dibujar el texto con una
+         * sola llamada a glDrawArrays().
+         */
+        class Text_Prefab : public basics::Text_Prefab
         {
         public:
 
-            Text_Prefab() = default;
-            virtual ~Text_Prefab() = default;
+            static std::shared_ptr< basics::Text_Prefab > create (Id id, const Text_Layout & text_layout);
+
+        public:
+
+            static void enable ()
+            {
+                register_factory (ID(opengles2), basics::opengles::Text_Prefab::create);
+            }
+
+        public:
+
+            struct Vertex
+            {
+                float x, y;                                     ///< Posición relativa a la esquina superior izquierda.
+                float u, v;
+            };
+
+        private:
+
+            std::vector< Vertex > vertices;                     ///< Se conservan para poder regenerar el VBO si se pierde el contexto.
+            GLuint                vertex_buffer_id;
+
+        public:
+
+            Text_Prefab(const Text_Layout & text_layout);
+
+           ~Text_Prefab()
+            {
+                finalize ();
+            }
+
+        public:
+
+            bool initialize () override;
+            void finalize   () override;
+
+        public:
+
+            bool is_usable () const
+            {
+                return initialized && texture;
+            }
+
+            GLsizei get_vertex_count () const
+            {
+                return GLsizei(vertices.size ());
+            }
+
+            /**
+             * Enlaza el VBO. Los atributos se deben configurar con un stride de sizeof(Vertex).
+             */
+            void use () const
+            {
+                glBindBuffer (GL_ARRAY_BUFFER, vertex_buffer_id);
+            }
+
+            static void unuse ()
+            {
+                glBindBuffer (GL_ARRAY_BUFFER, 0);
+            }
 
         };
 
-    }
+    }}
 
 #endif
@@ -13,6 +13,7 @@
 #ifndef BASICS_OPENGLES_TEXTURE_2D_HEADER
 #define BASICS_OPENGLES_TEXTURE_2D_HEADER
 
+    #include <vector>
     #include <basics/Color_Buffer>
     #include <basics/Graphics_Resource>
     #include <basics/opengles/OpenGL_ES2>
@@ -26,15 +27,37 @@
 
             static const Texture_2D * active_texture;
 
+            /**
+             * Indica si el contexto admite mipmaps en texturas cuyo tamaño no es potencia de 2
+             * (GL_OES_texture_npot). Se consulta al inicializar la primera textura con mipmaps.
+             */
+            static int npot_mipmaps_supported;
+
+            static bool are_npot_mipmaps_supported ();
+
+            /**
+             * Formatos comprimidos que admite el contexto (GL_COMPRESSED_TEXTURE_FORMATS). Se
+             * consultan al crear la primera textura comprimida.
+             */
+            static std::vector< GLint > compressed_formats;
+            static bool                 compressed_formats_queried;
+
         public:
 
-            static std::shared_ptr< basics::Texture_2D > create (Id id, Color_Buffer< Rgba8888 > & color_buffer, const Options & options = {});
+            static std::shared_ptr< basics::Texture_2D > create           (Id id, Color_Buffer< Rgba8888 > & color_buffer, const Options & options = {});
+            static std::shared_ptr< basics::Texture_2D > create_from_data (Id id, Texture_Data & texture_data, const Options & options = {});
+
+            /**
+             * Indica si la GPU puede usar directamente texturas con el formato indicado.
+             */
+            static bool is_format_supported (Texture_Data::Format format);
 
         public:
 
             static void enable ()
             {
                 register_factory (ID(opengles2), basics::opengles::Texture_2D::create);
+                register_factory (ID(opengles2), basics::opengles::Texture_2D::create_from_data);
             }
 
             static void unuse ()
@@ -45,14 +68,31 @@
         private:
 
             Color_Buffer< Rgba8888 > color_buffer;
+            Texture_Data             texture_data;      ///< Datos comprimidos o de 16 bits (si la textura no se creó a partir de un Color_Buffer).
             GLuint texture_object_id;
+            bool   mipmaps;
+            bool   release_pixels;                      ///< Liberar color_buffer y texture_data tras subirlos.
+            size_t byte_size;                           ///< Memoria de vídeo ocupada tras la última subida.
 
         public:
 
-            Texture_2D(const Color_Buffer< Rgba8888 > & color_buffer, unsigned width, unsigned height)
+            Texture_2D(const Color_Buffer< Rgba8888 > & color_buffer, unsigned width, unsigned height, bool mipmaps = false, Pixel_Retention retention = KEEP_PIXELS)
             :
                 basics::Texture_2D(width, height),
-                color_buffer      (color_buffer )
+                color_buffer      (color_buffer ),
+                mipmaps           (mipmaps      ),
+                release_pixels    (retention == RELEASE_PIXELS),
+                byte_size         (0            )
+            {
+            }
+
+            Texture_2D(Texture_Data && texture_data, unsigned width, unsigned height, bool mipmaps = false, Pixel_Retention retention = KEEP_PIXELS)
+            :
+                basics::Texture_2D(width, height),
+                texture_data      (std::move (texture_data)),
+                mipmaps           (mipmaps || this->texture_data.levels.size () > 1),
+                release_pixels    (retention == RELEASE_PIXELS),
+                byte_size         (0)
             {
             }
 
@@ -73,10 +113,36 @@
             {
                 if (initialized)
                 {
+                    if (active_texture == this) active_texture = nullptr;
+
                     glDeleteTextures (1, &texture_object_id);
+
+                    initialized = false;
                 }
             }
 
+            size_t get_byte_size () const override
+            {
+                return byte_size;
+            }
+
+            /**
+             * La textura se puede expulsar de la memoria de vídeo si conserva una copia de sus
+             * píxeles o los puede volver a cargar.
+             */
+            bool is_evictable () const override
+            {
+                return color_buffer.size () > 0 || !texture_data.levels.empty () || can_reload ();
+            }
+
+            /**
+             * Retorna los bytes de memoria principal que ocupa la copia de los píxeles.
+             */
+            size_t get_pixel_copy_size () const
+            {
+                return color_buffer.size () * sizeof(Rgba8888) + texture_data.get_size () + source_blob.size ();
+            }
+
         public:
 
             bool is_usable () const
@@ -88,6 +154,15 @@
 
             bool use () const;
 
+            bool has_mipmaps () const
+            {
+                return mipmaps;
+            }
+
+        private:
+
+            bool reload_pixels ();
+
         };
 
     }}
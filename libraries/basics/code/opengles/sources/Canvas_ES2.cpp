@@ -10,10 +10,12 @@
  * C1801091703
  */
 
+#include <cstddef>
 #include <basics/Transformation>
 #include <basics/opengles/OpenGL_ES2>
 #include <basics/opengles/Canvas_ES2>
 #include <basics/opengles/Shader_Program>
+#include <basics/opengles/Text_Prefab>
 #include <basics/opengles/Texture_2D>
 
 // glTexCoordPointer (2, GL_FLOAT, 0, tex_coords);
@@ -170,6 +172,8 @@ namespace basics { namespace opengles
         half_size   = size * 0.5f;
         projection  = translate_then_scale_2d (Vector2f{ -half_size.width, -half_size.height }, 2.f / size.width, 2.f / size.height);
 
+        clip_transform = projection * transform;
+
         shader_program_f->use ();
         shader_program_f->set_uniform_value (projection_f_id, projection.matrix);
 
@@ -198,7 +202,8 @@ namespace basics { namespace opengles
 
     void Canvas_ES2::set_transform (const Transformation2f & new_transform)
     {
-        transform = new_transform;
+        transform      = new_transform;
+        clip_transform = projection * transform;
 
         shader_program_f->use ();
         shader_program_f->set_uniform_value (transform_f_id, transform.matrix);
@@ -209,7 +214,8 @@ namespace basics { namespace opengles
 
     void Canvas_ES2::apply_transform (const Transformation2f & t)
     {
-        transform = t * transform;
+        transform      = t * transform;
+        clip_transform = projection * transform;
 
         shader_program_f->use ();
         shader_program_f->set_uniform_value (transform_f_id, transform.matrix);
@@ -220,11 +226,18 @@ namespace basics { namespace opengles
 
     void Canvas_ES2::clear ()
     {
+        reset_statistics ();
+
         glClear (GL_COLOR_BUFFER_BIT);
     }
 
     void Canvas_ES2::draw_point (const Point2f & position)
     {
+        if (cull (clip_transform, &position, 1))
+        {
+            return;
+        }
+
         shader_program_f->use ();
 
         glEnableVertexAttribArray  (0);
@@ -235,10 +248,15 @@ namespace basics { namespace opengles
 
     void Canvas_ES2::draw_segment (const Point2f & a, const Point2f & b)
     {
-        shader_program_f->use ();
-
         const Point2f coordinates[] = { a, b };
 
+        if (cull (clip_transform, coordinates, 2))
+        {
+            return;
+        }
+
+        shader_program_f->use ();
+
         glEnableVertexAttribArray  (0);
         glDisableVertexAttribArray (1);
         glVertexAttribPointer      (0, 2, GL_FLOAT, GL_FALSE, 0, coordinates);
@@ -247,10 +265,15 @@ namespace basics { namespace opengles
 
     void Canvas_ES2::draw_triangle (const Point2f & a, const Point2f & b, const Point2f & c)
     {
-        shader_program_f->use ();
-
         const Point2f coordinates[] = { a, b, c, a };
 
+        if (cull (clip_transform, coordinates, 3))
+        {
+            return;
+        }
+
+        shader_program_f->use ();
+
         glEnableVertexAttribArray  (0);
         glDisableVertexAttribArray (1);
         glVertexAttribPointer      (0, 2, GL_FLOAT, GL_FALSE, 0, coordinates);
@@ -259,10 +282,15 @@ namespace basics { namespace opengles
 
     void Canvas_ES2::fill_triangle (const Point2f & a, const Point2f & b, const Point2f & c)
     {
-        shader_program_f->use ();
-
         const Point2f coordinates[] = { a, b, c };
 
+        if (cull (clip_transform, coordinates, 3))
+        {
+            return;
+        }
+
+        shader_program_f->use ();
+
         glEnableVertexAttribArray  (0);
         glDisableVertexAttribArray (1);
         glVertexAttribPointer      (0, 2, GL_FLOAT, GL_FALSE, 0, coordinates);
@@ -271,6 +299,11 @@ namespace basics { namespace opengles
 
     void Canvas_ES2::draw_rectangle (const Point2f & bottom_left, const Size2f & size)
     {
+        if (cull (clip_transform, bottom_left, size))
+        {
+            return;
+        }
+
         shader_program_f->use ();
 
         Point2f top_right{ bottom_left.coordinates.x () + size.width, bottom_left.coordinates.y () + size.height };
@@ -292,6 +325,11 @@ namespace basics { namespace opengles
 
     void Canvas_ES2::fill_rectangle (const Point2f & bottom_left, const Size2f & size)
     {
+        if (cull (clip_transform, bottom_left, size))
+        {
+            return;
+        }
+
         shader_program_f->use ();
 
         Point2f top_right{ bottom_left.coordinates.x () + size.width, bottom_left.coordinates.y () + size.height };
@@ -333,6 +371,13 @@ namespace basics { namespace opengles
                 case BOTTOM: bottom_left[1] = where[1];                  break;
             }
 
+            // Los sprites que quedan completamente fuera de la pantalla no llegan a la GPU:
+
+            if (cull (clip_transform, bottom_left, size))
+            {
+                return;
+            }
+
             switch (handling & 0xF0)
             {
                 case FLIP_HORIZONTAL:  texture_uvs = h_flip_texture_uvs; break;
@@ -408,6 +453,13 @@ namespace basics { namespace opengles
                 case BOTTOM: bottom_left[1] = where[1];                  break;
             }
 
+            // Los sprites que quedan completamente fuera de la pantalla no llegan a la GPU:
+
+            if (cull (clip_transform, bottom_left, size))
+            {
+                return;
+            }
+
             if (handling & FLIP_HORIZONTAL)
             {
                 std::swap (texture_uvs[0][0], texture_uvs[2][0]);
@@ -445,4 +497,47 @@ namespace basics { namespace opengles
         }
     }
 
+    void Canvas_ES2::draw_text (const Point2f & where, const basics::Text_Prefab & text_prefab, int handling)
+    {
+        const opengles::Text_Prefab * opengl_es_prefab  = dynamic_cast< const opengles::Text_Prefab * >(&text_prefab);
+        const opengles::Texture_2D  * opengl_es_texture = dynamic_cast< const opengles::Texture_2D  * >(text_prefab.get_texture ().get ());
+
+        if (!opengl_es_prefab || !opengl_es_prefab->is_usable () || !opengl_es_texture)
+        {
+            // Si el prefab no tiene VBO se dibuja glifo a glifo:
+
+            basics::Canvas::draw_text (where, text_prefab, handling);
+
+            return;
+        }
+
+        float   width    = text_prefab.get_width  ();
+        float   height   = text_prefab.get_height ();
+        Point2f top_left = get_text_top_left (where, width, height, handling);
+
+        if (cull (clip_transform, { top_left[0], top_left[1] - height }, { width, height }))
+        {
+            return;
+        }
+
+        // Los vértices del prefab son relativos a la esquina superior izquierda del texto:
+
+        Transformation2f text_transform = transform * scale_then_translate_2d (1.f, Vector2f{ top_left[0], top_left[1] });
+
+        opengl_es_texture->use ();
+        shader_program_t ->use ();
+        shader_program_t ->set_uniform_value (transform_t_id, text_transform.matrix);
+        opengl_es_prefab ->use ();
+
+        glEnableVertexAttribArray (  vertex_position_location_t);
+        glEnableVertexAttribArray (vertex_texture_uv_location_t);
+        glVertexAttribPointer     (  vertex_position_location_t, 2, GL_FLOAT, GL_FALSE, sizeof(Text_Prefab::Vertex), reinterpret_cast< const void * >(offsetof(Text_Prefab::Vertex, x)));
+        glVertexAttribPointer     (vertex_texture_uv_location_t, 2, GL_FLOAT, GL_FALSE, sizeof(Text_Prefab::Vertex), reinterpret_cast< const void * >(offsetof(Text_Prefab::Vertex, u)));
+        glDrawArrays              (GL_TRIANGLES, 0, opengl_es_prefab->get_vertex_count ());
+
+        opengles::Text_Prefab::unuse ();
+
+        shader_program_t ->set_uniform_value (transform_t_id, transform.matrix);
+    }
+
 }}
@@ -8,6 +8,15 @@
  * angel.rodriguez@esne.edu
  */
 
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <EGL/egl.h>
+#include <basics/Application>
+#include <basics/fnv>
+#include <basics/Log>
+#include <basics/Timer>
 #include <basics/opengles/Fragment_Shader>
 #include <basics/opengles/OpenGL_ES2>
 #include <basics/opengles/Shader_Program>
@@ -16,8 +25,56 @@
 namespace basics { namespace opengles
 {
 
+    namespace
+    {
+
+        PFNGLGETPROGRAMBINARYOESPROC gl_get_program_binary = nullptr;
+        PFNGLPROGRAMBINARYOESPROC    gl_program_binary     = nullptr;
+
+        /**
+         * Comprueba (una sola vez) si el driver permite leer y cargar binarios de programas.
+         */
+        bool program_binaries_supported ()
+        {
+            static int supported = -1;
+
+            if (supported < 0)
+            {
+                const char * extensions = reinterpret_cast< const char * >(glGetString (GL_EXTENSIONS));
+
+                supported = 0;
+
+                if (extensions && std::strstr (extensions, "GL_OES_get_program_binary"))
+                {
+                    GLint format_count = 0;
+
+                    glGetIntegerv (GL_NUM_PROGRAM_BINARY_FORMATS_OES, &format_count);
+
+                    gl_get_program_binary = reinterpret_cast< PFNGLGETPROGRAMBINARYOESPROC >(eglGetProcAddress ("glGetProgramBinaryOES"));
+                    gl_program_binary     = reinterpret_cast< PFNGLPROGRAMBINARYOESPROC    >(eglGetProcAddress ("glProgramBinaryOES"   ));
+
+                    supported = format_count > 0 && gl_get_program_binary && gl_program_binary ? 1 : 0;
+                }
+            }
+
+            return supported == 1;
+        }
+
+        std::string to_milliseconds (const Timer & timer)
+        {
+            char buffer[32];
+
+            std::snprintf (buffer, sizeof(buffer), "%.2f ms", timer.get_elapsed_seconds< double > () * 1000.0);
+
+            return buffer;
+        }
+
+    }
+
     const Shader_Program * Shader_Program::active_shader_program = nullptr;
     unsigned int           Shader_Program::instance_count        = 0;
+    std::string            Shader_Program::binary_cache_path;
+    bool                   Shader_Program::binary_cache_enabled  = true;
 
     bool Shader_Program::initialize ()
     {
@@ -25,10 +82,33 @@ namespace basics { namespace opengles
         {
             if (source_code.size () > 0)
             {
+                Timer timer;
+
                 program_object_id = glCreateProgram ();
 
                 assert(program_object_id != 0);
 
+                // Primero se intenta cargar un binario guardado en un arranque anterior:
+
+                std::string binary_path = get_binary_path ();
+
+                if (!binary_path.empty ())
+                {
+                    if (load_binary (binary_path))
+                    {
+                        basics::log.d ("shader program " + std::to_string (instance_id) + " loaded from binary cache in " + to_milliseconds (timer));
+
+                        return (initialized = true);
+                    }
+
+                    // Si el driver rechaza el binario (por ejemplo, tras una actualización) el
+                    // programa se vuelve a crear para compilarlo desde el código fuente:
+
+                    glDeleteProgram (program_object_id);
+
+                    program_object_id = glCreateProgram ();
+                }
+
                 std::vector< std::shared_ptr< Shader > > shaders(source_code.size ());
 
                 for (unsigned i = 0; i < source_code.size (); ++i)
@@ -47,11 +127,23 @@ namespace basics { namespace opengles
                     glAttachShader (program_object_id, *shaders[i]);
                 }
 
-                return (initialized = link ());         // EN CASO DE FALLO HAY QUE LIBERAR EL OBJETO SHADER PROGRAM (LOS SHADERS SE LIBERAN CON SHARED_PTR)
+                initialized = link ();                  // EN CASO DE FALLO HAY QUE LIBERAR EL OBJETO SHADER PROGRAM (LOS SHADERS SE LIBERAN CON SHARED_PTR)
+
+                if (initialized)
+                {
+                    basics::log.d ("shader program " + std::to_string (instance_id) + " compiled and linked in " + to_milliseconds (timer));
+
+                    if (!binary_path.empty ())
+                    {
+                        save_binary (binary_path);
+                    }
+                }
+
+                return initialized;
             }
         }
 
-        return (initialized = false);
+        return initialized;
     }
 
     bool Shader_Program::link ()
@@ -85,4 +177,111 @@ namespace basics { namespace opengles
         return succeeded != 0;
     }
 
+    std::string Shader_Program::get_binary_path () const
+    {
+        if (!binary_cache_enabled || !program_binaries_supported ())
+        {
+            return std::string();
+        }
+
+        std::string directory = binary_cache_path.empty () ? application.get_storage_path () : binary_cache_path;
+
+        if (directory.empty ())
+        {
+            return std::string();
+        }
+
+        // La clave depende del código fuente y del driver, ya que los binarios no son portables
+        // entre GPUs ni entre versiones del driver:
+
+        std::string key_source;
+
+        for (auto & code : source_code)
+        {
+            key_source += char('0' + code.get_type ());
+            key_source += static_cast< const std::string & >(code);
+        }
+
+        const char * renderer = reinterpret_cast< const char * >(glGetString (GL_RENDERER));
+        const char * version  = reinterpret_cast< const char * >(glGetString (GL_VERSION ));
+
+        if (renderer) key_source += renderer;
+        if (version ) key_source += version;
+
+        char file_name[40];
+
+        std::snprintf (file_name, sizeof(file_name), "/program-%016llx.bin", (unsigned long long)fnv64 (key_source));
+
+        return directory + file_name;
+    }
+
+    bool Shader_Program::load_binary (const std::string & path)
+    {
+        std::ifstream file(path, std::ios::binary);
+
+        uint32_t format = 0;
+
+        if (!file.read (reinterpret_cast< char * >(&format), sizeof(format)))
+        {
+            return false;
+        }
+
+        std::vector< char > binary((std::istreambuf_iterator< char >(file)), std::istreambuf_iterator< char >());
+
+        if (binary.empty ())
+        {
+            return false;
+        }
+
+        gl_program_binary (program_object_id, GLenum(format), binary.data (), GLint(binary.size ()));
+
+        GLint succeeded = 0;
+
+        glGetProgramiv (program_object_id, GL_LINK_STATUS, &succeeded);
+
+        if (!succeeded)
+        {
+            glGetError  ();                             // Se descarta el posible GL_INVALID_ENUM del formato
+            std::remove (path.c_str ());
+        }
+
+        return succeeded != 0;
+    }
+
+    void Shader_Program::save_binary (const std::string & path)
+    {
+        GLint length = 0;
+
+        glGetProgramiv (program_object_id, GL_PROGRAM_BINARY_LENGTH_OES, &length);
+
+        if (length > 0)
+        {
+            std::vector< char > binary(length);
+            GLenum              format  = 0;
+            GLsizei             written = 0;
+
+            gl_get_program_binary (program_object_id, length, &written, &format, binary.data ());
+
+            if (written > 0)
+            {
+                // Se escribe en un archivo temporal que después se renombra para que, si la
+                // aplicación termina a medias, no quede un binario truncado en la caché:
+
+                std::string   temporary_path = path + ".tmp";
+                std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+
+                uint32_t file_format = format;
+
+                file.write (reinterpret_cast< const char * >(&file_format), sizeof(file_format));
+                file.write (binary.data (), written);
+                file.close ();
+
+                if (!file || std::rename (temporary_path.c_str (), path.c_str ()) != 0)
+                {
+                    std::remove (temporary_path.c_str ());
+                }
+            }
+        }
+    }
+
 }}
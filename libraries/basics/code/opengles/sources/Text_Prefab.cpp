@@ -10,9 +10,89 @@
  * C1802030200
  */
 
+#include <basics/Atlas>
 #include <basics/opengles/Text_Prefab>
 
-namespace basics
+namespace basics { namespace opengles
 {
 
-}
+    std::shared_ptr< basics::Text_Prefab > Text_Prefab::create (Id id, const Text_Layout & text_layout)
+    {
+        return std::shared_ptr< Text_Prefab >(new Text_Prefab(text_layout));
+    }
+
+    Text_Prefab::Text_Prefab(const Text_Layout & text_layout)
+    :
+        basics::Text_Prefab(text_layout),
+        vertex_buffer_id   (0)
+    {
+        vertices.reserve (glyphs.size () * 6);
+
+        for (auto & glyph : glyphs)
+        {
+            const Atlas::Slice * slice = glyph.slice;
+
+            if (!slice || !slice->atlas || slice->atlas->get_texture () != texture)
+            {
+                continue;
+            }
+
+            // Se normalizan las coordenadas de textura una sola vez (Canvas_ES2 lo hace en cada
+            // llamada a fill_rectangle()):
+
+            float horizontal_ratio  = 1.f / texture->get_width  ();
+            float   vertical_ratio  = 1.f / texture->get_height ();
+            float normalized_left   = slice->left   * horizontal_ratio;
+            float normalized_right  = slice->right  * horizontal_ratio;
+            float normalized_top    = slice->top    *   vertical_ratio;
+            float normalized_bottom = slice->bottom *   vertical_ratio;
+
+            float left   = glyph.position[0];
+            float top    = glyph.position[1];
+            float right  = left + glyph.size.width;
+            float bottom = top  - glyph.size.height;
+
+            // Los campos top y bottom de los slices siguen el orden de las filas de la imagen (igual
+            // que en Canvas_ES2), por lo que el borde inferior del quad usa normalized_top:
+
+            const Vertex quad[] =
+            {
+                { left,  bottom, normalized_left,  normalized_top    },
+                { left,  top,    normalized_left,  normalized_bottom },
+                { right, bottom, normalized_right, normalized_top    },
+                { right, bottom, normalized_right, normalized_top    },
+                { left,  top,    normalized_left,  normalized_bottom },
+                { right, top,    normalized_right, normalized_bottom },
+            };
+
+            vertices.insert (vertices.end (), quad, quad + 6);
+        }
+    }
+
+    bool Text_Prefab::initialize ()
+    {
+        if (!initialized && !vertices.empty ())
+        {
+            glGenBuffers (1, &vertex_buffer_id);
+            glBindBuffer (GL_ARRAY_BUFFER, vertex_buffer_id);
+            glBufferData (GL_ARRAY_BUFFER, GLsizeiptr(vertices.size () * sizeof(Vertex)), vertices.data (), GL_STATIC_DRAW);
+            glBindBuffer (GL_ARRAY_BUFFER, 0);
+
+            initialized = glGetError () == GL_NO_ERROR;
+        }
+
+        return initialized;
+    }
+
+    void Text_Prefab::finalize ()
+    {
+        if (initialized)
+        {
+            glDeleteBuffers (1, &vertex_buffer_id);
+
+            vertex_buffer_id = 0;
+            initialized      = false;
+        }
+    }
+
+}}
@@ -10,30 +10,305 @@
  * C1801221334
  */
 
+#include <algorithm>
+#include <cstring>
 #include <basics/assert>
+#include <basics/convert_color>
+#include <basics/etc_decode>
+#include <basics/Log>
 #include <basics/opengles/Texture_2D>
+#include <basics/resample>
 
 namespace basics { namespace opengles
 {
 
-    const Texture_2D * Texture_2D::active_texture = nullptr;
+    const Texture_2D *   Texture_2D::active_texture             = nullptr;
+    int                  Texture_2D::npot_mipmaps_supported     = -1;
+    std::vector< GLint > Texture_2D::compressed_formats;
+    bool                 Texture_2D::compressed_formats_queried = false;
+
+    namespace
+    {
+
+        // Los identificadores de los formatos ETC2 forman parte de OpenGL ES 3.0, por lo que no
+        // aparecen en los headers de OpenGL ES 2.0:
+
+        const GLenum gl_formats[] =
+        {
+            GL_RGBA,                                    // Texture_Data::RGBA8888
+            GL_RGB,                                     // Texture_Data::RGB565
+            GL_RGBA,                                    // Texture_Data::RGBA4444
+            GL_RGBA,                                    // Texture_Data::RGBA5551
+            0x8D64,                                     // Texture_Data::ETC1_RGB8   (GL_ETC1_RGB8_OES)
+            0x9274,                                     // Texture_Data::ETC2_RGB8   (GL_COMPRESSED_RGB8_ETC2)
+            0x9276,                                     // Texture_Data::ETC2_RGB8A1 (GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2)
+            0x9278,                                     // Texture_Data::ETC2_RGBA8  (GL_COMPRESSED_RGBA8_ETC2_EAC)
+        };
+
+        const GLenum gl_types[] =
+        {
+            GL_UNSIGNED_BYTE,                           // Texture_Data::RGBA8888
+            GL_UNSIGNED_SHORT_5_6_5,                    // Texture_Data::RGB565
+            GL_UNSIGNED_SHORT_4_4_4_4,                  // Texture_Data::RGBA4444
+            GL_UNSIGNED_SHORT_5_5_5_1,                  // Texture_Data::RGBA5551
+        };
+
+        inline bool is_power_of_two (unsigned value)
+        {
+            return value > 0 && (value & (value - 1)) == 0;
+        }
+
+        inline unsigned floor_power_of_two (unsigned value)
+        {
+            unsigned power = 1;
+
+            while (power * 2 <= value) power *= 2;
+
+            return power;
+        }
+
+        template< class FORMAT >
+        bool downscale_packed (Texture_Data::Level & level, unsigned width, unsigned height)
+        {
+            Color_Buffer< uint16_t > packed(level.width, level.height);
+            Color_Buffer< Rgba8888 > expanded;
+            Color_Buffer< Rgba8888 > reduced;
+
+            std::memcpy (packed.buffer.data (), level.data.data (), packed.size () * sizeof(uint16_t));
+
+            convert< FORMAT > (packed, expanded);
+
+            if (!downscale (expanded, reduced, width, height))
+            {
+                return false;
+            }
+
+            // Se vuelve al mismo formato para no cambiar la forma en que se trata el alfa:
+
+            convert< FORMAT > (reduced, packed, Dithering::ORDERED);
+
+            const byte * bytes = reinterpret_cast< const byte * >(packed.buffer.data ());
+
+            level = Texture_Data::Level{ width, height, std::vector< byte >(bytes, bytes + packed.size () * sizeof(uint16_t)) };
+
+            return true;
+        }
+
+        /**
+         * Reduce la imagen de 16 bits de un solo nivel a la potencia de 2 inferior.
+         */
+        bool reduce_to_power_of_two (Texture_Data & texture_data)
+        {
+            Texture_Data::Level & level  = texture_data.levels.front ();
+            unsigned              width  = floor_power_of_two (level.width );
+            unsigned              height = floor_power_of_two (level.height);
+
+            switch (texture_data.format)
+            {
+                case Texture_Data::RGB565:   return downscale_packed< Rgb565_Format   > (level, width, height);
+                case Texture_Data::RGBA4444: return downscale_packed< Rgba4444_Format > (level, width, height);
+                case Texture_Data::RGBA5551: return downscale_packed< Rgba5551_Format > (level, width, height);
+                default:                     return false;
+            }
+        }
+
+    }
 
     std::shared_ptr< basics::Texture_2D > Texture_2D::create (Id id, Color_Buffer< Rgba8888 > & color_buffer, const Options & options)
     {
-        return std::shared_ptr< Texture_2D >(new Texture_2D(color_buffer, options.width, options.height));
+        return std::shared_ptr< Texture_2D >(new Texture_2D(color_buffer, options.width, options.height, options.mipmaps, options.pixel_retention));
+    }
+
+    std::shared_ptr< basics::Texture_2D > Texture_2D::create_from_data (Id id, Texture_Data & texture_data, const Options & options)
+    {
+        // Los formatos de 16 bits forman parte de OpenGL ES 2.0. Los datos en Rgba8888 o en formatos
+        // comprimidos que la GPU no admite se dejan a Texture_2D::create(), que los convierte en un
+        // Color_Buffer:
+
+        if (!texture_data.is_16_bit () && !(texture_data.is_compressed () && is_format_supported (texture_data.format)))
+        {
+            return std::shared_ptr< basics::Texture_2D >();
+        }
+
+        return std::shared_ptr< Texture_2D >(new Texture_2D(std::move (texture_data), options.width, options.height, options.mipmaps, options.pixel_retention));
+    }
+
+    bool Texture_2D::is_format_supported (Texture_Data::Format format)
+    {
+        if (!compressed_formats_queried)
+        {
+            GLint count = 0;
+
+            glGetIntegerv (GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count);
+
+            compressed_formats.resize (size_t(count > 0 ? count : 0));
+
+            if (count > 0)
+            {
+                glGetIntegerv (GL_COMPRESSED_TEXTURE_FORMATS, compressed_formats.data ());
+            }
+
+            // Algunos drivers no enumeran ETC1 aunque anuncian la extensión:
+
+            const char * extensions = reinterpret_cast< const char * >(glGetString (GL_EXTENSIONS));
+
+            if (extensions && std::strstr (extensions, "GL_OES_compressed_ETC1_RGB8_texture"))
+            {
+                compressed_formats.push_back (GLint(gl_formats[Texture_Data::ETC1_RGB8]));
+            }
+
+            compressed_formats_queried = true;
+        }
+
+        return std::find (compressed_formats.begin (), compressed_formats.end (), GLint(gl_formats[format])) != compressed_formats.end ();
+    }
+
+    bool Texture_2D::are_npot_mipmaps_supported ()
+    {
+        if (npot_mipmaps_supported < 0)
+        {
+            const char * extensions = reinterpret_cast< const char * >(glGetString (GL_EXTENSIONS));
+
+            npot_mipmaps_supported = extensions && std::strstr (extensions, "GL_OES_texture_npot") ? 1 : 0;
+        }
+
+        return npot_mipmaps_supported != 0;
     }
 
     bool Texture_2D::initialize ()
     {
+        // Si se liberaron los píxeles tras la subida anterior (por ejemplo, antes de perder el
+        // contexto) se vuelven a obtener:
+
+        if (!initialized && color_buffer.size () == 0 && texture_data.levels.empty () && !reload_pixels ())
+        {
+            return false;
+        }
+
+        if (!initialized && !texture_data.levels.empty ())
+        {
+            const Texture_Data::Level & base = texture_data.levels.front ();
+
+            // Los mipmaps que no vienen en los datos se generan en la GPU, lo que no es posible con
+            // los formatos comprimidos. Sin GL_OES_texture_npot las imágenes cuyo tamaño no es
+            // potencia de 2 se reducen a la potencia de 2 inferior, como las de 32 bits:
+
+            bool generate_mipmaps = mipmaps && texture_data.levels.size () == 1;
+
+            if (generate_mipmaps && (texture_data.is_compressed () || !is_power_of_two (base.width) || !is_power_of_two (base.height)))
+            {
+                if (texture_data.is_compressed ())
+                {
+                    generate_mipmaps = mipmaps = false;
+                }
+                else
+                if (!are_npot_mipmaps_supported () && !reduce_to_power_of_two (texture_data))
+                {
+                    basics::log.w ("Texture_2D: NPOT texture without GL_OES_texture_npot, mipmaps disabled.");
+
+                    generate_mipmaps = mipmaps = false;
+                }
+            }
+
+            glGenTextures   (1, &texture_object_id);
+            glBindTexture   (GL_TEXTURE_2D, texture_object_id);
+
+            glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+            glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+            // Las filas de 16 bits de ancho impar no están alineadas a 4 bytes:
+
+            glPixelStorei   (GL_UNPACK_ALIGNMENT, 1);
+
+            for (size_t level = 0; level < texture_data.levels.size (); ++level)
+            {
+                const Texture_Data::Level & data = texture_data.levels[level];
+
+                if (texture_data.is_compressed ())
+                {
+                    glCompressedTexImage2D
+                    (
+                        GL_TEXTURE_2D,
+                        GLint(level),
+                        gl_formats[texture_data.format],
+                        GLsizei(data.width ),
+                        GLsizei(data.height),
+                        0,
+                        GLsizei(Texture_Data::get_level_size (texture_data.format, data.width, data.height)),
+                        data.data.data ()
+                    );
+                }
+                else
+                {
+                    glTexImage2D
+                    (
+                        GL_TEXTURE_2D,
+                        GLint(level),
+                        gl_formats[texture_data.format],
+                        GLsizei(data.width ),
+                        GLsizei(data.height),
+                        0,
+                        gl_formats[texture_data.format],
+                        gl_types  [texture_data.format],
+                        data.data.data ()
+                    );
+                }
+            }
+
+            glPixelStorei   (GL_UNPACK_ALIGNMENT, 4);
+
+            byte_size = texture_data.get_size ();
+
+            if (generate_mipmaps)
+            {
+                glGenerateMipmap (GL_TEXTURE_2D);
+
+                byte_size += byte_size / 3;
+            }
+
+            assert(glGetError () == GL_NO_ERROR);
+            assert(width > 0 && height > 0);
+
+            initialized = true;
+        }
+
         if (!initialized)
         {
             if (color_buffer.size () > 0)
             {
+                if (mipmaps)
+                {
+                    // OpenGL ES 2 solo admite mipmaps de texturas NPOT con GL_OES_texture_npot. Sin esa
+                    // extensión la imagen se reduce a la potencia de 2 inferior (el tamaño lógico de
+                    // la textura no cambia, por lo que las coordenadas de textura siguen valiendo):
+
+                    unsigned buffer_width  = color_buffer.get_width  ();
+                    unsigned buffer_height = color_buffer.get_height ();
+
+                    if (!are_npot_mipmaps_supported () && (!is_power_of_two (buffer_width) || !is_power_of_two (buffer_height)))
+                    {
+                        Color_Buffer< Rgba8888 > reduced;
+
+                        if (downscale (color_buffer, reduced, floor_power_of_two (buffer_width), floor_power_of_two (buffer_height)))
+                        {
+                            color_buffer = std::move (reduced);
+                        }
+                        else
+                        {
+                            basics::log.w ("Texture_2D: NPOT texture without GL_OES_texture_npot, mipmaps disabled.");
+
+                            mipmaps = false;
+                        }
+                    }
+                }
+
                 glEnable        (GL_TEXTURE_2D);////
                 glGenTextures   (1, &texture_object_id);
                 glBindTexture   (GL_TEXTURE_2D, texture_object_id);
 
-                glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
                 glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
                 glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
                 glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -51,6 +326,15 @@ namespace basics { namespace opengles
                     color_buffer
                 );
 
+                byte_size = color_buffer.size () * sizeof(Rgba8888);
+
+                if (mipmaps)
+                {
+                    glGenerateMipmap (GL_TEXTURE_2D);
+
+                    byte_size += byte_size / 3;
+                }
+
                 int error = glGetError ();
 
                 assert(glGetError () == GL_NO_ERROR);
@@ -60,11 +344,44 @@ namespace basics { namespace opengles
             }
         }
 
+        if (initialized && release_pixels && prepare_release (color_buffer))
+        {
+            color_buffer = Color_Buffer< Rgba8888 >();
+            texture_data = Texture_Data();
+        }
+
         return initialized;
     }
 
+    bool Texture_2D::reload_pixels ()
+    {
+        if (!reload (color_buffer, texture_data))
+        {
+            basics::log.w ("Texture_2D: the pixels released after the upload could not be reloaded.");
+
+            return false;
+        }
+
+        // Si la GPU no admite el formato de un KTX, la textura se creó con los píxeles descomprimidos:
+
+        if (texture_data.is_compressed () && !is_format_supported (texture_data.format))
+        {
+            bool decoded = etc_decode (texture_data, 0, color_buffer);
+
+            texture_data = Texture_Data();
+
+            return decoded;
+        }
+
+        return true;
+    }
+
     bool Texture_2D::use () const
     {
+        // Si la textura fue expulsada por el presupuesto de la caché se vuelve a subir:
+
+        if (!make_resident ()) return false;
+
         assert(is_usable ());
 
         //if (active_texture != this)
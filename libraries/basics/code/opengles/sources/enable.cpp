@@ -13,6 +13,7 @@
 #include <basics/enable>
 #include <basics/opengles/Canvas_ES2>
 #include <basics/opengles/OpenGL_ES2>
+#include <basics/opengles/Text_Prefab>
 #include <basics/opengles/Texture_2D>
 
 namespace basics
@@ -23,6 +24,7 @@ namespace basics
     {
         opengles::Canvas_ES2::enable ();
         opengles::Texture_2D::enable ();
+        opengles::Text_Prefab::enable ();
 
         return true;
     }
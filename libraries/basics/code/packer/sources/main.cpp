@@ -0,0 +1,259 @@
+/*
+ * PACKER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803251030
+ */
+
+// Empaqueta un árbol de assets en un archivo de Asset_Archive. Se ejecuta en máquinas little endian
+// (como los dispositivos), por lo que las estructuras del formato se escriben tal cual.
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <basics/Asset_Archive>
+#include <basics/lz4>
+
+using namespace basics;
+
+namespace
+{
+
+    struct Packed_Asset
+    {
+        std::string         path;
+        std::vector< byte > data;                       ///< Contenido tal y como se guarda.
+        Asset_Archive::Entry entry;
+    };
+
+    void print_usage ()
+    {
+        std::cout <<
+            "usage: basics-packer [options] <input directory> <output file>\n"
+            "\n"
+            "  --compress          compress the assets with LZ4 when it saves enough space\n"
+            "  --min-saving <n>    minimum saving (percent) to keep an asset compressed (default: 10)\n";
+    }
+
+    void scan (const std::string & root, const std::string & relative_path, std::vector< std::string > & paths)
+    {
+        std::string path = relative_path.empty () ? root : root + '/' + relative_path;
+        struct stat status;
+
+        if (stat (path.c_str (), &status) != 0) return;
+
+        if (S_ISDIR(status.st_mode))
+        {
+            if (DIR * directory = opendir (path.c_str ()))
+            {
+                while (dirent * entry = readdir (directory))
+                {
+                    if (entry->d_name[0] != '.')
+                    {
+                        scan (root, relative_path.empty () ? entry->d_name : relative_path + '/' + entry->d_name, paths);
+                    }
+                }
+
+                closedir (directory);
+            }
+        }
+        else
+        if (S_ISREG(status.st_mode))
+        {
+            paths.push_back (relative_path);
+        }
+    }
+
+    bool read_file (const std::string & path, std::vector< byte > & data)
+    {
+        std::ifstream file(path, std::ios::binary);
+
+        if (file)
+        {
+            data.assign (std::istreambuf_iterator< char >(file), std::istreambuf_iterator< char >());
+
+            return !file.bad ();
+        }
+
+        return false;
+    }
+
+    void write_padding (std::ofstream & file, uint64_t & offset)
+    {
+        static const char zeros[Asset_Archive::alignment] = { };
+
+        size_t padding = size_t((Asset_Archive::alignment - offset % Asset_Archive::alignment) % Asset_Archive::alignment);
+
+        file.write (zeros, std::streamsize(padding));
+
+        offset += padding;
+    }
+
+}
+
+int main (int argc, char * argv[])
+{
+    std::string input_path;
+    std::string output_path;
+    bool        compress   = false;
+    unsigned    min_saving = 10;
+
+    for (int index = 1; index < argc; ++index)
+    {
+        const char * argument = argv[index];
+
+        if (!std::strcmp (argument, "--compress"  )) compress = true; else
+        if (!std::strcmp (argument, "--min-saving") && index + 1 < argc) min_saving = unsigned(std::atoi (argv[++index])); else
+        if (argument[0] == '-') { print_usage (); return EXIT_FAILURE; } else
+        if (input_path .empty ()) input_path  = argument; else
+        if (output_path.empty ()) output_path = argument; else
+        {
+            print_usage ();
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (input_path.empty () || output_path.empty () || min_saving > 100)
+    {
+        print_usage ();
+        return EXIT_FAILURE;
+    }
+
+    std::vector< std::string > paths;
+
+    scan (input_path, std::string(), paths);
+
+    // Se leen (y comprimen) todos los assets antes de escribir para conocer el tamaño del índice:
+
+    std::vector< Packed_Asset > assets(paths.size ());
+    uint64_t                    original_size = 0;
+    uint64_t                    stored_size   = 0;
+
+    for (size_t index = 0; index < paths.size (); ++index)
+    {
+        Packed_Asset & asset = assets[index];
+
+        asset.path = paths[index];
+
+        if (!read_file (input_path + '/' + asset.path, asset.data))
+        {
+            std::cerr << "error: can't read " << asset.path << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        std::memset (&asset.entry, 0, sizeof(asset.entry));
+
+        asset.entry.hash        = Asset_Archive::hash (asset.path);
+        asset.entry.name_length = uint32_t(asset.path.size ());
+        asset.entry.compression = Asset_Archive::UNCOMPRESSED;
+        asset.entry.size        = asset.data.size ();
+
+        if (compress && !asset.data.empty ())
+        {
+            std::vector< byte > compressed_data;
+
+            lz4_compress (asset.data.data (), asset.data.size (), compressed_data);
+
+            if (compressed_data.size () * 100 <= asset.data.size () * (100 - min_saving))
+            {
+                asset.data.swap (compressed_data);
+                asset.entry.compression = Asset_Archive::LZ4;
+            }
+        }
+
+        asset.entry.stored_size = asset.data.size ();
+
+        original_size += asset.entry.size;
+        stored_size   += asset.entry.stored_size;
+    }
+
+    // El índice se ordena por hash (y por ruta cuando dos rutas tienen el mismo hash):
+
+    std::sort
+    (
+        assets.begin (), assets.end (),
+        [] (const Packed_Asset & a, const Packed_Asset & b)
+        {
+            return a.entry.hash != b.entry.hash ? a.entry.hash < b.entry.hash : a.path < b.path;
+        }
+    );
+
+    std::ofstream file(output_path, std::ios::binary | std::ios::trunc);
+
+    if (!file)
+    {
+        std::cerr << "error: can't create " << output_path << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Asset_Archive::Header header;
+
+    std::memset (&header, 0, sizeof(header));
+    std::memcpy (header.magic, "BASICSPK", 8);
+
+    header.version     = Asset_Archive::version;
+    header.entry_count = uint32_t(assets.size ());
+
+    file.write (reinterpret_cast< const char * >(&header), sizeof(header));
+
+    uint64_t offset = sizeof(header);
+
+    for (auto & asset : assets)
+    {
+        write_padding (file, offset);
+
+        asset.entry.offset = offset;
+
+        file.write (reinterpret_cast< const char * >(asset.data.data ()), std::streamsize(asset.data.size ()));
+
+        offset += asset.data.size ();
+    }
+
+    write_padding (file, offset);
+
+    header.index_offset = offset;
+    header.names_offset = offset + assets.size () * sizeof(Asset_Archive::Entry);
+
+    uint32_t name_offset = 0;
+
+    for (auto & asset : assets)
+    {
+        asset.entry.name_offset = name_offset;
+
+        file.write (reinterpret_cast< const char * >(&asset.entry), sizeof(asset.entry));
+
+        name_offset += asset.entry.name_length;
+    }
+
+    for (auto & asset : assets)
+    {
+        file.write (asset.path.data (), std::streamsize(asset.path.size ()));
+    }
+
+    // Por último se completa la cabecera con la posición del índice:
+
+    file.seekp (0);
+    file.write (reinterpret_cast< const char * >(&header), sizeof(header));
+
+    if (!file.flush ())
+    {
+        std::cerr << "error: can't write " << output_path << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << assets.size () << " assets, " << original_size / 1024 << " KiB -> " << stored_size / 1024 << " KiB stored" << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -18,8 +18,48 @@
     namespace basics
     {
 
+        /**
+         * Opciones de la decodificación directa. Por defecto se usa el descompresor propio, que
+         * entrega las filas a medida que se descomprimen, y se comprueba la suma Adler-32.
+         */
+        struct Png_Decode_Options
+        {
+            bool fast_inflate;                          ///< false para descomprimir con lodepng.
+            bool verify_checksum;                       ///< false para omitir la comprobación de la suma Adler-32.
+
+            Png_Decode_Options() : fast_inflate(true), verify_checksum(true)
+            {
+            }
+        };
+
         bool png_decode (const std::vector< byte > & encoded_data, Color_Buffer< Rgba8888 > & color_buffer, unsigned & width, unsigned & height);
 
+        /**
+         * Igual que la versión anterior pero a partir de datos que no están en un vector (por
+         * ejemplo, los de un Asset::Mapping).
+         */
+        bool png_decode (const byte * encoded_data, size_t size, Color_Buffer< Rgba8888 > & color_buffer, unsigned & width, unsigned & height);
+
+        /**
+         * Lee el tamaño de una imagen PNG sin decodificarla.
+         */
+        bool png_read_size (const byte * encoded_data, size_t size, unsigned & width, unsigned & height);
+
+        /**
+         * Lee el tamaño lógico que guarda png_encode() en el chunk privado bsSz cuando la imagen
+         * se ha reducido (por ejemplo, en basics-cooker).
+         * @return false si la imagen no tiene ese chunk.
+         */
+        bool png_read_logical_size (const byte * encoded_data, size_t size, unsigned & width, unsigned & height);
+
+        /**
+         * Decodifica una imagen PNG directamente en memoria del llamador (por ejemplo, un buffer de
+         * la GPU mapeado) sin copias intermedias de la imagen.
+         * @param pixels Memoria con espacio para el alto de la imagen en filas de pitch bytes.
+         * @param pitch Bytes por fila (al menos el ancho de la imagen multiplicado por 4).
+         */
+        bool png_decode (const byte * encoded_data, size_t size, Rgba8888 * pixels, size_t pitch, const Png_Decode_Options & options = Png_Decode_Options());
+
     }
 
 #endif
@@ -0,0 +1,32 @@
+/*
+ * PNG ENCODE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803101330
+ */
+
+#ifndef BASICS_PNG_ENCODE_HEADER
+#define BASICS_PNG_ENCODE_HEADER
+
+    #include <basics/Color_Buffer>
+
+    namespace basics
+    {
+
+        bool png_encode (const Color_Buffer< Rgba8888 > & color_buffer, std::vector< byte > & encoded_data);
+
+        /**
+         * Igual que la versión anterior pero guarda además en un chunk privado (bsSz) el tamaño
+         * lógico de la imagen, que png_read_logical_size() recupera. Sirve para que una imagen
+         * reducida se siga dibujando con el tamaño de la original.
+         */
+        bool png_encode (const Color_Buffer< Rgba8888 > & color_buffer, std::vector< byte > & encoded_data, unsigned logical_width, unsigned logical_height);
+
+    }
+
+#endif
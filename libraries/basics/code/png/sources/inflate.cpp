@@ -0,0 +1,575 @@
+/*
+ * INFLATE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803221000
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <basics/macros>
+#include "inflate.hpp"
+
+namespace basics { namespace png
+{
+
+    namespace
+    {
+
+        const unsigned FAST_BITS    = 10;
+        const unsigned FAST_SIZE    = 1u << FAST_BITS;
+        const unsigned FAST_MASK    = FAST_SIZE - 1;
+
+        const size_t   HISTORY_SIZE = 32768;                    ///< Distancia máxima de las referencias de DEFLATE.
+        const size_t   WINDOW_SIZE  = HISTORY_SIZE * 2;
+        const size_t   MARGIN       = 258 + 8;                  ///< Copia más larga más el exceso de las copias de 8 en 8 bytes.
+
+        const uint16_t length_base    [29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+        const uint8_t  length_extra   [29] = { 0, 0, 0, 0, 0, 0, 0,  0,  1,  1,  1,  1,  2,  2,  2,  2,  3,  3,  3,  3,  4,  4,  4,   4,   5,   5,   5,   5,   0 };
+        const uint16_t distance_base  [30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+        const uint8_t  distance_extra [30] = { 0, 0, 0, 0, 1, 1, 2,  2,  3,  3,  4,  4,  5,  5,   6,   6,   7,   7,   8,   8,    9,    9,   10,   10,   11,   11,   12,    12,    13,    13 };
+        const uint8_t  code_length_order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+        /**
+         * Tabla de decodificación de un código de Huffman. Los códigos de hasta FAST_BITS bits se
+         * resuelven con una sola consulta a la tabla fast y el resto recorriendo los códigos
+         * canónicos por longitud. Cada entrada de fast contiene:
+         *   bits 0-3:   bits que ocupa(n) el (los) símbolo(s)
+         *   bits 4-5:   número de símbolos (0 si el código es más largo que FAST_BITS)
+         *   bits 8-16:  primer símbolo
+         *   bits 17-24: segundo símbolo (un literal que cabe en los bits restantes)
+         */
+        struct Huffman
+        {
+            uint32_t fast        [FAST_SIZE];
+            uint32_t max_code    [17];
+            uint16_t first_code  [16];
+            uint16_t first_symbol[16];
+            uint16_t symbols     [288];
+            uint8_t  sizes       [288];
+        };
+
+        inline unsigned reverse_bits (unsigned code, unsigned length)
+        {
+            unsigned result = 0;
+
+            for (unsigned i = 0; i < length; ++i, code >>= 1) result = (result << 1) | (code & 1);
+
+            return result;
+        }
+
+        bool build (Huffman & huffman, const uint8_t * lengths, unsigned count, bool pair_literals)
+        {
+            unsigned sizes[17] = { };
+
+            for (unsigned i = 0; i < count; ++i) sizes[lengths[i]]++;
+
+            sizes[0] = 0;
+
+            unsigned next_code[16];
+            unsigned code   = 0;
+            unsigned symbol = 0;
+
+            for (unsigned length = 1; length < 16; ++length)
+            {
+                if (sizes[length] > (1u << length)) return false;
+
+                next_code              [length] = code;
+                huffman.first_code     [length] = uint16_t(code);
+                huffman.first_symbol   [length] = uint16_t(symbol);
+
+                code   += sizes[length];
+                symbol += sizes[length];
+
+                if (sizes[length] && code - 1 >= (1u << length)) return false;
+
+                huffman.max_code[length] = code << (16 - length);
+
+                code <<= 1;
+            }
+
+            huffman.max_code[16] = 0x10000;
+
+            std::memset (huffman.fast, 0, sizeof(huffman.fast));
+
+            for (unsigned i = 0; i < count; ++i)
+            {
+                unsigned length = lengths[i];
+
+                if (length == 0) continue;
+
+                unsigned index = next_code[length] - huffman.first_code[length] + huffman.first_symbol[length];
+
+                huffman.symbols[index] = uint16_t(i);
+                huffman.sizes  [index] = uint8_t (length);
+
+                if (length <= FAST_BITS)
+                {
+                    for (unsigned j = reverse_bits (next_code[length], length); j < FAST_SIZE; j += 1u << length)
+                    {
+                        huffman.fast[j] = length | 1u << 4 | i << 8;
+                    }
+                }
+
+                next_code[length]++;
+            }
+
+            // Si tras un literal quedan bits suficientes para el siguiente símbolo y también es un
+            // literal, la entrada contiene ambos y se decodifican con una sola consulta:
+
+            if (pair_literals)
+            {
+                std::vector< uint32_t > single(huffman.fast, huffman.fast + FAST_SIZE);
+
+                for (unsigned j = 0; j < FAST_SIZE; ++j)
+                {
+                    uint32_t first = single[j];
+
+                    if (!first || (first >> 8) >= 256) continue;
+
+                    unsigned first_length = first & 15;
+                    uint32_t second       = single[j >> first_length];
+                    unsigned second_bits  = second & 15;
+
+                    if (second && (second >> 8) < 256 && first_length + second_bits <= FAST_BITS)
+                    {
+                        huffman.fast[j] = (first_length + second_bits) | 2u << 4 | (first & 0x1FF00) | (second >> 8) << 17;
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        struct Fixed_Tables
+        {
+            Huffman literal_length;
+            Huffman distance;
+
+            Fixed_Tables()
+            {
+                uint8_t lengths[288];
+
+                std::fill (lengths,       lengths + 144, 8);
+                std::fill (lengths + 144, lengths + 256, 9);
+                std::fill (lengths + 256, lengths + 280, 7);
+                std::fill (lengths + 280, lengths + 288, 8);
+
+                build (literal_length, lengths, 288, true);
+
+                std::fill (lengths, lengths + 32, 5);
+
+                build (distance, lengths, 32, false);
+            }
+        };
+
+        class Inflater
+        {
+
+            const byte   * input;
+            const byte   * input_end;
+            uint64_t       bits;
+            unsigned       bit_count;
+            unsigned       overrun;                         ///< Bytes a cero añadidos al agotar la entrada.
+
+            std::vector< byte > window;
+            byte         * out;
+            byte         * flushed;                         ///< Primer byte que no se ha entregado al sink.
+            byte         * limit;
+            Inflate_Sink & sink;
+
+        public:
+
+            Inflater(const byte * data, size_t size, Inflate_Sink & sink)
+            :
+                input    (data),
+                input_end(data + size),
+                bits     (0),
+                bit_count(0),
+                overrun  (0),
+                window   (WINDOW_SIZE + MARGIN),
+                sink     (sink)
+            {
+                out     = window.data ();
+                flushed = out;
+                limit   = out + WINDOW_SIZE;
+            }
+
+            bool run ()
+            {
+                static const Fixed_Tables fixed_tables;
+
+                Huffman  literal_length, distance;
+                unsigned final_block;
+
+                do
+                {
+                    refill ();
+
+                    final_block   = get (1);
+                    unsigned type = get (2);
+
+                    bool success = false;
+
+                    switch (type)
+                    {
+                        case 0: success = copy_stored_block (); break;
+                        case 1: success = inflate_block (fixed_tables.literal_length, fixed_tables.distance); break;
+                        case 2: success = read_tables (literal_length, distance) && inflate_block (literal_length, distance); break;
+                    }
+
+                    if (!success || overrun * 8 > bit_count)
+                    {
+                        return false;
+                    }
+                }
+                while (!final_block);
+
+                return sink.consume (flushed, size_t(out - flushed));
+            }
+
+        private:
+
+            /**
+             * Deja al menos 56 bits en el buffer de bits.
+             */
+            void refill ()
+            {
+                #if defined(BASICS_LITTLE_ENDIAN) || defined(BASICS_ARM_ARCHITECTURE)
+
+                    if (input_end - input >= 8)
+                    {
+                        // Se leen 8 bytes de golpe y se avanza solo los que caben enteros. Los bits que
+                        // sobran son los de los bytes siguientes, por lo que volver a añadirlos no
+                        // cambia nada:
+
+                        uint64_t value;
+                        std::memcpy (&value, input, 8);
+
+                        bits      |= value << bit_count;
+                        input     += (63 - bit_count) >> 3;
+                        bit_count |= 56;
+
+                        return;
+                    }
+
+                #endif
+
+                while (bit_count <= 56)
+                {
+                    if (input < input_end) bits |= uint64_t(*input++) << bit_count; else overrun++;
+
+                    bit_count += 8;
+                }
+            }
+
+            void consume (unsigned count)
+            {
+                bits      >>= count;
+                bit_count  -= count;
+            }
+
+            unsigned get (unsigned count)
+            {
+                unsigned value = unsigned(bits) & ((1u << count) - 1);
+
+                consume (count);
+
+                return value;
+            }
+
+            int decode_slow (const Huffman & huffman)
+            {
+                unsigned code = reverse_bits (unsigned(bits) & 0xFFFF, 16);
+                unsigned length;
+
+                for (length = FAST_BITS + 1; code >= huffman.max_code[length]; ++length) ;
+
+                if (length >= 16) return -1;
+
+                unsigned index = (code >> (16 - length)) - huffman.first_code[length] + huffman.first_symbol[length];
+
+                if (index >= 288 || huffman.sizes[index] != length) return -1;
+
+                consume (length);
+
+                return huffman.symbols[index];
+            }
+
+            int decode (const Huffman & huffman)
+            {
+                uint32_t entry = huffman.fast[bits & FAST_MASK];
+
+                if (entry)
+                {
+                    consume (entry & 15);
+
+                    return int(entry >> 8) & 0x1FF;
+                }
+
+                return decode_slow (huffman);
+            }
+
+            /**
+             * Entrega al sink los datos nuevos y conserva al principio de la ventana los últimos
+             * HISTORY_SIZE bytes, que son a los que pueden hacer referencia los datos siguientes.
+             */
+            bool slide ()
+            {
+                if (!sink.consume (flushed, size_t(out - flushed)))
+                {
+                    return false;
+                }
+
+                std::memmove (window.data (), out - HISTORY_SIZE, HISTORY_SIZE);
+
+                out     = window.data () + HISTORY_SIZE;
+                flushed = out;
+
+                return overrun <= 8;
+            }
+
+            bool read_tables (Huffman & literal_length, Huffman & distance)
+            {
+                refill ();
+
+                unsigned literal_count  = get (5) + 257;
+                unsigned distance_count = get (5) + 1;
+                unsigned length_count   = get (4) + 4;
+
+                uint8_t code_lengths[19] = { };
+
+                for (unsigned i = 0; i < length_count; ++i)
+                {
+                    refill ();
+
+                    code_lengths[code_length_order[i]] = uint8_t(get (3));
+                }
+
+                Huffman code_length;
+
+                if (literal_count > 286 || !build (code_length, code_lengths, 19, false))
+                {
+                    return false;
+                }
+
+                uint8_t  lengths[286 + 32];
+                unsigned total = literal_count + distance_count;
+
+                for (unsigned count = 0; count < total; )
+                {
+                    refill ();
+
+                    int symbol = decode (code_length);
+
+                    if (symbol < 0) return false;
+
+                    if (symbol < 16)
+                    {
+                        lengths[count++] = uint8_t(symbol);
+                        continue;
+                    }
+
+                    uint8_t  value  = 0;
+                    unsigned repeat;
+
+                    if (symbol == 16)
+                    {
+                        if (count == 0) return false;
+
+                        value  = lengths[count - 1];
+                        repeat = 3 + get (2);
+                    }
+                    else
+                        repeat = symbol == 17 ? 3 + get (3) : 11 + get (7);
+
+                    if (count + repeat > total) return false;
+
+                    std::memset (lengths + count, value, repeat);
+
+                    count += repeat;
+                }
+
+                return lengths[256] != 0
+                    && build (literal_length, lengths, literal_count, true)
+                    && build (distance, lengths + literal_count, distance_count, false);
+            }
+
+            bool copy_stored_block ()
+            {
+                // Se descartan los bits hasta el siguiente byte y se devuelven a la entrada los
+                // bytes enteros que quedan en el buffer:
+
+                consume (bit_count & 7);
+
+                if (overrun * 8 > bit_count) return false;
+
+                input    -= bit_count / 8 - overrun;
+                bits      = 0;
+                bit_count = 0;
+                overrun   = 0;
+
+                if (input_end - input < 4) return false;
+
+                unsigned length   = unsigned(input[0]) | unsigned(input[1]) << 8;
+                unsigned inverted = unsigned(input[2]) | unsigned(input[3]) << 8;
+
+                input += 4;
+
+                if ((length ^ 0xFFFF) != inverted || size_t(input_end - input) < length) return false;
+
+                while (length > 0)
+                {
+                    if (out >= limit && !slide ()) return false;
+
+                    size_t chunk = std::min (size_t(length), size_t(limit + MARGIN - out));
+
+                    std::memcpy (out, input, chunk);
+
+                    out    += chunk;
+                    input  += chunk;
+                    length -= unsigned(chunk);
+                }
+
+                return true;
+            }
+
+            bool inflate_block (const Huffman & literal_length, const Huffman & distance)
+            {
+                for (;;)
+                {
+                    if (out >= limit && !slide ()) return false;
+
+                    // Tras rellenar quedan al menos 56 bits, que bastan para el símbolo más largo
+                    // (15), los bits extra de la longitud (5), la distancia (15) y sus bits extra (13):
+
+                    refill ();
+
+                    uint32_t entry = literal_length.fast[bits & FAST_MASK];
+                    int      symbol;
+
+                    if (entry)
+                    {
+                        consume (entry & 15);
+
+                        symbol = int(entry >> 8) & 0x1FF;
+
+                        if ((entry >> 4 & 3) == 2)
+                        {
+                            out[0] = byte(symbol);
+                            out[1] = byte(entry >> 17);
+                            out   += 2;
+                            continue;
+                        }
+                    }
+                    else
+                    if ((symbol = decode_slow (literal_length)) < 0)
+                    {
+                        return false;
+                    }
+
+                    if (symbol < 256)
+                    {
+                        *out++ = byte(symbol);
+                        continue;
+                    }
+
+                    if (symbol == 256)
+                    {
+                        return true;
+                    }
+
+                    if ((symbol -= 257) >= 29) return false;
+
+                    unsigned length = length_base[symbol] + get (length_extra[symbol]);
+
+                    if ((symbol = decode (distance)) < 0 || symbol >= 30) return false;
+
+                    size_t offset = distance_base[symbol] + get (distance_extra[symbol]);
+
+                    if (offset > size_t(out - window.data ())) return false;
+
+                    const byte * from = out - offset;
+                    byte       * end  = out + length;
+
+                    if (offset >= 8)
+                    {
+                        // Los bloques de 8 bytes no se solapan, aunque se pueden escribir hasta 7
+                        // bytes de más (que caben en MARGIN y se sobrescriben después):
+
+                        do
+                        {
+                            std::memcpy (out, from, 8);
+
+                            out  += 8;
+                            from += 8;
+                        }
+                        while (out < end);
+                    }
+                    else
+                    if (offset == 1)
+                    {
+                        std::memset (out, out[-1], length);
+                    }
+                    else
+                    {
+                        while (out < end) *out++ = *from++;
+                    }
+
+                    out = end;
+                }
+            }
+
+        };
+
+    }
+
+    bool inflate (const byte * data, size_t size, Inflate_Sink & sink)
+    {
+        return Inflater(data, size, sink).run ();
+    }
+
+    uint32_t adler32 (uint32_t adler, const byte * data, size_t size)
+    {
+        uint32_t a = adler & 0xFFFF, b = adler >> 16;
+
+        while (size > 0)
+        {
+            // 5552 es el máximo de bytes que se pueden sumar sin que b desborde antes del módulo:
+
+            size_t block = std::min (size, size_t(5552));
+
+            size -= block;
+
+            for ( ; block >= 8; block -= 8, data += 8)
+            {
+                a += data[0]; b += a;
+                a += data[1]; b += a;
+                a += data[2]; b += a;
+                a += data[3]; b += a;
+                a += data[4]; b += a;
+                a += data[5]; b += a;
+                a += data[6]; b += a;
+                a += data[7]; b += a;
+            }
+
+            while (block--)
+            {
+                a += *data++;
+                b += a;
+            }
+
+            a %= 65521;
+            b %= 65521;
+        }
+
+        return b << 16 | a;
+    }
+
+}}
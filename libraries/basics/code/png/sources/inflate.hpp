@@ -0,0 +1,53 @@
+/*
+ * INFLATE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803221000
+ */
+
+#ifndef BASICS_PNG_INFLATE_HEADER
+#define BASICS_PNG_INFLATE_HEADER
+
+    #include <cstddef>
+    #include <basics/types>
+
+    namespace basics { namespace png
+    {
+
+        /**
+         * Recibe los datos que va produciendo inflate() en el orden en que se descomprimen.
+         */
+        class Inflate_Sink
+        {
+        public:
+
+            virtual ~Inflate_Sink() = default;
+
+            /**
+             * @return false para abortar la descompresión.
+             */
+            virtual bool consume (const byte * data, size_t size) = 0;
+
+        };
+
+        /**
+         * Descomprime un flujo DEFLATE (RFC 1951) sin la cabecera zlib. Los datos no se acumulan:
+         * se entregan al sink por bloques a medida que se llena una ventana de 64 KiB, de modo que
+         * la memoria usada no depende del tamaño de los datos descomprimidos.
+         * @return false si los datos no son válidos o el sink aborta.
+         */
+        bool inflate (const byte * data, size_t size, Inflate_Sink & sink);
+
+        /**
+         * Calcula la suma Adler-32 de zlib a continuación de un valor previo (1 al empezar).
+         */
+        uint32_t adler32 (uint32_t adler, const byte * data, size_t size);
+
+    }}
+
+#endif
@@ -10,12 +10,579 @@
  * C1801221221
  */
 
-#include "lodepng.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <basics/macros>
 #include <basics/png_decode>
+#include "inflate.hpp"
+#include "lodepng.h"
+#include "png_filters.hpp"
+
+#if defined(BASICS_NEON_ENABLED)
+    #include <arm_neon.h>
+#endif
 
 namespace basics
 {
 
+    namespace
+    {
+
+        enum Color_Type
+        {
+            GRAY       = 0,
+            RGB        = 2,
+            PALETTE    = 3,
+            GRAY_ALPHA = 4,
+            RGB_ALPHA  = 6
+        };
+
+        struct Png_Info
+        {
+            unsigned width;
+            unsigned height;
+            unsigned bit_depth;
+            unsigned color_type;
+            unsigned interlace;
+            unsigned channels;
+
+            const byte * palette;
+            size_t       palette_size;
+            const byte * transparency;                  ///< Chunk tRNS (alfas de la paleta o color clave).
+            size_t       transparency_size;
+
+            std::vector< std::pair< const byte *, size_t > > idat_chunks;
+        };
+
+        inline uint32_t read_u32 (const byte * pointer)
+        {
+            return uint32_t(pointer[0]) << 24 | uint32_t(pointer[1]) << 16 | uint32_t(pointer[2]) << 8 | uint32_t(pointer[3]);
+        }
+
+        inline unsigned read_u16 (const byte * pointer)
+        {
+            return unsigned(pointer[0]) << 8 | unsigned(pointer[1]);
+        }
+
+        inline Rgba8888 rgba (unsigned r, unsigned g, unsigned b, unsigned a)
+        {
+            return Rgba8888(r) | Rgba8888(g) << 8 | Rgba8888(b) << 16 | Rgba8888(a) << 24;
+        }
+
+        bool read_header (const byte * data, size_t size, Png_Info & info)
+        {
+            static const byte signature[] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+
+            // Tras la firma debe venir el chunk IHDR con 13 bytes de datos:
+
+            if (size < 33 || std::memcmp (data, signature, 8) != 0 || read_u32 (data + 8) != 13 || std::memcmp (data + 12, "IHDR", 4) != 0)
+            {
+                return false;
+            }
+
+            info.width      = read_u32 (data + 16);
+            info.height     = read_u32 (data + 20);
+            info.bit_depth  = data[24];
+            info.color_type = data[25];
+            info.interlace  = data[28];
+
+            switch (info.color_type)
+            {
+                case GRAY:       info.channels = 1; break;
+                case RGB:        info.channels = 3; break;
+                case PALETTE:    info.channels = 1; break;
+                case GRAY_ALPHA: info.channels = 2; break;
+                case RGB_ALPHA:  info.channels = 4; break;
+                default:         return false;
+            }
+
+            bool valid_depth = info.color_type == GRAY    ? info.bit_depth == 1 || info.bit_depth == 2 || info.bit_depth == 4 || info.bit_depth == 8 || info.bit_depth == 16 :
+                               info.color_type == PALETTE ? info.bit_depth == 1 || info.bit_depth == 2 || info.bit_depth == 4 || info.bit_depth == 8 :
+                                                            info.bit_depth == 8 || info.bit_depth == 16;
+
+            return valid_depth && info.width > 0 && info.height > 0 && data[26] == 0 && data[27] == 0 && info.interlace <= 1;
+        }
+
+        bool read_chunks (const byte * data, size_t size, Png_Info & info)
+        {
+            if (!read_header (data, size, info))
+            {
+                return false;
+            }
+
+            info.palette           = nullptr;
+            info.palette_size      = 0;
+            info.transparency      = nullptr;
+            info.transparency_size = 0;
+
+            // Solo se guardan punteros a los datos de los chunks que interesan:
+
+            for (size_t offset = 33; offset + 12 <= size; )
+            {
+                size_t       length = read_u32 (data + offset);
+                const byte * type   = data + offset + 4;
+                const byte * chunk  = data + offset + 8;
+
+                if (length > size - offset - 12)
+                {
+                    return false;
+                }
+
+                if (std::memcmp (type, "IDAT", 4) == 0) info.idat_chunks.emplace_back (chunk, length); else
+                if (std::memcmp (type, "PLTE", 4) == 0) info.palette      = chunk, info.palette_size      = length / 3; else
+                if (std::memcmp (type, "tRNS", 4) == 0) info.transparency = chunk, info.transparency_size = length; else
+                if (std::memcmp (type, "IEND", 4) == 0) break;
+
+                offset += length + 12;
+            }
+
+            return !info.idat_chunks.empty () && (info.color_type != PALETTE || info.palette);
+        }
+
+        /**
+         * Busca el flujo zlib formado por los chunks IDAT y comprueba su cabecera.
+         * @param joined Memoria para unir los chunks si hay más de uno.
+         */
+        bool find_zlib_stream (const Png_Info & info, std::vector< byte > & joined, const byte *& zlib_data, size_t & zlib_size)
+        {
+            // Si hay un solo chunk IDAT (lo más habitual) se descomprime sin copiarlo:
+
+            if (info.idat_chunks.size () == 1)
+            {
+                zlib_data = info.idat_chunks.front ().first;
+                zlib_size = info.idat_chunks.front ().second;
+            }
+            else
+            {
+                for (auto & chunk : info.idat_chunks) joined.insert (joined.end (), chunk.first, chunk.first + chunk.second);
+
+                zlib_data = joined.data ();
+                zlib_size = joined.size ();
+            }
+
+            return zlib_size >= 6 && (zlib_data[0] & 15) == 8 && (zlib_data[0] >> 4) <= 7 && !(zlib_data[1] & 32) && (zlib_data[0] * 256u + zlib_data[1]) % 31 == 0;
+        }
+
+        // Conversión de una fila ya sin filtro a Rgba8888:
+
+        void expand_rgb (const byte * row, Rgba8888 * target, unsigned width)
+        {
+            unsigned x = 0;
+
+            #if defined(BASICS_NEON_ENABLED)
+
+                for ( ; x + 8 <= width; x += 8)
+                {
+                    uint8x8x3_t rgb = vld3_u8 (row + x * 3);
+                    uint8x8x4_t rgba;
+
+                    rgba.val[0] = rgb.val[0];
+                    rgba.val[1] = rgb.val[1];
+                    rgba.val[2] = rgb.val[2];
+                    rgba.val[3] = vdup_n_u8 (255);
+
+                    vst4_u8 (reinterpret_cast< uint8_t * >(target + x), rgba);
+                }
+
+            #elif defined(BASICS_SSE2_ENABLED)
+
+                // En x86 (little endian) se leen 4 bytes por píxel y se sustituye el cuarto por el alfa.
+                // El último píxel se deja para el bucle general para no leer fuera de la fila:
+
+                for ( ; x + 1 < width; ++x)
+                {
+                    uint32_t value;
+                    std::memcpy (&value, row + x * 3, 4);
+                    target[x] = value | 0xFF000000u;
+                }
+
+            #endif
+
+            for ( ; x < width; ++x)
+            {
+                target[x] = rgba (row[x * 3], row[x * 3 + 1], row[x * 3 + 2], 255);
+            }
+        }
+
+        void expand_row (const Png_Info & info, const byte * row, Rgba8888 * target, const Rgba8888 * palette)
+        {
+            const unsigned width = info.width;
+            const unsigned depth = info.bit_depth;
+
+            switch (info.color_type)
+            {
+                case RGB_ALPHA:
+                {
+                    if (depth == 8)
+                    {
+                        std::memcpy (target, row, width * 4);
+                    }
+                    else for (unsigned x = 0; x < width; ++x, row += 8)
+                    {
+                        target[x] = rgba (row[0], row[2], row[4], row[6]);
+                    }
+
+                    break;
+                }
+
+                case RGB:
+                {
+                    // Con tRNS, el color clave (comparado con la profundidad original) es transparente:
+
+                    if (info.transparency_size >= 6)
+                    {
+                        unsigned key_r = read_u16 (info.transparency);
+                        unsigned key_g = read_u16 (info.transparency + 2);
+                        unsigned key_b = read_u16 (info.transparency + 4);
+
+                        for (unsigned x = 0; x < width; ++x)
+                        {
+                            unsigned r, g, b, shift = depth == 16 ? 8 : 0;
+
+                            if (depth == 16) r = read_u16 (row + x * 6), g = read_u16 (row + x * 6 + 2), b = read_u16 (row + x * 6 + 4);
+                            else             r = row[x * 3], g = row[x * 3 + 1], b = row[x * 3 + 2];
+
+                            target[x] = rgba (r >> shift, g >> shift, b >> shift, r == key_r && g == key_g && b == key_b ? 0 : 255);
+                        }
+                    }
+                    else
+                    if (depth == 8)
+                    {
+                        expand_rgb (row, target, width);
+                    }
+                    else for (unsigned x = 0; x < width; ++x, row += 6)
+                    {
+                        target[x] = rgba (row[0], row[2], row[4], 255);
+                    }
+
+                    break;
+                }
+
+                case GRAY_ALPHA:
+                {
+                    unsigned step = depth / 4;
+
+                    for (unsigned x = 0; x < width; ++x, row += step)
+                    {
+                        target[x] = Rgba8888(row[0]) * 0x010101u | Rgba8888(row[step / 2]) << 24;
+                    }
+
+                    break;
+                }
+
+                case GRAY:
+                {
+                    bool     keyed = info.transparency_size >= 2;
+                    unsigned key   = keyed ? read_u16 (info.transparency) : 0;
+
+                    if (depth == 16)
+                    {
+                        for (unsigned x = 0; x < width; ++x, row += 2)
+                        {
+                            target[x] = Rgba8888(row[0]) * 0x010101u | (keyed && read_u16 (row) == key ? 0 : 0xFF000000u);
+                        }
+                    }
+                    else
+                    if (depth == 8 && !keyed)
+                    {
+                        for (unsigned x = 0; x < width; ++x)
+                        {
+                            target[x] = Rgba8888(row[x]) * 0x010101u | 0xFF000000u;
+                        }
+                    }
+                    else
+                    {
+                        // Los valores de menos de 8 bits se escalan al rango [0, 255]:
+
+                        unsigned mask  = (1u << depth) - 1;
+                        unsigned scale = 255 / mask;
+
+                        for (unsigned x = 0; x < width; ++x)
+                        {
+                            unsigned bit   = x * depth;
+                            unsigned value = (row[bit >> 3] >> (8 - depth - (bit & 7))) & mask;
+
+                            target[x] = Rgba8888(value * scale) * 0x010101u | (keyed && value == key ? 0 : 0xFF000000u);
+                        }
+                    }
+
+                    break;
+                }
+
+                case PALETTE:
+                {
+                    if (depth == 8)
+                    {
+                        for (unsigned x = 0; x < width; ++x) target[x] = palette[row[x]];
+                    }
+                    else
+                    {
+                        unsigned mask = (1u << depth) - 1;
+
+                        for (unsigned x = 0; x < width; ++x)
+                        {
+                            unsigned bit = x * depth;
+
+                            target[x] = palette[(row[bit >> 3] >> (8 - depth - (bit & 7))) & mask];
+                        }
+                    }
+
+                    break;
+                }
+            }
+        }
+
+        /**
+         * Recibe los datos descomprimidos, los agrupa en filas, les quita el filtro y las convierte
+         * al destino. Solo guarda la fila actual y la anterior (que necesitan los filtros).
+         */
+        class Row_Writer : public png::Inflate_Sink
+        {
+
+            const Png_Info    & info;
+            const Rgba8888    * palette;
+            byte              * pixels;
+            size_t              pitch;
+            size_t              scanline_size;          ///< Bytes de una fila más el byte del tipo de filtro.
+            unsigned            bpp;
+            bool                verify_checksum;
+            uint32_t            adler;
+
+            std::vector< byte > scanlines;
+            byte              * current;
+            byte              * previous;
+            size_t              filled;
+            unsigned            y;
+
+        public:
+
+            Row_Writer(const Png_Info & info, const Rgba8888 * palette, Rgba8888 * pixels, size_t pitch, bool verify_checksum)
+            :
+                info           (info),
+                palette        (palette),
+                pixels         (reinterpret_cast< byte * >(pixels)),
+                pitch          (pitch),
+                scanline_size  ((size_t(info.width) * info.channels * info.bit_depth + 7) / 8 + 1),
+                bpp            (info.channels * info.bit_depth >= 8 ? info.channels * info.bit_depth / 8 : 1),
+                verify_checksum(verify_checksum),
+                adler          (1),
+                scanlines      (scanline_size * 2),
+                current        (scanlines.data ()),
+                previous       (nullptr),
+                filled         (0),
+                y              (0)
+            {
+            }
+
+            bool is_complete () const
+            {
+                return y == info.height;
+            }
+
+            /**
+             * Compara la suma Adler-32 de los datos recibidos con la del flujo zlib (que siempre es
+             * correcta si no se ha pedido comprobarla).
+             */
+            bool check_adler32 (uint32_t expected) const
+            {
+                return !verify_checksum || adler == expected;
+            }
+
+            bool consume (const byte * data, size_t size) override
+            {
+                if (verify_checksum)
+                {
+                    adler = png::adler32 (adler, data, size);
+                }
+
+                // Los datos que sobran tras la última fila se ignoran, como hace lodepng:
+
+                while (size > 0 && y < info.height)
+                {
+                    size_t chunk = std::min (size, scanline_size - filled);
+
+                    std::memcpy (current + filled, data, chunk);
+
+                    data   += chunk;
+                    size   -= chunk;
+                    filled += chunk;
+
+                    if (filled == scanline_size)
+                    {
+                        if (!png::unfilter_row (current + 1, previous ? previous + 1 : nullptr, scanline_size - 1, bpp, current[0]))
+                        {
+                            return false;
+                        }
+
+                        expand_row (info, current + 1, reinterpret_cast< Rgba8888 * >(pixels + y * pitch), palette);
+
+                        previous = current;
+                        current  = current == scanlines.data () ? scanlines.data () + scanline_size : scanlines.data ();
+                        filled   = 0;
+
+                        ++y;
+                    }
+                }
+
+                return true;
+            }
+
+        };
+
+        /**
+         * Las imágenes entrelazadas (Adam7), que son poco habituales en los assets de un juego, se
+         * decodifican con lodepng y se copian al destino.
+         */
+        bool decode_interlaced (const byte * encoded_data, size_t size, Rgba8888 * pixels, size_t pitch)
+        {
+            unsigned char * decoded = nullptr;
+            unsigned        width, height;
+
+            if (lodepng_decode32 (&decoded, &width, &height, encoded_data, size) != 0)
+            {
+                std::free (decoded);
+                return false;
+            }
+
+            for (unsigned y = 0; y < height; ++y)
+            {
+                std::memcpy (reinterpret_cast< byte * >(pixels) + y * pitch, decoded + size_t(y) * width * 4, width * 4);
+            }
+
+            std::free (decoded);
+
+            return true;
+        }
+
+    }
+
+    bool png_read_size (const byte * encoded_data, size_t size, unsigned & width, unsigned & height)
+    {
+        Png_Info info;
+
+        if (read_header (encoded_data, size, info))
+        {
+            width  = info.width;
+            height = info.height;
+
+            return true;
+        }
+
+        return false;
+    }
+
+    bool png_read_logical_size (const byte * encoded_data, size_t size, unsigned & width, unsigned & height)
+    {
+        Png_Info info;
+
+        if (!read_header (encoded_data, size, info))
+        {
+            return false;
+        }
+
+        // El chunk bsSz va antes de los datos de la imagen, por lo que no hace falta seguir después
+        // del primer IDAT:
+
+        for (size_t offset = 33; offset + 12 <= size; )
+        {
+            size_t       length = read_u32 (encoded_data + offset);
+            const byte * type   = encoded_data + offset + 4;
+            const byte * chunk  = encoded_data + offset + 8;
+
+            if (length > size - offset - 12 || std::memcmp (type, "IDAT", 4) == 0)
+            {
+                break;
+            }
+
+            if (std::memcmp (type, "bsSz", 4) == 0 && length == 8 && read_u32 (chunk) > 0 && read_u32 (chunk + 4) > 0)
+            {
+                width  = read_u32 (chunk    );
+                height = read_u32 (chunk + 4);
+
+                return true;
+            }
+
+            offset += length + 12;
+        }
+
+        return false;
+    }
+
+    bool png_decode (const byte * encoded_data, size_t size, Rgba8888 * pixels, size_t pitch, const Png_Decode_Options & options)
+    {
+        Png_Info info;
+
+        if (!read_chunks (encoded_data, size, info) || pitch < size_t(info.width) * 4)
+        {
+            return false;
+        }
+
+        if (info.interlace)
+        {
+            return decode_interlaced (encoded_data, size, pixels, pitch);
+        }
+
+        // Tabla de colores de la paleta con los alfas del chunk tRNS:
+
+        Rgba8888 palette[256] = { };
+
+        if (info.color_type == PALETTE)
+        {
+            for (size_t index = 0; index < info.palette_size && index < 256; ++index)
+            {
+                const byte * entry = info.palette + index * 3;
+                unsigned     alpha = index < info.transparency_size ? info.transparency[index] : 255;
+
+                palette[index] = rgba (entry[0], entry[1], entry[2], alpha);
+            }
+        }
+
+        const byte        * zlib_data;
+        size_t              zlib_size;
+        std::vector< byte > joined;
+
+        if (!find_zlib_stream (info, joined, zlib_data, zlib_size))
+        {
+            return false;
+        }
+
+        Row_Writer writer(info, palette, pixels, pitch, options.verify_checksum);
+
+        if (options.fast_inflate)
+        {
+            // Las filas se convierten a medida que se descomprimen, por lo que no hace falta
+            // guardar la imagen descomprimida:
+
+            if (!png::inflate (zlib_data + 2, zlib_size - 6, writer))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            // lodepng escribe desde el principio del buffer que recibe y solo lo amplía si no cabe,
+            // por lo que se reserva de una vez el tamaño que deben tener los datos:
+
+            size_t expected_size = ((size_t(info.width) * info.channels * info.bit_depth + 7) / 8 + 1) * info.height;
+            byte * inflated_data = static_cast< byte * >(std::malloc (expected_size));
+            size_t inflated_size = inflated_data ? expected_size : 0;
+
+            bool   success = lodepng_inflate (&inflated_data, &inflated_size, zlib_data + 2, zlib_size - 6, &lodepng_default_decompress_settings) == 0
+                          && writer.consume (inflated_data, inflated_size);
+
+            std::free (inflated_data);
+
+            if (!success)
+            {
+                return false;
+            }
+        }
+
+        return writer.is_complete () && writer.check_adler32 (read_u32 (zlib_data + zlib_size - 4));
+    }
+
     bool png_decode
     (
         const std::vector< byte > & encoded_data,
@@ -24,30 +591,28 @@ namespace basics
         unsigned & height
     )
     {
-        std::vector< byte > decoded_data;
-
-        int error = lodepng::decode
-        (
-            decoded_data,
-            width,
-            height,
-            encoded_data,
-            LCT_RGBA,
-            8
-        );
+        return png_decode (encoded_data.data (), encoded_data.size (), color_buffer, width, height);
+    }
 
-        if (!error)
+    bool png_decode
+    (
+        const byte                * encoded_data,
+        size_t                      size,
+        Color_Buffer < Rgba8888 > & color_buffer,
+        unsigned & width,
+        unsigned & height
+    )
+    {
+        if (png_read_size (encoded_data, size, width, height))
         {
             color_buffer.resize (width, height);
 
-            byte * buffer = color_buffer;
-
-            for (auto i = decoded_data.begin (); i != decoded_data.end (); ++i)
+            if (png_decode (encoded_data, size, color_buffer.buffer.data (), width * sizeof(Rgba8888)))
             {
-                *buffer++ = *i;
+                return true;
             }
 
-            return true;
+            color_buffer.resize (0, 0);
         }
 
         return false;
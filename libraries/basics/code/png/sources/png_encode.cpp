@@ -0,0 +1,73 @@
+/*
+ * PNG ENCODE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803101330
+ */
+
+#include "lodepng.h"
+#include <basics/png_encode>
+
+namespace basics
+{
+
+    bool png_encode (const Color_Buffer< Rgba8888 > & color_buffer, std::vector< byte > & encoded_data)
+    {
+        encoded_data.clear ();
+
+        if (color_buffer.size () > 0)
+        {
+            const byte * pixels = reinterpret_cast< const byte * >(&color_buffer[0]);
+
+            int error = lodepng::encode
+            (
+                encoded_data,
+                pixels,
+                color_buffer.get_width  (),
+                color_buffer.get_height (),
+                LCT_RGBA,
+                8
+            );
+
+            return error == 0;
+        }
+
+        return false;
+    }
+
+    bool png_encode (const Color_Buffer< Rgba8888 > & color_buffer, std::vector< byte > & encoded_data, unsigned logical_width, unsigned logical_height)
+    {
+        if (!png_encode (color_buffer, encoded_data))
+        {
+            return false;
+        }
+
+        // El chunk se inserta tras IHDR (firma de 8 bytes + 25 bytes del chunk). Su nombre indica
+        // que es auxiliar, privado y que se puede copiar aunque se modifique la imagen:
+
+        byte chunk[20] = { 0, 0, 0, 8, 'b', 's', 'S', 'z' };
+
+        for (unsigned index = 0; index < 4; ++index)
+        {
+            chunk[ 8 + index] = byte(logical_width  >> (24 - index * 8));
+            chunk[12 + index] = byte(logical_height >> (24 - index * 8));
+        }
+
+        unsigned crc = lodepng_crc32 (chunk + 4, 12);
+
+        for (unsigned index = 0; index < 4; ++index)
+        {
+            chunk[16 + index] = byte(crc >> (24 - index * 8));
+        }
+
+        encoded_data.insert (encoded_data.begin () + 33, chunk, chunk + sizeof(chunk));
+
+        return true;
+    }
+
+}
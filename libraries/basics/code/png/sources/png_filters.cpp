@@ -0,0 +1,313 @@
+/*
+ * PNG FILTERS
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803211000
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <basics/macros>
+#include "png_filters.hpp"
+
+#if   defined(BASICS_SSE2_ENABLED)
+    #include <emmintrin.h>
+#elif defined(BASICS_NEON_ENABLED)
+    #include <arm_neon.h>
+#endif
+
+namespace basics { namespace png
+{
+
+    namespace
+    {
+
+        inline byte paeth_predictor (int a, int b, int c)
+        {
+            int pa = std::abs (b - c);
+            int pb = std::abs (a - c);
+            int pc = std::abs (a + b - c - c);
+
+            return byte(pa <= pb && pa <= pc ? a : pb <= pc ? b : c);
+        }
+
+        // Versiones genéricas (cualquier bpp):
+
+        void unfilter_sub (byte * row, size_t length, unsigned bpp)
+        {
+            for (size_t i = bpp; i < length; ++i) row[i] = byte(row[i] + row[i - bpp]);
+        }
+
+        void unfilter_up (byte * row, const byte * previous, size_t length)
+        {
+            size_t i = 0;
+
+            #if defined(BASICS_SSE2_ENABLED)
+
+                for ( ; i + 16 <= length; i += 16)
+                {
+                    __m128i x = _mm_loadu_si128 (reinterpret_cast< const __m128i * >(row      + i));
+                    __m128i b = _mm_loadu_si128 (reinterpret_cast< const __m128i * >(previous + i));
+
+                    _mm_storeu_si128 (reinterpret_cast< __m128i * >(row + i), _mm_add_epi8 (x, b));
+                }
+
+            #elif defined(BASICS_NEON_ENABLED)
+
+                for ( ; i + 16 <= length; i += 16)
+                {
+                    vst1q_u8 (row + i, vaddq_u8 (vld1q_u8 (row + i), vld1q_u8 (previous + i)));
+                }
+
+            #endif
+
+            for ( ; i < length; ++i) row[i] = byte(row[i] + previous[i]);
+        }
+
+        void unfilter_average (byte * row, const byte * previous, size_t length, unsigned bpp)
+        {
+            size_t i = 0;
+
+            if (previous)
+            {
+                for ( ; i < bpp;    ++i) row[i] = byte(row[i] + (previous[i] >> 1));
+                for ( ; i < length; ++i) row[i] = byte(row[i] + ((row[i - bpp] + previous[i]) >> 1));
+            }
+            else
+            {
+                for (i = bpp; i < length; ++i) row[i] = byte(row[i] + (row[i - bpp] >> 1));
+            }
+        }
+
+        void unfilter_paeth (byte * row, const byte * previous, size_t length, unsigned bpp)
+        {
+            size_t i = 0;
+
+            for ( ; i < bpp;    ++i) row[i] = byte(row[i] + previous[i]);
+            for ( ; i < length; ++i) row[i] = byte(row[i] + paeth_predictor (row[i - bpp], previous[i], previous[i - bpp]));
+        }
+
+        // Versiones vectoriales para píxeles de 3 y 4 bytes (RGB y RGBA de 8 bits), en las que cada
+        // píxel depende del de su izquierda, por lo que se procesa un píxel por iteración con todos
+        // sus canales en paralelo:
+
+        template< unsigned BPP >
+        inline uint32_t load_pixel (const byte * pointer)
+        {
+            uint32_t value = 0;
+            std::memcpy (&value, pointer, BPP);
+            return value;
+        }
+
+        template< unsigned BPP >
+        inline void store_pixel (byte * pointer, uint32_t value)
+        {
+            std::memcpy (pointer, &value, BPP);
+        }
+
+        #if defined(BASICS_SSE2_ENABLED)
+
+            template< unsigned BPP >
+            void unfilter_sub_simd (byte * row, size_t length)
+            {
+                __m128i a = _mm_setzero_si128 ();
+
+                for (size_t i = 0; i + BPP <= length; i += BPP)
+                {
+                    a = _mm_add_epi8 (a, _mm_cvtsi32_si128 (int(load_pixel< BPP > (row + i))));
+
+                    store_pixel< BPP > (row + i, uint32_t(_mm_cvtsi128_si32 (a)));
+                }
+            }
+
+            template< unsigned BPP >
+            void unfilter_average_simd (byte * row, const byte * previous, size_t length)
+            {
+                const __m128i one = _mm_set1_epi8 (1);
+                      __m128i a   = _mm_setzero_si128 ();
+
+                for (size_t i = 0; i + BPP <= length; i += BPP)
+                {
+                    __m128i b = _mm_cvtsi32_si128 (int(load_pixel< BPP > (previous + i)));
+                    __m128i x = _mm_cvtsi32_si128 (int(load_pixel< BPP > (row      + i)));
+
+                    // _mm_avg_epu8 redondea hacia arriba y el filtro trunca:
+
+                    __m128i average = _mm_sub_epi8 (_mm_avg_epu8 (a, b), _mm_and_si128 (_mm_xor_si128 (a, b), one));
+
+                    a = _mm_add_epi8 (x, average);
+
+                    store_pixel< BPP > (row + i, uint32_t(_mm_cvtsi128_si32 (a)));
+                }
+            }
+
+            inline __m128i absolute (__m128i x)
+            {
+                return _mm_max_epi16 (x, _mm_sub_epi16 (_mm_setzero_si128 (), x));
+            }
+
+            inline __m128i select (__m128i mask, __m128i a, __m128i b)
+            {
+                return _mm_or_si128 (_mm_and_si128 (mask, a), _mm_andnot_si128 (mask, b));
+            }
+
+            template< unsigned BPP >
+            void unfilter_paeth_simd (byte * row, const byte * previous, size_t length)
+            {
+                const __m128i zero = _mm_setzero_si128 ();
+
+                __m128i a = zero, b = zero, c = zero;
+
+                for (size_t i = 0; i + BPP <= length; i += BPP)
+                {
+                    c = b;
+                    b = _mm_unpacklo_epi8 (_mm_cvtsi32_si128 (int(load_pixel< BPP > (previous + i))), zero);
+
+                    __m128i x  = _mm_cvtsi32_si128 (int(load_pixel< BPP > (row + i)));
+
+                    __m128i pa = _mm_sub_epi16 (b, c);
+                    __m128i pb = _mm_sub_epi16 (a, c);
+                    __m128i pc = absolute (_mm_add_epi16 (pa, pb));
+
+                    pa = absolute (pa);
+                    pb = absolute (pb);
+
+                    // En caso de empate se prefiere a sobre b y b sobre c:
+
+                    __m128i smallest = _mm_min_epi16 (pc, _mm_min_epi16 (pa, pb));
+                    __m128i nearest  = select (_mm_cmpeq_epi16 (smallest, pa), a, select (_mm_cmpeq_epi16 (smallest, pb), b, c));
+
+                    x = _mm_add_epi8 (x, _mm_packus_epi16 (nearest, nearest));
+                    a = _mm_unpacklo_epi8 (x, zero);
+
+                    store_pixel< BPP > (row + i, uint32_t(_mm_cvtsi128_si32 (x)));
+                }
+            }
+
+        #elif defined(BASICS_NEON_ENABLED)
+
+            template< unsigned BPP >
+            inline uint8x8_t load_pixel_neon (const byte * pointer)
+            {
+                return vreinterpret_u8_u32 (vdup_n_u32 (load_pixel< BPP > (pointer)));
+            }
+
+            template< unsigned BPP >
+            inline void store_pixel_neon (byte * pointer, uint8x8_t value)
+            {
+                store_pixel< BPP > (pointer, vget_lane_u32 (vreinterpret_u32_u8 (value), 0));
+            }
+
+            template< unsigned BPP >
+            void unfilter_sub_simd (byte * row, size_t length)
+            {
+                uint8x8_t a = vdup_n_u8 (0);
+
+                for (size_t i = 0; i + BPP <= length; i += BPP)
+                {
+                    a = vadd_u8 (a, load_pixel_neon< BPP > (row + i));
+
+                    store_pixel_neon< BPP > (row + i, a);
+                }
+            }
+
+            template< unsigned BPP >
+            void unfilter_average_simd (byte * row, const byte * previous, size_t length)
+            {
+                uint8x8_t a = vdup_n_u8 (0);
+
+                for (size_t i = 0; i + BPP <= length; i += BPP)
+                {
+                    // vhadd_u8 calcula (a + b) >> 1 sin desbordamiento:
+
+                    a = vadd_u8 (load_pixel_neon< BPP > (row + i), vhadd_u8 (a, load_pixel_neon< BPP > (previous + i)));
+
+                    store_pixel_neon< BPP > (row + i, a);
+                }
+            }
+
+            template< unsigned BPP >
+            void unfilter_paeth_simd (byte * row, const byte * previous, size_t length)
+            {
+                uint8x8_t a = vdup_n_u8 (0), b = a, c = a;
+
+                for (size_t i = 0; i + BPP <= length; i += BPP)
+                {
+                    c = b;
+                    b = load_pixel_neon< BPP > (previous + i);
+
+                    uint16x8_t pa = vabdl_u8  (b, c);
+                    uint16x8_t pb = vabdl_u8  (a, c);
+                    uint16x8_t pc = vabdq_u16 (vaddl_u8 (a, b), vaddl_u8 (c, c));
+
+                    uint8x8_t  choose_a = vmovn_u16 (vandq_u16 (vcleq_u16 (pa, pb), vcleq_u16 (pa, pc)));
+                    uint8x8_t  choose_b = vmovn_u16 (vcleq_u16 (pb, pc));
+
+                    a = vadd_u8 (load_pixel_neon< BPP > (row + i), vbsl_u8 (choose_a, a, vbsl_u8 (choose_b, b, c)));
+
+                    store_pixel_neon< BPP > (row + i, a);
+                }
+            }
+
+        #endif
+
+    }
+
+    bool unfilter_row (byte * row, const byte * previous, size_t length, unsigned bpp, unsigned filter_type)
+    {
+        // En la primera fila la fila anterior se considera a cero, con lo que UP no hace nada y
+        // PAETH equivale a SUB:
+
+        if (!previous)
+        {
+            if (filter_type == FILTER_UP   ) filter_type = FILTER_NONE; else
+            if (filter_type == FILTER_PAETH) filter_type = FILTER_SUB;
+        }
+
+        #if defined(BASICS_SSE2_ENABLED) || defined(BASICS_NEON_ENABLED)
+
+            if (bpp == 3 || bpp == 4)
+            {
+                switch (filter_type)
+                {
+                    case FILTER_SUB:
+                    {
+                        if (bpp == 4) unfilter_sub_simd< 4 > (row, length); else unfilter_sub_simd< 3 > (row, length);
+                        return true;
+                    }
+
+                    case FILTER_AVERAGE:
+                    {
+                        if (!previous) break;
+                        if (bpp == 4) unfilter_average_simd< 4 > (row, previous, length); else unfilter_average_simd< 3 > (row, previous, length);
+                        return true;
+                    }
+
+                    case FILTER_PAETH:
+                    {
+                        if (bpp == 4) unfilter_paeth_simd< 4 > (row, previous, length); else unfilter_paeth_simd< 3 > (row, previous, length);
+                        return true;
+                    }
+                }
+            }
+
+        #endif
+
+        switch (filter_type)
+        {
+            case FILTER_NONE:                                                           return true;
+            case FILTER_SUB:     unfilter_sub     (row,           length, bpp);         return true;
+            case FILTER_UP:      unfilter_up      (row, previous, length);              return true;
+            case FILTER_AVERAGE: unfilter_average (row, previous, length, bpp);         return true;
+            case FILTER_PAETH:   unfilter_paeth   (row, previous, length, bpp);         return true;
+        }
+
+        return false;
+    }
+
+}}
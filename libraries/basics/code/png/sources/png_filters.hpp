@@ -0,0 +1,44 @@
+/*
+ * PNG FILTERS
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803211000
+ */
+
+#ifndef BASICS_PNG_FILTERS_HEADER
+#define BASICS_PNG_FILTERS_HEADER
+
+    #include <cstddef>
+    #include <basics/types>
+
+    namespace basics { namespace png
+    {
+
+        enum Filter_Type
+        {
+            FILTER_NONE,
+            FILTER_SUB,
+            FILTER_UP,
+            FILTER_AVERAGE,
+            FILTER_PAETH
+        };
+
+        /**
+         * Deshace el filtro de una fila de la imagen (sin el byte con el tipo de filtro).
+         * @param row Bytes de la fila, que se reemplazan por los originales.
+         * @param previous Fila anterior ya sin filtro (nullptr en la primera fila).
+         * @param length Número de bytes de la fila.
+         * @param bpp Distancia en bytes entre un byte y el correspondiente del píxel de la izquierda
+         *     (con profundidades menores de 8 bits es 1).
+         * @return false si el tipo de filtro no es válido.
+         */
+        bool unfilter_row (byte * row, const byte * previous, size_t length, unsigned bpp, unsigned filter_type);
+
+    }}
+
+#endif
@@ -0,0 +1,136 @@
+/*
+ * CANVAS RASTER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803101230
+ */
+
+#ifndef BASICS_SOFTWARE_CANVAS_RASTER_HEADER
+#define BASICS_SOFTWARE_CANVAS_RASTER_HEADER
+
+    #include <vector>
+    #include <basics/Canvas>
+    #include <basics/Color_Buffer>
+    #include <basics/Transformation>
+
+    namespace basics { namespace software
+    {
+
+        class Context;
+        class Texture_2D;
+
+        /**
+         * Implementación de Canvas que rasteriza por CPU sobre el Color_Buffer de un software::Context.
+         * Reproduce las convenciones de Canvas_ES2 (proyección, transformaciones, anclajes, volteos y
+         * mezcla SRC_ALPHA / ONE_MINUS_SRC_ALPHA) para que las imágenes generadas sean comparables.
+         */
+        class Canvas_Raster : public basics::Canvas
+        {
+        public:
+
+            enum Sampling
+            {
+                NEAREST,
+                BILINEAR
+            };
+
+        public:
+
+            static Canvas * create (Id id, Graphics_Context::Accessor & context, const Options & options);
+
+        public:
+
+            static void enable ()
+            {
+                register_factory (ID(software), Canvas_Raster::create);
+            }
+
+        private:
+
+            struct Vertex
+            {
+                float x, y;                             ///< Coordenadas en píxeles del color buffer (y hacia abajo).
+                float u, v;                             ///< Coordenadas de textura normalizadas.
+            };
+
+            typedef std::vector< Rgba8888 > Span;
+
+        private:
+
+            Context & context;
+
+            Size2f    size;
+
+            Transformation2f transform;
+            Transformation2f projection;
+
+            Rgba8888  clear_color;
+            Rgba8888  color;                            ///< Color sólido (sin opacidad aplicada).
+            unsigned  opacity;                          ///< Opacidad en el rango [0, 256].
+            Blending  blending;
+            Sampling  sampling;
+
+            Span      span;                             ///< Memoria temporal para los píxeles de origen de un span.
+
+        public:
+
+            Canvas_Raster(Context & context, const Size2u & size);
+
+        public:
+
+            void set_sampling (Sampling new_sampling)
+            {
+                sampling = new_sampling;
+            }
+
+        public:
+
+            void reset_state     () override;
+
+        public:
+
+            void set_size        (const Size2u & size) override;
+
+        public:
+
+            void set_clear_color (float r, float g, float b) override;
+            void set_color       (float r, float g, float b) override;
+            void set_opacity     (float opacity) override;
+            void set_blending    (Blending blending) override;
+            void set_transform   (const Transformation2f & transform) override;
+            void apply_transform (const Transformation2f & transform) override;
+
+        public:
+
+            void clear           () override;
+            void draw_point      (const Point2f & position) override;
+            void draw_segment    (const Point2f & a, const Point2f & b) override;
+            void draw_triangle   (const Point2f & a, const Point2f & b, const Point2f & c) override;
+            void fill_triangle   (const Point2f & a, const Point2f & b, const Point2f & c) override;
+            void draw_rectangle  (const Point2f & bottom_left, const Size2f & size) override;
+            void fill_rectangle  (const Point2f & bottom_left, const Size2f & size) override;
+            void fill_rectangle  (const Point2f & where, const Size2f & size, const basics::Texture_2D * texture, int handling = CENTER) override;
+            void fill_rectangle  (const Point2f & where, const Size2f & size, const Atlas::Slice * slice, int handling = CENTER) override;
+
+        private:
+
+            Transformation2f get_raster_transform () const;
+            Vertex           to_raster            (const Transformation2f & raster_transform, const Point2f & point, float u = 0.f, float v = 0.f) const;
+
+            void trace_segment  (const Vertex & start, const Vertex & end);
+            void fill_polygon   (const Vertex * vertices, unsigned count, const Texture_2D * texture);
+            void fill_textured  (const Point2f & where, const Size2f & size, const Texture_2D * texture, const Point2f (& texture_uvs)[4], int handling);
+            void plot           (int x, int y);
+            void write_span     (Rgba8888 * target, const Rgba8888 * source, unsigned count);
+            void sample_span    (const Texture_2D & texture, float u, float v, float du, float dv, unsigned count);
+
+        };
+
+    }}
+
+#endif
@@ -0,0 +1,174 @@
+/*
+ * SOFTWARE CONTEXT
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803101220
+ */
+
+#ifndef BASICS_SOFTWARE_CONTEXT_HEADER
+#define BASICS_SOFTWARE_CONTEXT_HEADER
+
+    #include <memory>
+    #include <mutex>
+    #include <basics/Color_Buffer>
+    #include <basics/Graphics_Context>
+    #include <basics/Window>
+
+    namespace basics { namespace software
+    {
+
+        /**
+         * Contexto gráfico sin superficie de presentación (headless). Los renderers creados con él
+         * dibujan en un Color_Buffer en memoria, por lo que se puede usar en máquinas sin GPU para
+         * generar imágenes de referencia (golden images) o para medir el coste de las escenas.
+         */
+        class Context : public basics::Graphics_Context, public std::enable_shared_from_this< Context >
+        {
+
+            /**
+             * Ventana ficticia que solo sirve para satisfacer la interfaz de Graphics_Context.
+             */
+            class Offscreen_Window final : public basics::Window
+            {
+
+                Size2u size;
+
+            public:
+
+                Offscreen_Window(const Size2u & size) : Window(ID(offscreen)), size(size)
+                {
+                    available = true;
+                }
+
+                Size2u   get_size   () override { return size;        }
+                unsigned get_width  () override { return size.width;  }
+                unsigned get_height () override { return size.height; }
+
+            };
+
+        public:
+
+            /**
+             * Crea un contexto con una superficie del tamaño indicado.
+             * @param size Tamaño en píxeles de la superficie de dibujo.
+             * @param cache Caché de recursos opcional (igual que en el resto de contextos).
+             */
+            static std::shared_ptr< Context > create (const Size2u & size, Graphics_Resource_Cache * cache = nullptr);
+
+        private:
+
+            std::shared_ptr< Offscreen_Window > offscreen_window;
+            std::shared_ptr< std::mutex       > mutex;
+
+            Color_Buffer< Rgba8888 > color_buffer;
+
+            Point2u  viewport_bottom_left;
+            Size2u   viewport_size;
+            unsigned frame_count;
+
+        private:
+
+            Context(const std::shared_ptr< Offscreen_Window > & window, Graphics_Resource_Cache * cache);
+
+        public:
+
+           ~Context()
+            {
+                finalize ();
+            }
+
+        public:
+
+            /**
+             * Bloquea el contexto del mismo modo que lo hace Window::lock_graphics_context().
+             */
+            Graphics_Context::Accessor lock ()
+            {
+                return Graphics_Context::Accessor(shared_from_this (), *mutex);
+            }
+
+            Color_Buffer< Rgba8888 > & get_color_buffer ()
+            {
+                return color_buffer;
+            }
+
+            const Color_Buffer< Rgba8888 > & get_color_buffer () const
+            {
+                return color_buffer;
+            }
+
+            const Point2u & get_viewport_bottom_left () const
+            {
+                return viewport_bottom_left;
+            }
+
+            const Size2u & get_viewport_size () const
+            {
+                return viewport_size;
+            }
+
+            unsigned get_frame_count () const
+            {
+                return frame_count;
+            }
+
+        public:
+
+            void invalidate   () override { }
+            void suspend      () override { }
+            bool resume       () override { return true; }
+
+            bool is_available () const override { return true; }
+            bool is_current   () const override { return true; }
+
+            Id get_id () const override
+            {
+                return ID(software);
+            }
+
+            unsigned get_surface_width () override
+            {
+                return color_buffer.get_width ();
+            }
+
+            unsigned get_surface_height () override
+            {
+                return color_buffer.get_height ();
+            }
+
+            bool set_sync_swap (bool ) override
+            {
+                return false;
+            }
+
+            void reset_viewport () override
+            {
+                set_viewport ({ 0u, 0u }, { color_buffer.get_width (), color_buffer.get_height () });
+            }
+
+            void set_viewport (const Point2u & bottom_left, const Size2u & size) override
+            {
+                viewport_bottom_left = bottom_left;
+                viewport_size        = size;
+            }
+
+            bool make_current () override
+            {
+                return true;
+            }
+
+            bool flush_and_display () override
+            {
+                return ++frame_count, true;
+            }
+
+        };
+
+    }}
+
+#endif
@@ -0,0 +1,37 @@
+/*
+ * SOFTWARE RASTERIZER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803101210
+ */
+
+#ifndef BASICS_SOFTWARE_RASTERIZER_HEADER
+#define BASICS_SOFTWARE_RASTERIZER_HEADER
+
+    #include <basics/macros>
+
+    #if   defined(BASICS_AVX2_ENABLED)
+
+        #include <immintrin.h>
+
+    #elif defined(BASICS_SSE2_ENABLED)
+
+        #include <emmintrin.h>
+
+    #elif defined(BASICS_NEON_ENABLED)
+
+        #include <arm_neon.h>
+
+    #endif
+
+    namespace basics
+    {
+        class Software_Rasterizer;
+    }
+
+#endif
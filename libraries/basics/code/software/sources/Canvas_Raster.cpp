@@ -0,0 +1,975 @@
+/*
+ * CANVAS RASTER
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803101300
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <basics/software/Canvas_Raster>
+#include <basics/software/Context>
+#include <basics/software/Software_Rasterizer>
+#include <basics/software/Texture_2D>
+
+namespace basics { namespace software
+{
+
+    // ---------------------------------------------------------------------------------------------
+    // Operaciones con spans (tiras horizontales de píxeles contiguos). Todas las variantes SIMD
+    // calculan exactamente lo mismo que la versión escalar para que las imágenes generadas no
+    // dependan de la arquitectura de la máquina.
+
+    namespace
+    {
+
+        inline Rgba8888 pack (unsigned r, unsigned g, unsigned b, unsigned a)
+        {
+            return Rgba8888(r) | Rgba8888(g) << 8 | Rgba8888(b) << 16 | Rgba8888(a) << 24;
+        }
+
+        inline unsigned component (Rgba8888 color, unsigned index)
+        {
+            return (color >> (index << 3)) & 0xFF;
+        }
+
+        /**
+         * Calcula (a * b) / 255 con redondeo exacto.
+         */
+        inline unsigned multiply (unsigned a, unsigned b)
+        {
+            unsigned t = a * b + 128;
+
+            return (t + (t >> 8)) >> 8;
+        }
+
+        inline unsigned blend (unsigned source, unsigned target, unsigned alpha)
+        {
+            unsigned t = source * alpha + target * (255 - alpha) + 128;
+
+            return (t + (t >> 8)) >> 8;
+        }
+
+        // -----------------------------------------------------------------------------------------
+
+        void fill_span (Rgba8888 * target, Rgba8888 color, unsigned count)
+        {
+            #if defined(BASICS_AVX2_ENABLED)
+
+                const __m256i value8 = _mm256_set1_epi32 (int(color));
+
+                for ( ; count >= 8; count -= 8, target += 8)
+                {
+                    _mm256_storeu_si256 (reinterpret_cast< __m256i * >(target), value8);
+                }
+
+            #endif
+
+            #if defined(BASICS_SSE2_ENABLED)
+
+                const __m128i value4 = _mm_set1_epi32 (int(color));
+
+                for ( ; count >= 4; count -= 4, target += 4)
+                {
+                    _mm_storeu_si128 (reinterpret_cast< __m128i * >(target), value4);
+                }
+
+            #elif defined(BASICS_NEON_ENABLED)
+
+                const uint32x4_t value4 = vdupq_n_u32 (color);
+
+                for ( ; count >= 4; count -= 4, target += 4)
+                {
+                    vst1q_u32 (target, value4);
+                }
+
+            #endif
+
+            while (count--) *target++ = color;
+        }
+
+        // -----------------------------------------------------------------------------------------
+
+        #if defined(BASICS_SSE2_ENABLED)
+
+            /**
+             * Mezcla 4 píxeles de origen sobre 4 de destino. Los canales se expanden a 16 bits para
+             * poder calcular s * a + d * (255 - a) sin desbordamiento.
+             */
+            inline __m128i blend_4 (__m128i source, __m128i target)
+            {
+                const __m128i zero    = _mm_setzero_si128 ();
+                const __m128i max     = _mm_set1_epi16  (255);
+                const __m128i half    = _mm_set1_epi16  (128);
+
+                __m128i source_lo = _mm_unpacklo_epi8 (source, zero);
+                __m128i source_hi = _mm_unpackhi_epi8 (source, zero);
+                __m128i target_lo = _mm_unpacklo_epi8 (target, zero);
+                __m128i target_hi = _mm_unpackhi_epi8 (target, zero);
+
+                __m128i alpha_lo  = _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (source_lo, 0xFF), 0xFF);
+                __m128i alpha_hi  = _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (source_hi, 0xFF), 0xFF);
+
+                __m128i result_lo = _mm_add_epi16
+                (
+                    _mm_add_epi16 (_mm_mullo_epi16 (source_lo, alpha_lo), _mm_mullo_epi16 (target_lo, _mm_sub_epi16 (max, alpha_lo))),
+                    half
+                );
+
+                __m128i result_hi = _mm_add_epi16
+                (
+                    _mm_add_epi16 (_mm_mullo_epi16 (source_hi, alpha_hi), _mm_mullo_epi16 (target_hi, _mm_sub_epi16 (max, alpha_hi))),
+                    half
+                );
+
+                result_lo = _mm_srli_epi16 (_mm_add_epi16 (result_lo, _mm_srli_epi16 (result_lo, 8)), 8);
+                result_hi = _mm_srli_epi16 (_mm_add_epi16 (result_hi, _mm_srli_epi16 (result_hi, 8)), 8);
+
+                return _mm_packus_epi16 (result_lo, result_hi);
+            }
+
+        #endif
+
+        #if defined(BASICS_AVX2_ENABLED)
+
+            inline __m256i blend_8 (__m256i source, __m256i target)
+            {
+                const __m256i zero    = _mm256_setzero_si256 ();
+                const __m256i max     = _mm256_set1_epi16  (255);
+                const __m256i half    = _mm256_set1_epi16  (128);
+
+                __m256i source_lo = _mm256_unpacklo_epi8 (source, zero);
+                __m256i source_hi = _mm256_unpackhi_epi8 (source, zero);
+                __m256i target_lo = _mm256_unpacklo_epi8 (target, zero);
+                __m256i target_hi = _mm256_unpackhi_epi8 (target, zero);
+
+                __m256i alpha_lo  = _mm256_shufflehi_epi16 (_mm256_shufflelo_epi16 (source_lo, 0xFF), 0xFF);
+                __m256i alpha_hi  = _mm256_shufflehi_epi16 (_mm256_shufflelo_epi16 (source_hi, 0xFF), 0xFF);
+
+                __m256i result_lo = _mm256_add_epi16
+                (
+                    _mm256_add_epi16 (_mm256_mullo_epi16 (source_lo, alpha_lo), _mm256_mullo_epi16 (target_lo, _mm256_sub_epi16 (max, alpha_lo))),
+                    half
+                );
+
+                __m256i result_hi = _mm256_add_epi16
+                (
+                    _mm256_add_epi16 (_mm256_mullo_epi16 (source_hi, alpha_hi), _mm256_mullo_epi16 (target_hi, _mm256_sub_epi16 (max, alpha_hi))),
+                    half
+                );
+
+                result_lo = _mm256_srli_epi16 (_mm256_add_epi16 (result_lo, _mm256_srli_epi16 (result_lo, 8)), 8);
+                result_hi = _mm256_srli_epi16 (_mm256_add_epi16 (result_hi, _mm256_srli_epi16 (result_hi, 8)), 8);
+
+                return _mm256_packus_epi16 (result_lo, result_hi);
+            }
+
+        #endif
+
+        #if defined(BASICS_NEON_ENABLED)
+
+            inline uint8x16_t blend_4 (uint8x16_t source, uint8x16_t target)
+            {
+                // Se replica el alfa de cada píxel en sus cuatro bytes multiplicándolo por 0x01010101:
+
+                uint8x16_t alpha   = vreinterpretq_u8_u32 (vmulq_n_u32 (vshrq_n_u32 (vreinterpretq_u32_u8 (source), 24), 0x01010101u));
+                uint8x16_t inverse = vmvnq_u8 (alpha);
+
+                uint16x8_t result_lo = vmull_u8 (vget_low_u8  (source), vget_low_u8  (alpha));
+                uint16x8_t result_hi = vmull_u8 (vget_high_u8 (source), vget_high_u8 (alpha));
+
+                result_lo = vmlal_u8  (result_lo, vget_low_u8  (target), vget_low_u8  (inverse));
+                result_hi = vmlal_u8  (result_hi, vget_high_u8 (target), vget_high_u8 (inverse));
+                result_lo = vaddq_u16 (result_lo, vdupq_n_u16 (128));
+                result_hi = vaddq_u16 (result_hi, vdupq_n_u16 (128));
+                result_lo = vsraq_n_u16 (result_lo, result_lo, 8);
+                result_hi = vsraq_n_u16 (result_hi, result_hi, 8);
+
+                return vcombine_u8 (vshrn_n_u16 (result_lo, 8), vshrn_n_u16 (result_hi, 8));
+            }
+
+        #endif
+
+        /**
+         * Mezcla un span de origen sobre el de destino con SRC_ALPHA / ONE_MINUS_SRC_ALPHA, igual
+         * que hace Canvas_ES2 (incluido el canal alfa del destino).
+         */
+        void blend_span (Rgba8888 * target, const Rgba8888 * source, unsigned count)
+        {
+            #if defined(BASICS_AVX2_ENABLED)
+
+                for ( ; count >= 8; count -= 8, target += 8, source += 8)
+                {
+                    __m256i * target8 = reinterpret_cast< __m256i * >(target);
+
+                    _mm256_storeu_si256
+                    (
+                        target8,
+                        blend_8 (_mm256_loadu_si256 (reinterpret_cast< const __m256i * >(source)), _mm256_loadu_si256 (target8))
+                    );
+                }
+
+            #endif
+
+            #if defined(BASICS_SSE2_ENABLED)
+
+                for ( ; count >= 4; count -= 4, target += 4, source += 4)
+                {
+                    __m128i * target4 = reinterpret_cast< __m128i * >(target);
+
+                    _mm_storeu_si128
+                    (
+                        target4,
+                        blend_4 (_mm_loadu_si128 (reinterpret_cast< const __m128i * >(source)), _mm_loadu_si128 (target4))
+                    );
+                }
+
+            #elif defined(BASICS_NEON_ENABLED)
+
+                for ( ; count >= 4; count -= 4, target += 4, source += 4)
+                {
+                    uint8_t * target4 = reinterpret_cast< uint8_t * >(target);
+
+                    vst1q_u8 (target4, blend_4 (vld1q_u8 (reinterpret_cast< const uint8_t * >(source)), vld1q_u8 (target4)));
+                }
+
+            #endif
+
+            for ( ; count > 0; --count, ++target, ++source)
+            {
+                Rgba8888 s = *source;
+                Rgba8888 d = *target;
+                unsigned a = s >> 24;
+
+                if (a == 255) *target = s; else
+                if (a != 0)
+                {
+                    *target = pack
+                    (
+                        blend (component (s, 0), component (d, 0), a),
+                        blend (component (s, 1), component (d, 1), a),
+                        blend (component (s, 2), component (d, 2), a),
+                        blend (a,                component (d, 3), a)
+                    );
+                }
+            }
+        }
+
+        // -----------------------------------------------------------------------------------------
+
+        void add_span (Rgba8888 * target, const Rgba8888 * source, unsigned count)
+        {
+            for ( ; count > 0; --count, ++target, ++source)
+            {
+                Rgba8888 s = *source;
+                Rgba8888 d = *target;
+                unsigned a = s >> 24;
+
+                *target = pack
+                (
+                    std::min (255u, component (d, 0) + multiply (component (s, 0), a)),
+                    std::min (255u, component (d, 1) + multiply (component (s, 1), a)),
+                    std::min (255u, component (d, 2) + multiply (component (s, 2), a)),
+                    std::min (255u, component (d, 3) + multiply (a,                a))
+                );
+            }
+        }
+
+        void multiply_span (Rgba8888 * target, const Rgba8888 * source, unsigned count)
+        {
+            for ( ; count > 0; --count, ++target, ++source)
+            {
+                Rgba8888 s = *source;
+                Rgba8888 d = *target;
+
+                *target = pack
+                (
+                    multiply (component (s, 0), component (d, 0)),
+                    multiply (component (s, 1), component (d, 1)),
+                    multiply (component (s, 2), component (d, 2)),
+                    multiply (component (s, 3), component (d, 3))
+                );
+            }
+        }
+
+        // -----------------------------------------------------------------------------------------
+
+        inline int clamp_to_int (float value, int minimum, int maximum)
+        {
+            return value <= float(minimum) ? minimum : value >= float(maximum) ? maximum : int(value);
+        }
+
+        static const Point2f normal_texture_uvs[] =
+        {
+            { 0.f, 1.f },
+            { 0.f, 0.f },
+            { 1.f, 1.f },
+            { 1.f, 0.f },
+        };
+
+        static const Point2f h_flip_texture_uvs[] =
+        {
+            { 1.f, 1.f },
+            { 1.f, 0.f },
+            { 0.f, 1.f },
+            { 0.f, 0.f },
+        };
+
+        static const Point2f v_flip_texture_uvs[] =
+        {
+            { 0.f, 0.f },
+            { 0.f, 1.f },
+            { 1.f, 0.f },
+            { 1.f, 1.f },
+        };
+
+        static const Point2f d_flip_texture_uvs[] =
+        {
+            { 1.f, 0.f },
+            { 1.f, 1.f },
+            { 0.f, 0.f },
+            { 0.f, 1.f },
+        };
+
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Canvas * Canvas_Raster::create (Id id, Graphics_Context::Accessor & context, const Options & options)
+    {
+        Context * software_context = dynamic_cast< Context * >(context.operator -> ());
+
+        if (software_context)
+        {
+            std::shared_ptr< Canvas > canvas(new Canvas_Raster(*software_context, options.size));
+
+            context->add (id, canvas);
+
+            return canvas.get ();
+        }
+
+        return nullptr;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Canvas_Raster::Canvas_Raster(Context & context, const Size2u & size)
+    :
+        context (context),
+        size    { float(size.width), float(size.height) },
+        sampling(BILINEAR)
+    {
+        reset_state ();
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Canvas_Raster::reset_state ()
+    {
+        clear_color = pack (0, 0, 0, 255);
+        blending    = TRANSPARENCY;
+
+        set_size      ({ unsigned(size.width), unsigned(size.height) });
+        set_transform (Transformation2f());
+        set_color     (1.f, 1.f, 1.f);
+        set_opacity   (1.f);
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Canvas_Raster::set_size (const Size2u & new_size)
+    {
+        size.width  = float(new_size.width );
+        size.height = float(new_size.height);
+        projection  = translate_then_scale_2d (Vector2f{ -size.width * .5f, -size.height * .5f }, 2.f / size.width, 2.f / size.height);
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Canvas_Raster::set_clear_color (float r, float g, float b)
+    {
+        clear_color = pack (unsigned(r * 255.f + .5f), unsigned(g * 255.f + .5f), unsigned(b * 255.f + .5f), 255);
+    }
+
+    void Canvas_Raster::set_color (float r, float g, float b)
+    {
+        color = pack (unsigned(r * 255.f + .5f), unsigned(g * 255.f + .5f), unsigned(b * 255.f + .5f), 255);
+    }
+
+    void Canvas_Raster::set_opacity (float new_opacity)
+    {
+        opacity = unsigned(std::min (std::max (new_opacity, 0.f), 1.f) * 256.f + .5f);
+    }
+
+    void Canvas_Raster::set_blending (Blending new_blending)
+    {
+        blending = new_blending;
+    }
+
+    void Canvas_Raster::set_transform (const Transformation2f & new_transform)
+    {
+        transform = new_transform;
+    }
+
+    void Canvas_Raster::apply_transform (const Transformation2f & t)
+    {
+        transform = t * transform;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Canvas_Raster::clear ()
+    {
+        Color_Buffer< Rgba8888 > & color_buffer = context.get_color_buffer ();
+
+        reset_statistics ();
+
+        fill_span (&color_buffer[0], clear_color, color_buffer.size ());
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Canvas_Raster::draw_point (const Point2f & position)
+    {
+        if (!cull (projection * transform, &position, 1))
+        {
+            Vertex vertex = to_raster (get_raster_transform (), position);
+
+            plot (int(std::floor (vertex.x)), int(std::floor (vertex.y)));
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Canvas_Raster::draw_segment (const Point2f & a, const Point2f & b)
+    {
+        const Point2f points[] = { a, b };
+
+        if (!cull (projection * transform, points, 2))
+        {
+            Transformation2f raster_transform = get_raster_transform ();
+
+            trace_segment (to_raster (raster_transform, a), to_raster (raster_transform, b));
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Canvas_Raster::draw_triangle (const Point2f & a, const Point2f & b, const Point2f & c)
+    {
+        const Point2f points[] = { a, b, c };
+
+        if (!cull (projection * transform, points, 3))
+        {
+            Transformation2f raster_transform = get_raster_transform ();
+
+            Vertex vertices[] =
+            {
+                to_raster (raster_transform, a),
+                to_raster (raster_transform, b),
+                to_raster (raster_transform, c),
+            };
+
+            trace_segment (vertices[0], vertices[1]);
+            trace_segment (vertices[1], vertices[2]);
+            trace_segment (vertices[2], vertices[0]);
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Canvas_Raster::fill_triangle (const Point2f & a, const Point2f & b, const Point2f & c)
+    {
+        const Point2f points[] = { a, b, c };
+
+        if (cull (projection * transform, points, 3))
+        {
+            return;
+        }
+
+        Transformation2f raster_transform = get_raster_transform ();
+
+        const Vertex vertices[] =
+        {
+            to_raster (raster_transform, a),
+            to_raster (raster_transform, b),
+            to_raster (raster_transform, c),
+        };
+
+        fill_polygon (vertices, 3, nullptr);
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Canvas_Raster::draw_rectangle (const Point2f & bottom_left, const Size2f & size)
+    {
+        if (!cull (projection * transform, bottom_left, size))
+        {
+            Transformation2f raster_transform = get_raster_transform ();
+
+            Vertex vertices[] =
+            {
+                to_raster (raster_transform, bottom_left),
+                to_raster (raster_transform, { bottom_left[0] + size.width, bottom_left[1]               }),
+                to_raster (raster_transform, { bottom_left[0] + size.width, bottom_left[1] + size.height }),
+                to_raster (raster_transform, { bottom_left[0],              bottom_left[1] + size.height }),
+            };
+
+            trace_segment (vertices[0], vertices[1]);
+            trace_segment (vertices[1], vertices[2]);
+            trace_segment (vertices[2], vertices[3]);
+            trace_segment (vertices[3], vertices[0]);
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Canvas_Raster::fill_rectangle (const Point2f & bottom_left, const Size2f & size)
+    {
+        if (cull (projection * transform, bottom_left, size))
+        {
+            return;
+        }
+
+        Transformation2f raster_transform = get_raster_transform ();
+
+        const Vertex vertices[] =
+        {
+            to_raster (raster_transform, bottom_left),
+            to_raster (raster_transform, { bottom_left[0] + size.width, bottom_left[1]               }),
+            to_raster (raster_transform, { bottom_left[0] + size.width, bottom_left[1] + size.height }),
+            to_raster (raster_transform, { bottom_left[0],              bottom_left[1] + size.height }),
+        };
+
+        fill_polygon (vertices, 4, nullptr);
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Canvas_Raster::fill_rectangle (const Point2f & where, const Size2f & size, const basics::Texture_2D * texture, int handling)
+    {
+        const Texture_2D * software_texture = dynamic_cast< const Texture_2D * >(texture);
+
+        if (software_texture && software_texture->is_usable ())
+        {
+            const Point2f * texture_uvs;
+
+            switch (handling & 0xF0)
+            {
+                case FLIP_HORIZONTAL:  texture_uvs = h_flip_texture_uvs; break;
+                case FLIP_VERTICAL:    texture_uvs = v_flip_texture_uvs; break;
+                case FLIP_HORIZONTAL | FLIP_VERTICAL:
+                                       texture_uvs = d_flip_texture_uvs; break;
+                default:               texture_uvs = normal_texture_uvs; break;
+            }
+
+            const Point2f uvs[] = { texture_uvs[0], texture_uvs[1], texture_uvs[2], texture_uvs[3] };
+
+            fill_textured (where, size, software_texture, uvs, handling);
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Canvas_Raster::fill_rectangle (const Point2f & where, const Size2f & size, const Atlas::Slice * slice, int handling)
+    {
+        if (!slice || !slice->atlas)
+        {
+            return;
+        }
+
+        const Texture_2D * software_texture = dynamic_cast< const Texture_2D * >(slice->atlas->get_texture ().get ());
+
+        if (software_texture && software_texture->is_usable ())
+        {
+            float horizontal_ratio  = 1.f / software_texture->get_width  ();
+            float   vertical_ratio  = 1.f / software_texture->get_height ();
+            float normalized_left   = slice->left   * horizontal_ratio;
+            float normalized_right  = slice->right  * horizontal_ratio;
+            float normalized_top    = slice->top    *   vertical_ratio;
+            float normalized_bottom = slice->bottom *   vertical_ratio;
+
+            Point2f texture_uvs[] =
+            {
+                { normalized_left,  normalized_top    },
+                { normalized_left,  normalized_bottom },
+                { normalized_right, normalized_top    },
+                { normalized_right, normalized_bottom },
+            };
+
+            if (handling & FLIP_HORIZONTAL)
+            {
+                std::swap (texture_uvs[0][0], texture_uvs[2][0]);
+                std::swap (texture_uvs[1][0], texture_uvs[3][0]);
+            }
+
+            if (handling & FLIP_VERTICAL)
+            {
+                std::swap (texture_uvs[0][1], texture_uvs[1][1]);
+                std::swap (texture_uvs[2][1], texture_uvs[3][1]);
+            }
+
+            fill_textured (where, size, software_texture, texture_uvs, handling);
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Transformation2f Canvas_Raster::get_raster_transform () const
+    {
+        // Se compone la transformación del canvas con la proyección (que lleva a coordenadas
+        // normalizadas) y con la del viewport (que lleva a píxeles con el eje Y hacia abajo, que
+        // es el orden en el que están las filas dentro del color buffer):
+
+        const Point2u & viewport_position = context.get_viewport_bottom_left ();
+        const Size2u  & viewport_size     = context.get_viewport_size ();
+        float           surface_height    = float(context.get_color_buffer ().get_height ());
+
+        Transformation2f viewport;
+
+        viewport.matrix[0][0] =  float(viewport_size.width ) * .5f;
+        viewport.matrix[0][2] =  float(viewport_position[0]) + float(viewport_size.width ) * .5f;
+        viewport.matrix[1][1] = -float(viewport_size.height) * .5f;
+        viewport.matrix[1][2] =  surface_height - float(viewport_position[1]) - float(viewport_size.height) * .5f;
+
+        return viewport * projection * transform;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Canvas_Raster::Vertex Canvas_Raster::to_raster (const Transformation2f & raster_transform, const Point2f & point, float u, float v) const
+    {
+        const Transformation2f::Matrix & m = raster_transform.matrix;
+
+        return
+        {
+            m[0][0] * point[0] + m[0][1] * point[1] + m[0][2],
+            m[1][0] * point[0] + m[1][1] * point[1] + m[1][2],
+            u,
+            v
+        };
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Canvas_Raster::fill_textured
+    (
+        const Point2f & where,
+        const Size2f  & size,
+        const Texture_2D * texture,
+        const Point2f (& texture_uvs)[4],
+        int handling
+    )
+    {
+        Point2f bottom_left = where;
+
+        switch (handling & 0x03)
+        {
+            case LEFT:   bottom_left[0] = where[0];                  break;
+            case CENTER: bottom_left[0] = where[0] - size[0] * 0.5f; break;
+            case RIGHT:  bottom_left[0] = where[0] - size[0];        break;
+        }
+
+        switch (handling & 0x0C)
+        {
+            case TOP:    bottom_left[1] = where[1] - size[1];        break;
+            case CENTER: bottom_left[1] = where[1] - size[1] * 0.5f; break;
+            case BOTTOM: bottom_left[1] = where[1];                  break;
+        }
+
+        if (cull (projection * transform, bottom_left, size))
+        {
+            return;
+        }
+
+        float left   = bottom_left[0];
+        float bottom = bottom_left[1];
+        float right  = left   + size.width;
+        float top    = bottom + size.height;
+
+        // Los UVs siguen el mismo orden que el triangle strip de Canvas_ES2 (bl, tl, br, tr), pero
+        // los vértices se pasan en orden de recorrido del contorno:
+
+        Transformation2f raster_transform = get_raster_transform ();
+
+        const Vertex vertices[] =
+        {
+            to_raster (raster_transform, { left,  bottom }, texture_uvs[0][0], texture_uvs[0][1]),
+            to_raster (raster_transform, { right, bottom }, texture_uvs[2][0], texture_uvs[2][1]),
+            to_raster (raster_transform, { right, top    }, texture_uvs[3][0], texture_uvs[3][1]),
+            to_raster (raster_transform, { left,  top    }, texture_uvs[1][0], texture_uvs[1][1]),
+        };
+
+        fill_polygon (vertices, 4, texture);
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Canvas_Raster::trace_segment (const Vertex & start, const Vertex & end)
+    {
+        float  dx    = end.x - start.x;
+        float  dy    = end.y - start.y;
+        float  steps = std::ceil (std::max (std::abs (dx), std::abs (dy)));
+
+        // Se evita recorrer segmentos absurdamente largos que en su mayoría quedarían fuera:
+
+        steps = std::min (steps, float(4 * (context.get_surface_width () + context.get_surface_height ())));
+
+        if (steps < 1.f)
+        {
+            plot (int(std::floor (start.x)), int(std::floor (start.y)));
+        }
+        else for (int step = 0, count = int(steps); step <= count; ++step)
+        {
+            float t = float(step) / steps;
+
+            plot (int(std::floor (start.x + dx * t)), int(std::floor (start.y + dy * t)));
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Canvas_Raster::fill_polygon (const Vertex * vertices, unsigned count, const Texture_2D * texture)
+    {
+        Color_Buffer< Rgba8888 > & color_buffer = context.get_color_buffer ();
+
+        const int       surface_width     = int(color_buffer.get_width  ());
+        const int       surface_height    = int(color_buffer.get_height ());
+        const Point2u & viewport_position = context.get_viewport_bottom_left ();
+        const Size2u  & viewport_size     = context.get_viewport_size ();
+
+        // Se recorta contra el viewport (expresado con el eje Y hacia abajo):
+
+        const int clip_left   = std::max (0, int(viewport_position[0]));
+        const int clip_right  = std::min (surface_width,  int(viewport_position[0] + viewport_size.width));
+        const int clip_top    = std::max (0, surface_height - int(viewport_position[1] + viewport_size.height));
+        const int clip_bottom = std::min (surface_height, surface_height - int(viewport_position[1]));
+
+        float top    = vertices[0].y;
+        float bottom = vertices[0].y;
+
+        for (unsigned index = 1; index < count; ++index)
+        {
+            top    = std::min (top,    vertices[index].y);
+            bottom = std::max (bottom, vertices[index].y);
+        }
+
+        // Se usan los centros de los píxeles como puntos de muestreo:
+
+        int row_begin = clamp_to_int (std::ceil (top    - .5f), clip_top, clip_bottom);
+        int row_end   = clamp_to_int (std::ceil (bottom - .5f), clip_top, clip_bottom);
+
+        if (row_begin >= row_end)
+        {
+            return;
+        }
+
+        // Como las transformaciones son afines, las coordenadas de textura son una función lineal
+        // de la posición en pantalla: u = du_dx * x + du_dy * y + u0 (y lo mismo para v):
+
+        float du_dx = 0.f, du_dy = 0.f, u0 = 0.f;
+        float dv_dx = 0.f, dv_dy = 0.f, v0 = 0.f;
+
+        if (texture)
+        {
+            const Vertex & a = vertices[0];
+            const Vertex & b = vertices[1];
+            const Vertex & c = vertices[2];
+
+            float determinant = (b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y);
+
+            if (determinant == 0.f)
+            {
+                return;
+            }
+
+            float inverse = 1.f / determinant;
+
+            du_dx = ((b.u - a.u) * (c.y - a.y) - (c.u - a.u) * (b.y - a.y)) * inverse;
+            du_dy = ((c.u - a.u) * (b.x - a.x) - (b.u - a.u) * (c.x - a.x)) * inverse;
+            dv_dx = ((b.v - a.v) * (c.y - a.y) - (c.v - a.v) * (b.y - a.y)) * inverse;
+            dv_dy = ((c.v - a.v) * (b.x - a.x) - (b.v - a.v) * (c.x - a.x)) * inverse;
+            u0    = a.u - du_dx * a.x - du_dy * a.y;
+            v0    = a.v - dv_dx * a.x - dv_dy * a.y;
+        }
+
+        unsigned solid_alpha = std::min (255u, (255u * opacity + 128u) >> 8);
+        Rgba8888 solid_color = (color & 0x00FFFFFF) | Rgba8888(solid_alpha) << 24;
+        bool     opaque      = blending == NONE || (blending == TRANSPARENCY && solid_alpha == 255);
+
+        for (int row = row_begin; row < row_end; ++row)
+        {
+            float center_y = float(row) + .5f;
+            float left     =  std::numeric_limits< float >::infinity ();
+            float right    = -std::numeric_limits< float >::infinity ();
+
+            for (unsigned index = 0; index < count; ++index)
+            {
+                const Vertex & a = vertices[index];
+                const Vertex & b = vertices[(index + 1) % count];
+
+                if ((a.y <= center_y && center_y < b.y) || (b.y <= center_y && center_y < a.y))
+                {
+                    float x = a.x + (center_y - a.y) * (b.x - a.x) / (b.y - a.y);
+
+                    left  = std::min (left,  x);
+                    right = std::max (right, x);
+                }
+            }
+
+            if (!(left < right))
+            {
+                continue;
+            }
+
+            int column_begin = clamp_to_int (std::ceil (left  - .5f), clip_left, clip_right);
+            int column_end   = clamp_to_int (std::ceil (right - .5f), clip_left, clip_right);
+
+            if (column_begin >= column_end)
+            {
+                continue;
+            }
+
+            Rgba8888 * target = &color_buffer[unsigned(row * surface_width + column_begin)];
+            unsigned   length = unsigned(column_end - column_begin);
+
+            if (texture)
+            {
+                float center_x = float(column_begin) + .5f;
+
+                sample_span
+                (
+                    *texture,
+                    du_dx * center_x + du_dy * center_y + u0,
+                    dv_dx * center_x + dv_dy * center_y + v0,
+                    du_dx,
+                    dv_dx,
+                    length
+                );
+
+                write_span (target, span.data (), length);
+            }
+            else
+            if (opaque)
+            {
+                fill_span (target, solid_color, length);
+            }
+            else
+            {
+                span.assign (length, solid_color);
+
+                write_span (target, span.data (), length);
+            }
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Canvas_Raster::plot (int x, int y)
+    {
+        Color_Buffer< Rgba8888 > & color_buffer = context.get_color_buffer ();
+
+        if (x >= 0 && y >= 0 && unsigned(x) < color_buffer.get_width () && unsigned(y) < color_buffer.get_height ())
+        {
+            Rgba8888 source = (color & 0x00FFFFFF) | Rgba8888(std::min (255u, (255u * opacity + 128u) >> 8)) << 24;
+
+            write_span (&color_buffer[unsigned(y) * color_buffer.get_width () + unsigned(x)], &source, 1);
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Canvas_Raster::write_span (Rgba8888 * target, const Rgba8888 * source, unsigned count)
+    {
+        switch (blending)
+        {
+            case NONE:         std::memcpy   (target, source, count * sizeof(Rgba8888)); break;
+            case TRANSPARENCY: blend_span    (target, source, count); break;
+            case MULTIPLY:     multiply_span (target, source, count); break;
+            case ADD:          add_span      (target, source, count); break;
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    void Canvas_Raster::sample_span (const Texture_2D & texture, float u, float v, float du, float dv, unsigned count)
+    {
+        const Color_Buffer< Rgba8888 > & texels = texture.get_color_buffer ();
+
+        const int   width   = int(texels.get_width  ());
+        const int   height  = int(texels.get_height ());
+        const float scale_x = float(width );
+        const float scale_y = float(height);
+
+        span.resize (count);
+
+        Rgba8888 * output = span.data ();
+
+        if (sampling == NEAREST)
+        {
+            for (unsigned index = 0; index < count; ++index, u += du, v += dv)
+            {
+                int x = clamp_to_int (std::floor (u * scale_x), 0, width  - 1);
+                int y = clamp_to_int (std::floor (v * scale_y), 0, height - 1);
+
+                output[index] = texels[unsigned(y * width + x)];
+            }
+        }
+        else
+        {
+            for (unsigned index = 0; index < count; ++index, u += du, v += dv)
+            {
+                // Se muestrea como GL_LINEAR con GL_CLAMP_TO_EDGE (centros de texel en 0.5):
+
+                float    fx = u * scale_x - .5f;
+                float    fy = v * scale_y - .5f;
+                float    x0 = std::floor (fx);
+                float    y0 = std::floor (fy);
+                unsigned wx = unsigned((fx - x0) * 256.f);
+                unsigned wy = unsigned((fy - y0) * 256.f);
+
+                int left   = clamp_to_int (x0,       0, width  - 1);
+                int right  = clamp_to_int (x0 + 1.f, 0, width  - 1);
+                int top    = clamp_to_int (y0,       0, height - 1);
+                int bottom = clamp_to_int (y0 + 1.f, 0, height - 1);
+
+                Rgba8888 a = texels[unsigned(top    * width + left )];
+                Rgba8888 b = texels[unsigned(top    * width + right)];
+                Rgba8888 c = texels[unsigned(bottom * width + left )];
+                Rgba8888 d = texels[unsigned(bottom * width + right)];
+
+                unsigned result[4];
+
+                for (unsigned channel = 0; channel < 4; ++channel)
+                {
+                    unsigned upper = component (a, channel) * (256 - wx) + component (b, channel) * wx;
+                    unsigned lower = component (c, channel) * (256 - wx) + component (d, channel) * wx;
+
+                    result[channel] = (upper * (256 - wy) + lower * wy + 32768) >> 16;
+                }
+
+                output[index] = pack (result[0], result[1], result[2], result[3]);
+            }
+        }
+
+        // La opacidad del canvas modula el alfa de la textura (igual que en el fragment shader):
+
+        if (opacity < 256)
+        {
+            for (unsigned index = 0; index < count; ++index)
+            {
+                Rgba8888 texel = output[index];
+
+                output[index] = (texel & 0x00FFFFFF) | Rgba8888(((texel >> 24) * opacity + 128) >> 8) << 24;
+            }
+        }
+    }
+
+}}
@@ -0,0 +1,42 @@
+/*
+ * SOFTWARE CONTEXT
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803101310
+ */
+
+#include <basics/software/Context>
+
+namespace basics { namespace software
+{
+
+    std::shared_ptr< Context > Context::create (const Size2u & size, Graphics_Resource_Cache * cache)
+    {
+        if (size.width > 0 && size.height > 0)
+        {
+            return std::shared_ptr< Context >(new Context(std::make_shared< Offscreen_Window >(size), cache));
+        }
+
+        return nullptr;
+    }
+
+    // ---------------------------------------------------------------------------------------------
+
+    Context::Context(const std::shared_ptr< Offscreen_Window > & window, Graphics_Resource_Cache * cache)
+    :
+        Graphics_Context(*window, cache),
+        offscreen_window(window),
+        mutex           (std::make_shared< std::mutex > ()),
+        color_buffer    (window->get_width (), window->get_height ()),
+        frame_count     (0)
+    {
+        reset_viewport ();
+        initialize     ();
+    }
+
+}}
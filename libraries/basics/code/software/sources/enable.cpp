@@ -0,0 +1,30 @@
+/*
+ * SOFTWARE ENABLE
+ * Copyright © 2018+ Ángel Rodríguez Ballesteros
+ *
+ * Distributed under the Boost Software License, version  1.0
+ * See documents/LICENSE.TXT or www.boost.org/LICENSE_1_0.txt
+ *
+ * angel.rodriguez@esne.edu
+ *
+ * C1803101320
+ */
+
+#include <basics/enable>
+#include <basics/software/Canvas_Raster>
+#include <basics/software/Software_Rasterizer>
+#include <basics/software/Texture_2D>
+
+namespace basics
+{
+
+    template< >
+    bool enable< Software_Rasterizer > ()
+    {
+        software::Canvas_Raster::enable ();
+        software::Texture_2D   ::enable ();
+
+        return true;
+    }
+
+}